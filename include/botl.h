@@ -63,6 +63,13 @@ enum relationships { LT_VALUE = -1, EQ_VALUE, GT_VALUE, TXT_VALUE };
 
 #define REASSESS_ONLY TRUE
 
+/* status_dirty() bits: fields that are too costly to recompute on
+   every bot() and are only re-evaluated after being flagged */
+#define BL_DIRTY_CAP   0x0001L /* carrying capacity (inventory weight) */
+#define BL_DIRTY_LEVEL 0x0002L /* dungeon level description */
+#define BL_DIRTY_SCORE 0x0004L /* botl score (gold, containers, depth) */
+#define BL_DIRTY_ALL   0x0007L
+
 /* #ifdef STATUS_HILITES */
 /* hilite status field behavior - coloridx values */
 #define BL_HILITE_NONE -1    /* no hilite of this field */
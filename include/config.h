@@ -547,6 +547,19 @@ typedef unsigned char uchar;
 
 #define BARD		/* Bards and songs - Andre Bertelli */
 
+/* PERFSTATS times the main phases of each turn (monster movement, vision,
+ * light sources, timers, regions, screen flushing, status line, songs).
+ * The #perfstats wizard command shows the totals, and at the end of the
+ * game they are appended as one line of JSON to the file named by
+ * ${NH_PERFSTATS}, or PERFSTATS_FILE if that isn't set.  Without it the
+ * timing hooks compile to nothing. */
+/* #define PERFSTATS */
+#ifdef PERFSTATS
+#ifndef PERFSTATS_FILE
+#define PERFSTATS_FILE "perfstats.json"
+#endif
+#endif
+
 /* End of Section 4 */
 
 #ifdef TTY_TILES_ESCCODES
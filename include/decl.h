@@ -257,6 +257,9 @@ E NEARDATA struct u_realtime urealtime;
 #endif
 
 E NEARDATA struct monst zeromonst; /* for init of new or temp monsters */
+
+/* allocation pools for objects, monsters and their extra blocks */
+E NEARDATA struct nhpool obj_pool, oextra_pool, monst_pool, mextra_pool;
 E NEARDATA struct monst youmonst; /* monster details when hero is poly'd */
 E NEARDATA struct monst *mydogs, *migrating_mons;
 
@@ -388,11 +391,22 @@ E char *fqn_prefix_names[PREFIX_COUNT];
 
 E NEARDATA struct savefile_info sfcap, sfrestinfo, sfsaveinfo;
 
+/* point set for SPOVAR_SEL; (x,y) is present when bit (x % SEL_WORDBITS)
+   of row[y][x / SEL_WORDBITS] is set.  Only the low 32 bits of each word
+   are used, whatever the width of long. */
+#define SEL_WORDBITS 32
+#define SEL_ROWWORDS ((COLNO + SEL_WORDBITS - 1) / SEL_WORDBITS)
+
+struct selectionvar {
+    unsigned long row[ROWNO][SEL_ROWWORDS];
+};
+
 struct opvar {
     xchar spovartyp; /* one of SPOVAR_foo */
     union {
         char *str;
         long l;
+        struct selectionvar *sel; /* SPOVAR_SEL */
     } vardata;
 };
 
@@ -423,7 +437,7 @@ E struct plinemsg_type *plinemsg_types;
 E const char *ARGV0;
 #endif
 
-enum earlyarg {ARG_DEBUG, ARG_VERSION};
+enum earlyarg {ARG_DEBUG, ARG_VERSION, ARG_SEED};
 
 struct early_opt {
     enum earlyarg e;
@@ -145,10 +145,12 @@
  * random_trap()
  *
  * Respectively return a random monster, object, or trap number.
+ * These are for display purposes and draw from their own stream so that
+ * hallucination doesn't influence the rest of the game's random numbers.
  */
-#define random_monster() rn2(NUMMONS)
-#define random_object() rn1(NUM_OBJECTS - 1, 1)
-#define random_trap() rn1(TRAPNUM - 1, 1)
+#define random_monster() rn2_on(RNG_DISP, NUMMONS)
+#define random_object() (rn2_on(RNG_DISP, NUM_OBJECTS - 1) + 1)
+#define random_trap() (rn2_on(RNG_DISP, TRAPNUM - 1) + 1)
 
 /*
  * what_obj()
@@ -27,6 +27,12 @@ E void NDECL(newgame);
 E void FDECL(welcome, (BOOLEAN_P));
 E time_t NDECL(get_realtime);
 E int FDECL(argcheck, (int, char **, enum earlyarg));
+#ifdef PERFSTATS
+E void FDECL(perf_start, (int));
+E void FDECL(perf_stop, (int));
+E void FDECL(perfstats_report, (void FDECL((*), (const char *))));
+E void NDECL(perfstats_dump);
+#endif
 
 /* ### apply.c ### */
 
@@ -161,6 +167,7 @@ E void FDECL(status_initialize, (BOOLEAN_P));
 E void NDECL(status_finish);
 E void FDECL(status_notify_windowport, (BOOLEAN_P));
 E void NDECL(status_eval_next_unhilite);
+E void FDECL(status_dirty, (long));
 #ifdef STATUS_HILITES
 E boolean FDECL(parse_status_hl1, (char *op, BOOLEAN_P));
 E void NDECL(clear_status_hilites);
@@ -225,6 +232,8 @@ E void FDECL(hangup, (int));
 E void NDECL(end_of_input);
 #endif
 E char NDECL(readchar);
+E boolean NDECL(typeahead_pending);
+E void FDECL(uncoalesce_keys, (int));
 E void NDECL(sanity_check);
 E char* FDECL(key2txt, (UCHAR_P, char *));
 E char FDECL(yn_function, (const char *, const char *, CHAR_P));
@@ -778,6 +787,8 @@ E void FDECL(unlock_file, (const char *));
 E boolean FDECL(can_read_file, (const char *));
 #endif
 E void FDECL(config_error_init, (BOOLEAN_P, const char *, BOOLEAN_P));
+E int NDECL(config_error_lineno);
+E void FDECL(config_error_setline, (int));
 E void FDECL(config_error_add, (const char *, ...)) PRINTF_F(1, 2);
 E int NDECL(config_error_done);
 E boolean FDECL(read_config_file, (const char *, int));
@@ -859,6 +870,7 @@ E void FDECL(unmul, (const char *));
 E void FDECL(losehp, (int, const char *, BOOLEAN_P));
 E int NDECL(weight_cap);
 E int NDECL(inv_weight);
+E int FDECL(inv_objweight, (struct obj *));
 E int NDECL(near_capacity);
 E int FDECL(calc_capacity, (int));
 E int NDECL(max_capacity);
@@ -912,6 +924,16 @@ E char *FDECL(strstri, (const char *, const char *));
 #endif
 E boolean
 FDECL(fuzzymatch, (const char *, const char *, const char *, BOOLEAN_P));
+E unsigned long FDECL(namehash, (const char *, int));
+E int FDECL(nametab_lookup, (const struct nametab *, const char *,
+                             const short **));
+E void FDECL(idtab_add, (struct id_table *, unsigned, ANY_P *));
+E anything *FDECL(idtab_find, (struct id_table *, unsigned));
+E void FDECL(idtab_del, (struct id_table *, unsigned, genericptr_t));
+E void FDECL(idtab_clear, (struct id_table *));
+E genericptr_t FDECL(pool_alloc, (struct nhpool *, int));
+E void FDECL(pool_free, (struct nhpool *, genericptr_t));
+E void FDECL(pool_trim, (struct nhpool *));
 E void NDECL(setrandom);
 E time_t NDECL(getnow);
 E int NDECL(getyear);
@@ -951,6 +973,12 @@ E void FDECL(useup, (struct obj *));
 E void FDECL(consume_obj_charge, (struct obj *, BOOLEAN_P));
 E void FDECL(freeinv_core, (struct obj *));
 E void FDECL(freeinv, (struct obj *));
+E void FDECL(begin_invbatch, (BOOLEAN_P));
+E void NDECL(end_invbatch);
+E boolean FDECL(invbatch_weight, (int *));
+E void FDECL(invbatch_setweight, (int));
+E void FDECL(invbatch_newsym, (int, int));
+E void FDECL(invbatch_placed, (struct obj *));
 E void FDECL(delallobj, (int, int));
 E void FDECL(delobj, (struct obj *));
 E struct obj *FDECL(sobj_at, (int, int, int));
@@ -958,6 +986,10 @@ E struct obj *FDECL(nxtobj, (struct obj *, int, BOOLEAN_P));
 E struct obj *FDECL(carrying, (int));
 E boolean NDECL(have_lizard);
 E struct obj *NDECL(u_have_novel);
+E void NDECL(invent_changed);
+E struct obj *FDECL(invlet_to_obj, (CHAR_P));
+E int FDECL(invent_otyp_count, (int));
+E void NDECL(invent_index_sanity);
 E struct obj *FDECL(o_on, (unsigned int, struct obj *));
 E boolean FDECL(obj_here, (struct obj *, int, int));
 E boolean NDECL(wearing_armor);
@@ -1125,6 +1157,10 @@ E void FDECL(readmail, (struct obj *));
 /* ### makemon.c ### */
 
 E void FDECL(dealloc_monst, (struct monst *));
+E void FDECL(mon_id_register, (struct monst *));
+E void FDECL(mon_id_unregister, (struct monst *));
+E struct monst *FDECL(mon_by_id, (unsigned));
+E void NDECL(free_mon_ids);
 E boolean FDECL(is_home_elemental, (struct permonst *));
 E struct monst *FDECL(clone_mon, (struct monst *, XCHAR_P, XCHAR_P));
 E int FDECL(monhp_per_lvl, (struct monst *));
@@ -1157,6 +1193,7 @@ E boolean FDECL(usmellmon, (struct permonst *));
 /* ### mapglyph.c ### */
 
 E int FDECL(mapglyph, (int, int *, int *, unsigned *, int, int));
+E void NDECL(reset_glyphmap);
 E char *FDECL(encglyph, (int));
 E const char *FDECL(decode_mixed, (char *,const char *));
 E void FDECL(genl_putmixed, (winid, int, const char *));
@@ -1267,6 +1304,9 @@ E const char *FDECL(waterbody_name, (XCHAR_P, XCHAR_P));
 
 /* ### mkobj.c ### */
 
+E void FDECL(obj_id_register, (struct obj *));
+E struct obj *FDECL(obj_by_id, (unsigned));
+E void NDECL(free_obj_ids);
 E struct oextra *NDECL(newoextra);
 E void FDECL(copy_oextra, (struct obj *, struct obj *));
 E void FDECL(dealloc_oextra, (struct obj *));
@@ -1610,6 +1650,8 @@ E struct nhregex *NDECL(regex_init);
 E boolean FDECL(regex_compile, (const char *, struct nhregex *));
 E const char *FDECL(regex_error_desc, (struct nhregex *));
 E boolean FDECL(regex_match, (const char *, struct nhregex *));
+E boolean FDECL(regex_compile_set, (const char *const *, int,
+                                    struct nhregex *));
 E void FDECL(regex_free, (struct nhregex *));
 
 /* ### nttty.c ### */
@@ -1654,6 +1696,7 @@ E char *FDECL(fruitname, (BOOLEAN_P));
 E struct fruit *FDECL(fruit_from_indx, (int));
 E struct fruit *FDECL(fruit_from_name, (const char *, BOOLEAN_P, int *));
 E void FDECL(reorder_fruit, (BOOLEAN_P));
+E void FDECL(objname_observe, (struct obj *));
 E char *FDECL(xname, (struct obj *));
 E char *FDECL(mshot_xname, (struct obj *));
 E boolean FDECL(the_unique_obj, (struct obj *));
@@ -1699,6 +1742,9 @@ E const char *FDECL(helm_simple_name, (struct obj *));
 E const char *FDECL(mimic_obj_name, (struct monst *));
 E char *FDECL(safe_qbuf, (char *, const char *, const char *, struct obj *,
                           char *(*)(OBJ_P), char *(*)(OBJ_P), const char *));
+E void NDECL(objnam_changed);
+E void NDECL(free_objnam_cache);
+E void NDECL(objnam_bench);
 
 /* ### options.c ### */
 
@@ -1728,6 +1774,8 @@ E void FDECL(set_wc2_option_mod_status, (unsigned long, int));
 E void FDECL(set_option_mod_status, (const char *, int));
 E int FDECL(add_autopickup_exception, (const char *));
 E void NDECL(free_autopickup_exceptions);
+E boolean FDECL(match_autopickup_exception, (const char *, BOOLEAN_P));
+E char *FDECL(regex_set_pattern, (const char *const *, int));
 E int FDECL(load_symset, (const char *, int));
 E void NDECL(free_symsets);
 E boolean FDECL(parsesymbols, (char *));
@@ -1746,6 +1794,8 @@ E boolean FDECL(msgtype_parse_add, (char *));
 E int FDECL(msgtype_type, (const char *, BOOLEAN_P));
 E void FDECL(hide_unhide_msgtypes, (BOOLEAN_P, int));
 E void NDECL(msgtype_free);
+E void NDECL(defer_rule_regexes);
+E boolean NDECL(check_rule_regexes);
 
 /* ### pager.c ### */
 
@@ -1848,9 +1898,13 @@ E boolean FDECL(autopick_testobj, (struct obj *, BOOLEAN_P));
 
 /* ### pline.c ### */
 
+E void FDECL(msghist_add, (const char *, int));
+E const char *FDECL(msghist_get, (int, int));
+E int FDECL(msghist_count, (int));
+E unsigned long FDECL(msghist_serial, (int));
+E void NDECL(msghist_clear);
 #ifdef DUMPLOG
 E void FDECL(dumplogmsg, (const char *));
-E void NDECL(dumplogfreemessages);
 #endif
 E void VDECL(pline, (const char *, ...)) PRINTF_F(1, 2);
 E void VDECL(custompline, (unsigned, const char *, ...)) PRINTF_F(2, 3);
@@ -2086,6 +2140,14 @@ E int FDECL(rnd, (int));
 E int FDECL(d, (int, int));
 E int FDECL(rne, (int));
 E int FDECL(rnz, (int));
+E int FDECL(rn2_on, (int, int));
+E int FDECL(rng_select, (int));
+E void FDECL(init_rng_streams, (unsigned long));
+E unsigned long FDECL(rng_seed, (int));
+E const char *FDECL(rng_name, (int));
+E boolean FDECL(parse_rng_seeds, (const char *));
+E void FDECL(save_rngstate, (int, int));
+E void FDECL(restore_rngstate, (int));
 
 /* ### role.c ### */
 
@@ -2168,6 +2230,7 @@ E void FDECL(store_savefileinfo, (int));
 /* ### shk.c ### */
 
 E void FDECL(setpaid, (struct monst *));
+E void FDECL(forget_bill_index, (struct eshk *));
 E long FDECL(money2mon, (struct monst *, long));
 E void FDECL(money2u, (struct monst *, long));
 E void FDECL(shkgone, (struct monst *));
@@ -2515,6 +2578,8 @@ E void FDECL(settty, (const char *));
 E void NDECL(setftty);
 E void NDECL(intron);
 E void NDECL(introff);
+E int NDECL(unix_tgetch);
+E int NDECL(unix_typeahead);
 E void VDECL(error, (const char *, ...)) PRINTF_F(1, 2);
 #endif /* UNIX || __BEOS__ */
 
@@ -2613,6 +2678,8 @@ E void NDECL(vision_reset);
 E void FDECL(vision_recalc, (int));
 E void FDECL(block_point, (int, int));
 E void FDECL(unblock_point, (int, int));
+E unsigned long NDECL(vision_clear_gen);
+E boolean FDECL(vision_clear_changed, (unsigned long, int, int, int, int));
 E boolean FDECL(clear_path, (int, int, int, int));
 E void FDECL(do_clear_area, (int, int, int,
                              void (*)(int, int, genericptr), genericptr_t));
@@ -2777,6 +2844,13 @@ E void NDECL(genl_status_finish);
 E void FDECL(genl_status_enablefield,
              (int, const char *, const char *, BOOLEAN_P));
 E void FDECL(genl_status_update, (int, genericptr_t, int, int, int, unsigned long *));
+E void FDECL(add_menu_items, (winid, int,
+                              void FDECL((*), (genericptr_t, int,
+                                               MENU_FILL_P *)),
+                              genericptr_t));
+E int FDECL(menu_items_count, (winid));
+E void FDECL(get_menu_item, (winid, int, MENU_FILL_P *));
+E void FDECL(clear_menu_items, (winid));
 
 E void FDECL(dump_open_log, (time_t));
 E void NDECL(dump_close_log);
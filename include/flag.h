@@ -263,6 +263,7 @@ struct instance_flags {
     boolean mon_polycontrol; /* debug: control monster polymorphs */
     boolean in_dumplog;    /* doing the dumplog right now? */
     boolean in_parse;      /* is a command being parsed? */
+    int typeahead;         /* keys the window port has already read ahead */
 
     /* stuff that is related to options and/or user or platform preferences
      */
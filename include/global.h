@@ -257,6 +257,7 @@ typedef uchar nhsym;
 extern long *FDECL(nhalloc, (unsigned int, const char *, int));
 extern void FDECL(nhfree, (genericptr_t, const char *, int));
 extern char *FDECL(nhdupstr, (const char *, const char *, int));
+extern void FDECL(heapmon_report, (int, void FDECL((*), (const char *))));
 #ifndef __FILE__
 #define __FILE__ ""
 #endif
@@ -190,6 +190,38 @@ enum hmon_atkmode_types {
     HMON_DRAGGED    /* attached iron ball, pulled into mon */
 };
 
+/* independent random number streams; see rnd.c */
+enum rng_streams {
+    RNG_CORE = 0, /* default, everything not otherwise classified */
+    RNG_LEVGEN,   /* level creation */
+    RNG_COMBAT,   /* attacks by or against the hero and between monsters */
+    RNG_AI,       /* monster movement decisions */
+    RNG_DISP,     /* display-only effects such as hallucination */
+    NUM_RNG_STREAMS
+};
+
+/* id number -> value index (hacklib.c); used for o_id and m_id lookup */
+struct id_entry {
+    unsigned id; /* 0: unused slot */
+    anything val;
+};
+struct id_table {
+    struct id_entry *ents;
+    int size, count; /* size is 0 or a power of 2 */
+};
+
+/* fixed-size allocation pool (hacklib.c); used for objects, monsters,
+   and their oextra and mextra blocks */
+struct pool_slab;
+struct nhpool {
+    unsigned size;              /* size of one item, as requested */
+    unsigned stride;            /* item plus header, once initialized */
+    int narenas;                /* allocated length of arenas[] */
+    struct pool_slab **arenas;  /* per-level lists of slabs with room */
+    struct pool_slab *spare;    /* one empty slab kept for reuse */
+    long nslabs, nitems;        /* slabs held, items handed out */
+};
+
 #define MATCH_WARN_OF_MON(mon)                                               \
     (Warn_of_mon && ((context.warntype.obj                                   \
                       && (context.warntype.obj & (mon)->data->mflags2))      \
@@ -206,6 +238,7 @@ enum hmon_atkmode_types {
 #include "engrave.h"
 #include "rect.h"
 #include "region.h"
+#include "nametab.h"
 
 /* Symbol offsets */
 #define SYM_OFF_P (0)
@@ -383,6 +416,30 @@ enum explosion_types {
 #define OVERRIDE_MSGTYPE 2
 #define SUPPRESS_HISTORY 4
 
+/* msghist_add() consumers */
+#define MSGH_DUMPLOG 1 /* every message, for the dumplog */
+#define MSGH_PREV    2 /* message line history, for ^P and save files */
+
+/* phases timed by the PERFSTATS profiler (allmain.c) */
+#ifdef PERFSTATS
+enum perf_phases {
+    PERF_MOVEMON = 0,
+    PERF_VISION,
+    PERF_LIGHTS,
+    PERF_TIMERS,
+    PERF_REGIONS,
+    PERF_FLUSH,
+    PERF_BOT,
+    PERF_SONG,
+    NUM_PERF_PHASES
+};
+#define PERF_START(phase) perf_start(phase)
+#define PERF_STOP(phase) perf_stop(phase)
+#else
+#define PERF_START(phase) /*empty*/
+#define PERF_STOP(phase) /*empty*/
+#endif
+
 /* Macros for messages referring to hands, eyes, feet, etc... */
 enum bodypart_types {
     ARM = 0,
@@ -151,7 +151,8 @@ struct monst {
     struct mextra *mextra; /* point to mextra struct */
 };
 
-#define newmonst() (struct monst *) alloc(sizeof (struct monst))
+#define newmonst() \
+    ((struct monst *) pool_alloc(&monst_pool, (int) ledger_no(&u.uz)))
 
 /* these are in mspeed */
 #define MSLOW 1 /* slowed monster */
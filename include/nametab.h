@@ -0,0 +1,46 @@
+/* NetHack 3.6	nametab.h	$NHDT-Date$  $NHDT-Branch$:$NHDT-Revision$ */
+/* Copyright (c) 2018 by NetHack DevTeam                          */
+/* NetHack may be freely redistributed.  See license for details. */
+
+#ifndef NAMETAB_H
+#define NAMETAB_H
+
+/*
+ * Name lookup tables generated by makedefs (-m, into monstr.c).
+ *
+ * Each table is a minimal-probe perfect hash: a key's bucket is
+ * namehash(key, 0) % ndisp and its slot is namehash(key, disp[bucket])
+ * % nents, so a lookup costs two hashes and one string compare.  A key
+ * may stand for several values (object descriptions are shared, for
+ * instance); those are vals[first] through vals[first + count - 1].
+ *
+ * Keys are normalized before hashing: monster names are lowercased,
+ * object names and descriptions are lowercased with spaces and hyphens
+ * removed (matching fuzzymatch()'s rules).
+ */
+struct nametab_ent {
+    const char *key; /* null for an unused slot */
+    short first, count;
+};
+
+struct nametab {
+    const struct nametab_ent *ents;
+    int nents;
+    const short *disp;
+    int ndisp;
+    const short *vals;
+};
+
+/* 32-bit FNV-1a; makedefs and namehash() in hacklib.c must agree */
+#define NAMEHASH_BASIS 0x811c9dc5UL
+#define NAMEHASH_SEED(seed) (((unsigned long) (seed) * 0x9e3779b1UL) \
+                             & 0xffffffffUL)
+#define NAMEHASH_STEP(h, c) \
+    ((((h) ^ (unsigned long) (unsigned char) (c)) * 0x01000193UL)   \
+     & 0xffffffffUL)
+
+extern const struct nametab mon_nametab;     /* value: monster index */
+extern const struct nametab objname_nametab; /* value: object index */
+extern const struct nametab objdesc_nametab; /* value: obj_descr index */
+
+#endif /* NAMETAB_H */
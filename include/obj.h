@@ -122,7 +122,8 @@ struct obj {
     struct oextra *oextra; /* pointer to oextra struct */
 };
 
-#define newobj() (struct obj *) alloc(sizeof(struct obj))
+#define newobj() \
+    ((struct obj *) pool_alloc(&obj_pool, (int) ledger_no(&u.uz)))
 
 /***
  **	oextra referencing and testing macros
@@ -305,6 +305,7 @@ extern int currentgraphics; /* from drawing.c */
 extern nhsym showsyms[];
 extern nhsym l_syms[];
 extern nhsym r_syms[];
+extern unsigned showsyms_gen; /* see mapglyph() */
 
 extern struct symsetentry symset[NUM_GRAPHICS]; /* from drawing.c */
 #define SYMHANDLING(ht) (symset[currentgraphics].handling == (ht))
@@ -582,6 +583,21 @@ struct levelflags {
                                   rather than ROOM */
 };
 
+/*
+ * Summary of the objects on one square, maintained by place_object()
+ * and remove_object() so that common questions about a pile ("is there
+ * a boulder here?", "how many things are here?") don't need to walk
+ * its nexthere chain.  Not saved; rebuilt as the level's objects are
+ * placed when it is restored.
+ */
+struct objpile {
+    unsigned short count;      /* number of objects (stacks) here */
+    unsigned short boulders;   /* how many of those are boulders, */
+    unsigned short containers; /*   containers, */
+    unsigned short corpses;    /*   and corpses */
+    unsigned long classes;     /* (1L << oclass) for each class present */
+};
+
 typedef struct {
     struct rm locations[COLNO][ROWNO];
 #ifndef MICROPORT_BUG
@@ -593,6 +609,7 @@ typedef struct {
     struct monst *monsters[1][ROWNO];
     char *yuk2[COLNO - 1][ROWNO];
 #endif
+    struct objpile piles[COLNO][ROWNO];
     struct obj *objlist;
     struct obj *buriedobjlist;
     struct monst *monlist;
@@ -621,6 +638,9 @@ extern dlevel_t level; /* structure describing the current level */
 #define defsym_to_trap(d) ((d) -S_arrow_trap + 1)
 
 #define OBJ_AT(x, y) (level.objects[x][y] != (struct obj *) 0)
+#define pile_at(x, y) (&level.piles[x][y])
+#define pile_has_class(x, y, oclass) \
+    ((level.piles[x][y].classes & (1L << (oclass))) != 0L)
 /*
  * Macros for encapsulation of level.monsters references.
  */
@@ -218,7 +218,8 @@ enum sp_obj_var_flags {
 #define SPOVAR_OBJ                                                 \
     0x08 /* object class & specific object type, encoded in l; use \
             SP_OBJ_... */
-#define SPOVAR_SEL 0x09   /* selection. char[COLNO][ROWNO] in str */
+#define SPOVAR_SEL 0x09   /* selection. char[COLNO][ROWNO] in a .lev file, \
+                             struct selectionvar in sel once loaded */
 #define SPOVAR_ARRAY 0x40 /* used in splev_var & lc_vardefs, not in opvar */
 
 #define SP_COORD_IS_RANDOM 0x01000000
@@ -309,7 +309,7 @@
 
 #define HLOCK "perm" /* an empty file used for locking purposes */
 
-#define tgetch getchar
+#define tgetch unix_tgetch
 
 #ifndef NOSHELL
 #define SHELL /* do not delete the '!' command */
@@ -15,7 +15,9 @@ typedef struct tty_mi {
     struct tty_mi *next;
     anything identifier; /* user identifier */
     long count;          /* user count */
-    char *str;           /* description string (including accelerator) */
+    char *str;           /* description string (including accelerator),
+                          * null until fetched if from add_menu_items() */
+    int fillidx;         /* index for get_menu_item(), or -1 */
     int attr;            /* string attribute */
     boolean selected;    /* TRUE if selected by user */
     char selector;       /* keyboard accelerator */
@@ -124,6 +126,16 @@ E void FDECL(xputc, (int));
 E void FDECL(xputc, (CHAR_P));
 #endif
 E void FDECL(xputs, (const char *));
+#ifndef NO_TERMS
+/* termcap.c collects a frame of output and sends it with xflush() */
+#ifndef TTY_FRAMESZ
+#define TTY_FRAMESZ 16384
+#endif
+E void NDECL(xflush);
+E void FDECL(tty_frame_stats, (long *, long *, long *));
+#else
+#define xflush() (void) fflush(stdout)
+#endif
 #if defined(SCREEN_VGA) || defined(SCREEN_8514)
 E void FDECL(xputg, (int, int, unsigned));
 #endif
@@ -176,6 +188,13 @@ E void FDECL(docorner, (int, int));
 E void NDECL(end_glyphout);
 E void FDECL(g_putch, (int));
 E void FDECL(win_tty_init, (int));
+#ifndef NO_TERMS
+E void FDECL(tty_shadow_row, (int, int, BOOLEAN_P));
+E void FDECL(tty_shadow_reset, (BOOLEAN_P));
+#else
+#define tty_shadow_row(x, y, blank)
+#define tty_shadow_reset(blank)
+#endif
 
 /* external declarations */
 E void FDECL(tty_init_nhwindows, (int *, char **));
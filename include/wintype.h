@@ -59,6 +59,18 @@ typedef struct mi {
 } menu_item;
 #define MENU_ITEM_P struct mi
 
+/* one menu line supplied on demand; see add_menu_items() in windows.c */
+typedef struct mf {
+    int glyph;            /* as for add_menu() */
+    anything identifier;
+    char accelerator, groupacc;
+    int attr;
+    boolean preselected;
+    char *str;            /* BUFSZ buffer for the text, or null when
+                           * only the other fields are wanted */
+} menu_fill;
+#define MENU_FILL_P struct mf
+
 /* select_menu() "how" argument types */
 /* [MINV_PICKMASK in monst.h assumes these have values of 0, 1, 2] */
 #define PICK_NONE 0 /* user picks nothing (display only) */
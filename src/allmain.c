@@ -6,6 +6,9 @@
 /* various code that was replicated in *main.c */
 
 #include "hack.h"
+#if defined(PERFSTATS) && defined(TTY_GRAPHICS)
+#include "wintty.h" /* tty_frame_stats() */
+#endif
 #include <ctype.h>
 
 #ifndef NO_SIGNAL
@@ -18,6 +21,9 @@ STATIC_DCL void NDECL(do_positionbar);
 STATIC_DCL void FDECL(regen_hp, (int));
 STATIC_DCL void FDECL(interrupt_multi, (const char *));
 STATIC_DCL void FDECL(debug_fields, (const char *));
+#ifdef PERFSTATS
+STATIC_DCL long NDECL(perf_turns);
+#endif
 
 void
 moveloop(resuming)
@@ -100,7 +106,9 @@ boolean resuming;
 
                 context.mon_moving = TRUE;
                 do {
+                    PERF_START(PERF_MOVEMON);
                     monscanmove = movemon();
+                    PERF_STOP(PERF_MOVEMON);
                     if (youmonst.movement >= NORMAL_SPEED)
                         break; /* it's now your turn */
                 } while (monscanmove);
@@ -354,7 +362,10 @@ boolean resuming;
             if (vision_full_recalc)
                 vision_recalc(0); /* vision! */
         }
-        if (context.botl || context.botlx) {
+        /* when the hero is about to be asked for a command, leave the
+           status update to the flush_screen() that precedes the input
+           wait so that it's done once for all of this turn's changes */
+        if ((context.botl || context.botlx) && (multi || occupation)) {
             bot();
             curs_on_u();
         }
@@ -756,6 +767,7 @@ const char *msg;
 static struct early_opt earlyopts[] = {
     {ARG_DEBUG, "debug", 5, TRUE},
     {ARG_VERSION, "version", 4, TRUE},
+    {ARG_SEED, "seed", 4, TRUE},
 };
 
 /*
@@ -829,6 +841,22 @@ enum earlyarg e_arg;
                         return 2;
                         break;
             }
+            case ARG_SEED:
+                        /* "seed=levgen:N" has a ':' after the '=' */
+                        extended_opt = userea + strlen(earlyopts[idx].name);
+                        if ((*extended_opt != ':' && *extended_opt != '=')
+                            || !parse_rng_seeds(extended_opt + 1)) {
+                            raw_printf(
+              "-%sseed requires a value: -%sseed:N or -%sseed:stream:N[,...]\n",
+                                       dashdash, dashdash, dashdash);
+                            return 2;
+                        }
+                        /* it may be anywhere; take it out of argv so the
+                           caller just has to decrement argc */
+                        for (; i < argc; ++i)
+                            argv[i] = argv[i + 1];
+                        return 1;
+                        break;
             default:
                         break;
         }
@@ -894,4 +922,149 @@ const char *opts;
 #endif
     return;
 }
+
+#ifdef PERFSTATS
+/*
+ * Per-phase CPU profile.  PERF_START()/PERF_STOP() bracket the expensive
+ * parts of a turn; each phase counts its calls and accumulates the
+ * clock() ticks spent in it.  Phases can nest (flush_screen() during
+ * movemon(), do_light_sources() during vision_recalc()), so times are
+ * inclusive; a phase re-entered from within itself is only timed at the
+ * outermost level.  #perfstats shows the numbers and perfstats_dump()
+ * appends them to a JSON log when the game ends.
+ */
+static const char *const perf_names[NUM_PERF_PHASES] = {
+    "movemon", "vision_recalc", "do_light_sources", "run_timers",
+    "run_regions", "flush_screen", "bot", "play_song",
+};
+
+static struct perfstat {
+    long calls;
+    long ticks;   /* total clock() ticks */
+    long maxtick; /* longest single call */
+    clock_t start;
+    int depth;
+} perfstats[NUM_PERF_PHASES];
+static long perf_firstmove = -1L; /* moves when profiling started */
+
+#define PERF_USEC(t) ((long) ((double) (t) * 1000000.0 / CLOCKS_PER_SEC))
+
+void
+perf_start(phase)
+int phase;
+{
+    struct perfstat *ps = &perfstats[phase];
+
+    if (perf_firstmove < 0L)
+        perf_firstmove = moves;
+    if (!ps->depth++)
+        ps->start = clock();
+}
+
+void
+perf_stop(phase)
+int phase;
+{
+    struct perfstat *ps = &perfstats[phase];
+    long t;
+
+    if (ps->depth <= 0 || --ps->depth)
+        return;
+    t = (long) (clock() - ps->start);
+    ps->calls++;
+    ps->ticks += t;
+    if (t > ps->maxtick)
+        ps->maxtick = t;
+}
+
+STATIC_OVL long
+perf_turns()
+{
+    long n = (perf_firstmove < 0L) ? 0L : moves - perf_firstmove;
+
+    return (n > 0L) ? n : 1L;
+}
+
+/* #perfstats; also usable with any line-at-a-time output routine */
+void
+perfstats_report(out)
+void FDECL((*out), (const char *));
+{
+    char buf[BUFSZ];
+    struct perfstat *ps;
+    long turns = perf_turns();
+    int i;
+
+    Sprintf(buf, "CPU time by phase over %ld turn%s, in microseconds:",
+            turns, plur(turns));
+    (*out)(buf);
+    (*out)("");
+    Sprintf(buf, "%-18s %9s %11s %9s %9s %9s", "phase", "calls", "total",
+            "per call", "max", "per turn");
+    (*out)(buf);
+    for (i = 0; i < NUM_PERF_PHASES; i++) {
+        ps = &perfstats[i];
+        Sprintf(buf, "%-18s %9ld %11ld %9ld %9ld %9ld", perf_names[i],
+                ps->calls, PERF_USEC(ps->ticks),
+                ps->calls ? PERF_USEC(ps->ticks) / ps->calls : 0L,
+                PERF_USEC(ps->maxtick), PERF_USEC(ps->ticks) / turns);
+        (*out)(buf);
+    }
+#if defined(TTY_GRAPHICS) && !defined(NO_TERMS)
+    {
+        long frames, bytes, writes;
+
+        tty_frame_stats(&frames, &bytes, &writes);
+        if (frames) {
+            (*out)("");
+            Sprintf(buf,
+                 "tty output: %ld frames, %ld bytes (%ld per frame), %ld writes",
+                    frames, bytes, bytes / frames, writes);
+            (*out)(buf);
+        }
+    }
+#endif
+}
+
+/* append this game's profile to ${NH_PERFSTATS} or PERFSTATS_FILE as a
+   single line of JSON */
+void
+perfstats_dump()
+{
+    char vbuf[BUFSZ];
+    const char *fname;
+    FILE *fp;
+    struct perfstat *ps;
+    int i;
+
+    fname = nh_getenv("NH_PERFSTATS");
+    if (!fname || !*fname)
+        fname = PERFSTATS_FILE;
+    if (!(fp = fopen(fname, "a")))
+        return;
+    (void) fprintf(fp, "{\"version\":\"%s\",\"turns\":%ld,\"phases\":{",
+                   version_string(vbuf), perf_turns());
+    for (i = 0; i < NUM_PERF_PHASES; i++) {
+        ps = &perfstats[i];
+        (void) fprintf(fp,
+            "%s\"%s\":{\"calls\":%ld,\"total_us\":%ld,\"max_us\":%ld}",
+                       i ? "," : "", perf_names[i], ps->calls,
+                       PERF_USEC(ps->ticks), PERF_USEC(ps->maxtick));
+    }
+    (void) fprintf(fp, "}");
+#if defined(TTY_GRAPHICS) && !defined(NO_TERMS)
+    {
+        long frames, bytes, writes;
+
+        tty_frame_stats(&frames, &bytes, &writes);
+        (void) fprintf(fp,
+                       ",\"tty\":{\"frames\":%ld,\"bytes\":%ld,\"writes\":%ld}",
+                       frames, bytes, writes);
+    }
+#endif
+    (void) fprintf(fp, "}\n");
+    (void) fclose(fp);
+}
+#endif /* PERFSTATS */
+
 /*allmain.c*/
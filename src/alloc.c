@@ -9,6 +9,9 @@
    function declarations for all of nethack */
 #define EXTERN_H /* comment line for pre-compiled headers */
 #include "config.h"
+#if defined(MONITOR_HEAP) && defined(UNIX)
+#include <signal.h>
+#endif
 
 char *FDECL(fmt_ptr, (const genericptr));
 
@@ -17,6 +20,14 @@ char *FDECL(fmt_ptr, (const genericptr));
 #undef free
 extern void FDECL(free, (genericptr_t));
 static void NDECL(heapmon_init);
+static int FDECL(heapmon_site, (const char *, int));
+static void FDECL(heapmon_note, (genericptr_t, unsigned, int));
+static void FDECL(heapmon_forget, (genericptr_t));
+static int FDECL(heapmon_cmp, (const genericptr, const genericptr));
+static void FDECL(heapmon_fileline, (const char *));
+#if defined(UNIX) && defined(SIGUSR1)
+static void FDECL(heapmon_sigusr1, (int));
+#endif
 
 static FILE *heaplog = 0;
 static boolean tried_heaplog = FALSE;
@@ -91,6 +102,45 @@ const genericptr ptr;
 
 #ifdef MONITOR_HEAP
 
+/*
+ * In-process allocation profile.  Each nhalloc() is charged to its call
+ * site (file and line), and the block is remembered in a table of live
+ * pointers so that nhfree() can credit the site again.  The tables use
+ * malloc() directly and aren't themselves counted.  heapmon_report()
+ * lists the sites holding the most memory; it's used by the #wizheap
+ * command, and on Unix a SIGUSR1 writes the same report to the file
+ * named by ${NH_HEAPDUMP} (or to stderr) at the next allocation.
+ */
+struct heapsite {
+    const char *file;
+    int line;
+    long live, nlive; /* bytes and blocks currently allocated */
+    long peak;        /* most bytes ever live at once */
+    long nallocs;     /* total allocations made here */
+};
+struct heapblk {
+    genericptr_t ptr; /* null: unused slot */
+    unsigned size;
+    int site;
+};
+
+static struct heapsite *hsites = 0;
+static int nhsites = 0, maxhsites = 0;
+static int *hsiteidx = 0; /* hash of hsites[] indices, -1: unused */
+static int hsiteidxsz = 0;
+static struct heapblk *hblks = 0;
+static long nhblks = 0L, hblksz = 0L;
+static long heap_live = 0L, heap_peak = 0L;
+#if defined(UNIX) && defined(SIGUSR1)
+static volatile int heapmon_dumpreq = 0;
+#endif
+
+#define HEAP_PTRHASH(p, sz) \
+    ((long) ((((unsigned long) (p)) >> 4) * 2654435761UL) & ((sz) - 1))
+#define HEAP_SITEHASH(f, l, sz) \
+    ((int) ((((unsigned long) (f)) >> 2) ^ ((unsigned long) (l) * 40503UL)) \
+     & ((sz) - 1))
+
 /* If ${NH_HEAPLOG} is defined and we can create a file by that name,
    then we'll log the allocation and release information to that file. */
 static void
@@ -101,6 +151,214 @@ heapmon_init()
     if (logname && *logname)
         heaplog = fopen(logname, "w");
     tried_heaplog = TRUE;
+#if defined(UNIX) && defined(SIGUSR1)
+    (void) signal(SIGUSR1, heapmon_sigusr1);
+#endif
+}
+
+#if defined(UNIX) && defined(SIGUSR1)
+/* just note the request; the report is written from nhalloc() */
+static void
+heapmon_sigusr1(sig)
+int sig;
+{
+    heapmon_dumpreq = 1;
+    (void) signal(sig, heapmon_sigusr1);
+}
+#endif
+
+/* find or add the table entry for an allocation site */
+static int
+heapmon_site(file, line)
+const char *file;
+int line;
+{
+    int i, h;
+
+    if (hsiteidxsz) {
+        for (h = HEAP_SITEHASH(file, line, hsiteidxsz); hsiteidx[h] >= 0;
+             h = (h + 1) & (hsiteidxsz - 1))
+            if (hsites[hsiteidx[h]].line == line
+                && hsites[hsiteidx[h]].file == file)
+                return hsiteidx[h];
+    }
+    if (nhsites == maxhsites) {
+        struct heapsite *newsites;
+
+        maxhsites = maxhsites ? 2 * maxhsites : 256;
+        newsites = (struct heapsite *) malloc(maxhsites * sizeof *newsites);
+        if (!newsites)
+            panic("heapmon: out of memory");
+        if (nhsites)
+            (void) memcpy((genericptr_t) newsites, (genericptr_t) hsites,
+                          nhsites * sizeof *newsites);
+        if (hsites)
+            free((genericptr_t) hsites);
+        hsites = newsites;
+    }
+    if (2 * (nhsites + 1) > hsiteidxsz) {
+        /* keep the index at most half full; rebuild it from hsites[] */
+        hsiteidxsz = hsiteidxsz ? 2 * hsiteidxsz : 512;
+        if (hsiteidx)
+            free((genericptr_t) hsiteidx);
+        hsiteidx = (int *) malloc(hsiteidxsz * sizeof *hsiteidx);
+        if (!hsiteidx)
+            panic("heapmon: out of memory");
+        for (h = 0; h < hsiteidxsz; h++)
+            hsiteidx[h] = -1;
+        for (i = 0; i < nhsites; i++) {
+            for (h = HEAP_SITEHASH(hsites[i].file, hsites[i].line,
+                                   hsiteidxsz);
+                 hsiteidx[h] >= 0; h = (h + 1) & (hsiteidxsz - 1))
+                continue;
+            hsiteidx[h] = i;
+        }
+    }
+    i = nhsites++;
+    hsites[i].file = file;
+    hsites[i].line = line;
+    hsites[i].live = hsites[i].nlive = hsites[i].peak = 0L;
+    hsites[i].nallocs = 0L;
+    for (h = HEAP_SITEHASH(file, line, hsiteidxsz); hsiteidx[h] >= 0;
+         h = (h + 1) & (hsiteidxsz - 1))
+        continue;
+    hsiteidx[h] = i;
+    return i;
+}
+
+/* charge a new block to its site and remember it */
+static void
+heapmon_note(ptr, size, site)
+genericptr_t ptr;
+unsigned size;
+int site;
+{
+    struct heapsite *hs = &hsites[site];
+    long h;
+
+    if (2 * (nhblks + 1) > hblksz) {
+        struct heapblk *old = hblks;
+        long i, oldsz = hblksz;
+
+        hblksz = hblksz ? 2 * hblksz : 4096L;
+        hblks = (struct heapblk *) malloc(hblksz * sizeof *hblks);
+        if (!hblks)
+            panic("heapmon: out of memory");
+        for (i = 0; i < hblksz; i++)
+            hblks[i].ptr = (genericptr_t) 0;
+        for (i = 0; i < oldsz; i++)
+            if (old[i].ptr) {
+                for (h = HEAP_PTRHASH(old[i].ptr, hblksz); hblks[h].ptr;
+                     h = (h + 1) & (hblksz - 1))
+                    continue;
+                hblks[h] = old[i];
+            }
+        if (old)
+            free((genericptr_t) old);
+    }
+    for (h = HEAP_PTRHASH(ptr, hblksz); hblks[h].ptr;
+         h = (h + 1) & (hblksz - 1))
+        continue;
+    hblks[h].ptr = ptr;
+    hblks[h].size = size;
+    hblks[h].site = site;
+    nhblks++;
+
+    hs->nallocs++;
+    hs->nlive++;
+    hs->live += size;
+    if (hs->live > hs->peak)
+        hs->peak = hs->live;
+    heap_live += size;
+    if (heap_live > heap_peak)
+        heap_peak = heap_live;
+}
+
+/* credit a released block back to its site; unknown pointers (memory
+   that came from libc directly) are ignored */
+static void
+heapmon_forget(ptr)
+genericptr_t ptr;
+{
+    long h, j, home;
+
+    if (!ptr || !hblksz)
+        return;
+    for (h = HEAP_PTRHASH(ptr, hblksz); hblks[h].ptr != ptr;
+         h = (h + 1) & (hblksz - 1))
+        if (!hblks[h].ptr)
+            return;
+
+    hsites[hblks[h].site].nlive--;
+    hsites[hblks[h].site].live -= hblks[h].size;
+    heap_live -= hblks[h].size;
+    nhblks--;
+
+    /* backward-shift deletion keeps probe sequences unbroken */
+    for (j = h;;) {
+        hblks[h].ptr = (genericptr_t) 0;
+        do {
+            j = (j + 1) & (hblksz - 1);
+            if (!hblks[j].ptr)
+                return;
+            home = HEAP_PTRHASH(hblks[j].ptr, hblksz);
+        } while ((h <= j) ? (h < home && home <= j)
+                          : (h < home || home <= j));
+        hblks[h] = hblks[j];
+        h = j;
+    }
+}
+
+static int
+heapmon_cmp(a, b)
+const genericptr a;
+const genericptr b;
+{
+    long la = hsites[*(const int *) a].live, lb = hsites[*(const int *) b].live;
+
+    return (la < lb) ? 1 : (la > lb) ? -1 : 0;
+}
+
+/* list the sites holding the most memory, a line at a time */
+void
+heapmon_report(maxsites, out)
+int maxsites;
+void FDECL((*out), (const char *));
+{
+    char buf[BUFSZ];
+    int *order, i, n;
+
+    Sprintf(buf, "%ld bytes in %ld blocks live, peak %ld bytes.", heap_live,
+            nhblks, heap_peak);
+    (*out)(buf);
+    if (!nhsites)
+        return;
+    order = (int *) malloc(nhsites * sizeof *order);
+    if (!order)
+        return;
+    for (i = 0; i < nhsites; i++)
+        order[i] = i;
+    qsort((genericptr_t) order, nhsites, sizeof *order, heapmon_cmp);
+    n = (maxsites > 0 && maxsites < nhsites) ? maxsites : nhsites;
+    (*out)("");
+    (*out)("   live bytes  blocks   allocs      peak  site");
+    for (i = 0; i < n; i++) {
+        struct heapsite *hs = &hsites[order[i]];
+
+        Sprintf(buf, "%13ld %7ld %8ld %9ld  %.*s:%d", hs->live, hs->nlive,
+                hs->nallocs, hs->peak, BUFSZ - 60, hs->file, hs->line);
+        (*out)(buf);
+    }
+    free((genericptr_t) order);
+}
+
+static FILE *heapdump = 0;
+
+static void
+heapmon_fileline(line)
+const char *line;
+{
+    (void) fprintf(heapdump, "%s\n", line);
 }
 
 long *
@@ -113,12 +371,27 @@ int line;
 
     if (!tried_heaplog)
         heapmon_init();
+#if defined(UNIX) && defined(SIGUSR1)
+    if (heapmon_dumpreq) {
+        char *dumpname = getenv("NH_HEAPDUMP");
+
+        heapmon_dumpreq = 0;
+        heapdump = (dumpname && *dumpname) ? fopen(dumpname, "a") : 0;
+        if (!heapdump)
+            heapdump = stderr;
+        heapmon_report(0, heapmon_fileline);
+        if (heapdump != stderr)
+            (void) fclose(heapdump);
+        heapdump = 0;
+    }
+#endif
     if (heaplog)
         (void) fprintf(heaplog, "+%5u %s %4d %s\n", lth,
                        fmt_ptr((genericptr_t) ptr), line, file);
     /* potential panic in alloc() was deferred til here */
     if (!ptr)
         panic("Cannot get %u bytes, line %d of %s", lth, line, file);
+    heapmon_note((genericptr_t) ptr, lth, heapmon_site(file, line));
 
     return ptr;
 }
@@ -134,6 +407,7 @@ int line;
     if (heaplog)
         (void) fprintf(heaplog, "-      %s %4d %s\n",
                        fmt_ptr((genericptr_t) ptr), line, file);
+    heapmon_forget(ptr);
 
     free(ptr);
 }
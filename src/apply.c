@@ -1456,6 +1456,7 @@ dorub()
                but an indebted one who grants a wish might bestow an
                artifact which blasts the hero with lethal results) */
             uwep->otyp = OIL_LAMP;
+            invent_changed();
             uwep->spe = 0; /* for safety */
             uwep->age = rn1(500, 1000);
             if (uwep->lamplit)
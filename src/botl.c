@@ -233,6 +233,7 @@ do_statusline2()
 void
 bot()
 {
+    PERF_START(PERF_BOT);
     if (youmonst.data && iflags.status_updates) {
 #ifdef STATUS_HILITES
         bot_via_windowport();
@@ -244,6 +245,7 @@ bot()
 #endif
     }
     context.botl = context.botlx = 0;
+    PERF_STOP(PERF_BOT);
 }
 
 /* convert experience level (1..30) to rank index (0..8) */
@@ -433,6 +435,7 @@ struct istat_s {
 
 STATIC_DCL void NDECL(init_blstats);
 STATIC_DCL char *FDECL(anything_to_s, (char *, anything *, int));
+STATIC_DCL void FDECL(bl_keep, (int, int, int));
 STATIC_OVL int FDECL(percentage, (struct istat_s *, struct istat_s *));
 STATIC_OVL int FDECL(compare_blstats, (struct istat_s *, struct istat_s *));
 STATIC_DCL boolean FDECL(evaluate_and_notify_windowport_field,
@@ -507,6 +510,7 @@ static boolean blinit = FALSE, update_all = FALSE;
 static boolean valset[MAXBLSTATS];
 unsigned long blcolormasks[CLR_MAX];
 static long bl_hilite_moves = 0L;
+static long bl_dirty = BL_DIRTY_ALL;
 
 /* we don't put this next declaration in #ifdef STATUS_HILITES.
  * In the absence of STATUS_HILITES, each array
@@ -517,6 +521,29 @@ static long bl_hilite_moves = 0L;
  */
 unsigned long cond_hilites[BL_ATTCLR_MAX];
 
+/*
+ * Flag status fields whose values can't be cheaply recomputed by every
+ * bot() (see BL_DIRTY_* in botl.h).  Callers mark them at the point where
+ * the underlying state changes; everything else is still recomputed and
+ * compared by value.  This doesn't request a status update by itself,
+ * the change is picked up by the next bot().
+ */
+void
+status_dirty(mask)
+long mask;
+{
+    bl_dirty |= mask;
+}
+
+/* carry a field's value forward from the previous status buffer */
+STATIC_OVL void
+bl_keep(fld, idx, idx_p)
+int fld, idx, idx_p;
+{
+    blstats[idx][fld].a = blstats[idx_p][fld].a;
+    Strcpy(blstats[idx][fld].val, blstats[idx_p][fld].val);
+}
+
 void
 bot_via_windowport()
 {
@@ -531,6 +558,10 @@ bot_via_windowport()
     idx_p = idx;
     idx = 1 - idx; /* 0 -> 1, 1 -> 0 */
 
+    /* a full redisplay re-evaluates everything */
+    if (update_all || context.botlx)
+        bl_dirty = BL_DIRTY_ALL;
+
     /* clear the "value set" indicators */
     (void) memset((genericptr_t) valset, 0, MAXBLSTATS * sizeof (boolean));
 
@@ -575,12 +606,22 @@ bot_via_windowport()
                                                ? "Neutral"
                                                : "Lawful");
 
-    /* Score */
-    blstats[idx][BL_SCORE].a.a_long =
+    /* Gold */
+    if ((money = money_cnt(invent)) < 0L)
+        money = 0L; /* ought to issue impossible() and then discard gold */
+    blstats[idx][BL_GOLD].a.a_long = min(money, 999999L);
+
+    /* Score; it includes carried gold so changing that also counts */
+    if ((bl_dirty & BL_DIRTY_SCORE) != 0L
+        || blstats[idx][BL_GOLD].a.a_long
+               != blstats[idx_p][BL_GOLD].a.a_long)
+        blstats[idx][BL_SCORE].a.a_long =
 #ifdef SCORE_ON_BOTL
-        flags.showscore ? botl_score() :
+            flags.showscore ? botl_score() :
 #endif
-        0L;
+            0L;
+    else
+        bl_keep(BL_SCORE, idx, idx_p);
 
     /*  Hit points  */
     i = Upolyd ? u.mh : u.uhp;
@@ -591,13 +632,12 @@ bot_via_windowport()
     blstats[idx][BL_HPMAX].a.a_int = min(i, 9999);
 
     /*  Dungeon level. */
-    (void) describe_level(blstats[idx][BL_LEVELDESC].val);
+    if ((bl_dirty & BL_DIRTY_LEVEL) != 0L)
+        (void) describe_level(blstats[idx][BL_LEVELDESC].val);
+    else
+        bl_keep(BL_LEVELDESC, idx, idx_p);
     valset[BL_LEVELDESC] = TRUE; /* indicate val already set */
 
-    /* Gold */
-    if ((money = money_cnt(invent)) < 0L)
-        money = 0L; /* ought to issue impossible() and then discard gold */
-    blstats[idx][BL_GOLD].a.a_long = min(money, 999999L);
     /*
      * The tty port needs to display the current symbol for gold
      * as a field header, so to accommodate that we pass gold with
@@ -642,10 +682,14 @@ bot_via_windowport()
     valset[BL_HUNGER] = TRUE;
 
     /* Carrying capacity */
-    cap = near_capacity();
-    blstats[idx][BL_CAP].a.a_int = cap;
-    Strcpy(blstats[idx][BL_CAP].val,
-           (cap > UNENCUMBERED) ? enc_stat[cap] : "");
+    if ((bl_dirty & BL_DIRTY_CAP) != 0L) {
+        cap = near_capacity();
+        blstats[idx][BL_CAP].a.a_int = cap;
+        Strcpy(blstats[idx][BL_CAP].val,
+               (cap > UNENCUMBERED) ? enc_stat[cap] : "");
+    } else {
+        bl_keep(BL_CAP, idx, idx_p);
+    }
     valset[BL_CAP] = TRUE;
 
     /* Conditions */
@@ -680,6 +724,7 @@ bot_via_windowport()
         blstats[idx][BL_CONDITION].a.a_ulong |= BL_MASK_FLY;
     if (u.usteed)
         blstats[idx][BL_CONDITION].a.a_ulong |= BL_MASK_RIDE;
+    bl_dirty = 0L;
     evaluate_and_notify_windowport(valset, idx, idx_p);
 }
 
@@ -786,10 +831,12 @@ boolean *valsetlist;
      * text display obliterates the status line.
      *
      * To work around it, we call status_update() with fictitious
-     * index of BL_FLUSH (-1).
+     * index of BL_FLUSH (-1).  Ports with WC2_FLUSH_STATUS buffer the
+     * field updates and get BL_FLUSH as the end of the batch, but only
+     * when there was something in it.
      */
-    if ((context.botlx && !updated)
-        || (windowprocs.wincap2 & WC2_FLUSH_STATUS) != 0L)
+    if (context.botlx
+        || (updated && (windowprocs.wincap2 & WC2_FLUSH_STATUS) != 0L))
         status_update(BL_FLUSH, (genericptr_t) 0, 0, 0,
                       NO_COLOR, &cond_hilites[0]);
 
@@ -166,6 +166,15 @@ STATIC_DCL boolean FDECL(accept_menu_prefix, (int NDECL((*))));
 STATIC_DCL int NDECL(wiz_port_debug);
 #endif
 STATIC_PTR int NDECL(wiz_rumor_check);
+STATIC_PTR int NDECL(wiz_name_bench);
+#ifdef MONITOR_HEAP
+STATIC_DCL void FDECL(wiz_heap_line, (const char *));
+STATIC_PTR int NDECL(wiz_heap);
+#endif
+#ifdef PERFSTATS
+STATIC_DCL void FDECL(wiz_perf_line, (const char *));
+STATIC_PTR int NDECL(wiz_perfstats);
+#endif
 STATIC_PTR int NDECL(doattributes);
 
 STATIC_DCL void FDECL(enlght_line, (const char *, const char *, const char *,
@@ -183,12 +192,16 @@ STATIC_DCL void FDECL(attributes_enlightenment, (int, int));
 
 static const char *readchar_queue = "";
 static coord clicklook_cc;
+static char unread_keys[BUFSZ]; /* keys given back to readchar() */
+static char coalesced_key = '\0';
 
 STATIC_DCL void FDECL(add_herecmd_menuitem, (winid, int NDECL((*)),
                                              const char *));
 STATIC_DCL char FDECL(here_cmd_menu, (BOOLEAN_P));
 STATIC_DCL char FDECL(there_cmd_menu, (BOOLEAN_P, int, int));
 STATIC_DCL char *NDECL(parse);
+STATIC_DCL boolean FDECL(coalescible_key, (int));
+STATIC_DCL void FDECL(unread_key, (int, int));
 STATIC_DCL void FDECL(show_direction_keys, (winid, CHAR_P, BOOLEAN_P));
 STATIC_DCL boolean FDECL(help_dir, (CHAR_P, int, const char *));
 
@@ -315,6 +328,68 @@ char ch;
     return;
 }
 
+/*
+ * Typeahead.  A window port which can tell keeps iflags.typeahead set to
+ * the number of keys it has already read but not yet handed over.  While
+ * there are some, parse() leaves the display for the last of the queued
+ * commands to bring up to date, and a run of identical search keys (or
+ * walking keys, when that won't skip autopickup) is turned into a single
+ * counted command.  If the run gets interrupted, the keys it hadn't got
+ * to yet are given back by nomul().
+ */
+boolean
+typeahead_pending()
+{
+    return (boolean) (*readchar_queue || iflags.typeahead > 0);
+}
+
+/* a counted run of key behaves just like key typed that many times */
+STATIC_OVL boolean
+coalescible_key(key)
+int key;
+{
+    const struct ext_func_tab *tlist = Cmd.commands[key & 0xff];
+    schar dx = u.dx, dy = u.dy, dz = u.dz;
+    boolean walk;
+
+    if (tlist && tlist->ef_funct == dosearch)
+        return TRUE;
+    /* walking with a count doesn't autopickup until the last step */
+    if (flags.pickup)
+        return FALSE;
+    walk = movecmd((char) key);
+    u.dx = dx, u.dy = dy, u.dz = dz; /* movecmd() sets them */
+    return walk;
+}
+
+/* push keys back in front of whatever else is waiting */
+STATIC_OVL void
+unread_key(key, count)
+int key, count;
+{
+    int len = (int) strlen(readchar_queue);
+
+    if (count > (int) sizeof unread_keys - 1 - len)
+        count = (int) sizeof unread_keys - 1 - len;
+    if (count <= 0)
+        return;
+    (void) memmove((genericptr_t) &unread_keys[count],
+                   (genericptr_t) readchar_queue, (size_t) len + 1);
+    (void) memset((genericptr_t) unread_keys, key, (size_t) count);
+    readchar_queue = unread_keys;
+}
+
+/* a coalesced run was cut short with count keys' worth still to do */
+void
+uncoalesce_keys(count)
+int count;
+{
+    if (coalesced_key) {
+        unread_key(coalesced_key, count);
+        coalesced_key = '\0';
+    }
+}
+
 /* here after # - now read a full-word command */
 STATIC_PTR int
 doextcmd(VOID_ARGS)
@@ -1294,6 +1369,60 @@ wiz_rumor_check(VOID_ARGS)
     return 0;
 }
 
+/* #wiznamebench command - time object name formatting */
+STATIC_PTR int
+wiz_name_bench(VOID_ARGS)
+{
+    objnam_bench();
+    return 0;
+}
+
+#ifdef MONITOR_HEAP
+static winid heapwin = WIN_ERR;
+
+STATIC_OVL void
+wiz_heap_line(line)
+const char *line;
+{
+    putstr(heapwin, 0, line);
+}
+
+/* #wizheap command - show the allocation sites holding the most memory */
+STATIC_PTR int
+wiz_heap(VOID_ARGS)
+{
+    heapwin = create_nhwindow(NHW_TEXT);
+    heapmon_report(30, wiz_heap_line);
+    display_nhwindow(heapwin, TRUE);
+    destroy_nhwindow(heapwin);
+    heapwin = WIN_ERR;
+    return 0;
+}
+#endif
+
+#ifdef PERFSTATS
+static winid perfwin = WIN_ERR;
+
+STATIC_OVL void
+wiz_perf_line(line)
+const char *line;
+{
+    putstr(perfwin, 0, line);
+}
+
+/* #perfstats command - show time spent in each phase of the turn */
+STATIC_PTR int
+wiz_perfstats(VOID_ARGS)
+{
+    perfwin = create_nhwindow(NHW_TEXT);
+    perfstats_report(wiz_perf_line);
+    display_nhwindow(perfwin, TRUE);
+    destroy_nhwindow(perfwin);
+    perfwin = WIN_ERR;
+    return 0;
+}
+#endif
+
 /* #terrain command -- show known map, inspired by crawl's '|' command */
 STATIC_PTR int
 doterrain(VOID_ARGS)
@@ -2953,6 +3082,10 @@ struct ext_func_tab extcmdlist[] = {
     { '\0', "panic", "test panic routine (fatal to game)",
             wiz_panic, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
     { 'p', "pay", "pay your shopping bill", dopay },
+#ifdef PERFSTATS
+    { '\0', "perfstats", "show time spent in each phase of a turn",
+            wiz_perfstats, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
+#endif
     { ',', "pickup", "pick up things at the current location", dopickup },
     { '\0', "polyself", "polymorph self",
             wiz_polyself, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
@@ -3050,6 +3183,10 @@ struct ext_func_tab extcmdlist[] = {
             wiz_detect, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
     { C('g'), "wizgenesis", "create a monster",
             wiz_genesis, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
+#ifdef MONITOR_HEAP
+    { '\0', "wizheap", "show allocation sites using the most memory",
+            wiz_heap, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
+#endif
     { C('i'), "wizidentify", "identify all items in inventory",
             wiz_identify, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
     { '\0', "wizintrinsic", "set an intrinsic",
@@ -3060,6 +3197,8 @@ struct ext_func_tab extcmdlist[] = {
             wiz_makemap, IFBURIED | WIZMODECMD },
     { C('f'), "wizmap", "map the level",
             wiz_map, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
+    { '\0', "wiznamebench", "time object name formatting",
+            wiz_name_bench, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
     { '\0', "wizrumorcheck", "verify rumor boundaries",
             wiz_rumor_check, IFBURIED | AUTOCOMPLETE | WIZMODECMD },
     { '\0', "wizsmell", "smell monster",
@@ -5102,7 +5241,8 @@ boolean historical; /* whether to include in message history: True => yes */
             break;
         }
 
-        if (cnt > 9 || backspaced) {
+        /* no need to echo the count while more of it is queued */
+        if ((cnt > 9 || backspaced) && !typeahead_pending()) {
             clear_nhwindow(WIN_MESSAGE);
             if (backspaced && !cnt) {
                 Sprintf(qbuf, "Count: ");
@@ -5140,8 +5280,12 @@ parse()
 
     iflags.in_parse = TRUE;
     multi = 0;
+    coalesced_key = '\0';
     context.move = 1;
-    flush_screen(1); /* Flush screen buffer. Put the cursor on the hero. */
+    /* Flush screen buffer and put the cursor on the hero, unless more
+       commands are already queued; the last of them will do it. */
+    if (!typeahead_pending())
+        flush_screen(1);
 
 #ifdef ALTMETA
     alt_esc = iflags.altmeta; /* readchar() hack */
@@ -5165,6 +5309,21 @@ parse()
         last_multi = multi;
         savech(0); /* reset input queue */
         savech((char) foo);
+        if (!multi && typeahead_pending() && coalescible_key(foo)) {
+            int key = foo, n = 1;
+
+            /* moveloop() only counts down a walk shorter than COLNO,
+               and whatever a cut run gives back has to fit unread_keys */
+            while (n < COLNO && typeahead_pending()
+                   && (key = readchar()) == foo)
+                n++;
+            if (key != foo)
+                unread_key(key, 1);
+            if (n > 1) {
+                multi = n; /* not last_multi; ^A still repeats one */
+                coalesced_key = (char) foo;
+            }
+        }
     }
 
     if (multi) {
@@ -5415,8 +5574,7 @@ char def;
 {
     char res, qbuf[QBUFSZ];
 #ifdef DUMPLOG
-    extern unsigned saved_pline_index; /* pline.c */
-    unsigned idx = saved_pline_index;
+    unsigned long logged = msghist_serial(MSGH_DUMPLOG);
     /* buffer to hold query+space+formatted_single_char_response */
     char dumplog_buf[QBUFSZ + 1 + 15]; /* [QBUFSZ+1+7] should suffice */
 #endif
@@ -5433,9 +5591,9 @@ char def;
     }
     res = (*windowprocs.win_yn_function)(query, resp, def);
 #ifdef DUMPLOG
-    if (idx == saved_pline_index) {
-        /* when idx is still the same as saved_pline_index, the interface
-           didn't put the prompt into saved_plines[]; we put a simplified
+    if (logged == msghist_serial(MSGH_DUMPLOG)) {
+        /* when nothing has been logged since the call, the interface
+           didn't put the prompt into the dumplog; we put a simplified
            version in there now (without response choices or default) */
         Sprintf(dumplog_buf, "%s ", query);
         (void) key2txt((uchar) res, eos(dumplog_buf));
@@ -201,6 +201,12 @@ NEARDATA struct monst zeromonst = DUMMY;
 /* used to zero out union any; initializer deliberately omitted */
 NEARDATA anything zeroany;
 
+/* see newobj(), newmonst(), newoextra(), newmextra() */
+NEARDATA struct nhpool obj_pool = { sizeof (struct obj) },
+                       oextra_pool = { sizeof (struct oextra) },
+                       monst_pool = { sizeof (struct monst) },
+                       mextra_pool = { sizeof (struct mextra) };
+
 /* originally from dog.c */
 NEARDATA char dogname[PL_PSIZ] = DUMMY;
 NEARDATA char catname[PL_PSIZ] = DUMMY;
@@ -1578,6 +1578,7 @@ int cursor_on_u;
     if (program_state.done_hup)
         return;
 #endif
+    PERF_START(PERF_FLUSH);
 
     for (y = 0; y < ROWNO; y++) {
         register gbuf_entry *gptr = &gbuf[y][x = gbuf_start[y]];
@@ -1593,6 +1594,7 @@ int cursor_on_u;
     display_nhwindow(WIN_MAP, FALSE);
     reset_glyph_bbox();
     flushing = 0;
+    PERF_STOP(PERF_FLUSH);
     if (context.botl || context.botlx)
         bot();
 }
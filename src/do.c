@@ -707,7 +707,7 @@ boolean with_impact;
         stackobj(obj);
         if (Blind && Levitation)
             map_object(obj, 0);
-        newsym(u.ux, u.uy); /* remap location under self */
+        invbatch_newsym(u.ux, u.uy); /* remap location under self */
     }
 }
 
@@ -829,8 +829,10 @@ int retry;
          * items remain.
          */
         bypass_objlist(invent, FALSE); /* clear bypass bit for invent */
+        begin_invbatch(FALSE);
         while ((otmp = nxt_unbypassed_obj(invent)) != 0)
             n_dropped += drop(otmp);
+        end_invbatch();
         /* we might not have dropped everything (worn armor, welded weapon,
            cursed loadstones), so reset any remaining inventory to normal */
         bypass_objlist(invent, FALSE);
@@ -853,6 +855,7 @@ int retry;
              * to verify that it is in invent and has that bit set.
              */
             bypass_objlist(invent, TRUE);
+            begin_invbatch(FALSE);
             for (i = 0; i < n; i++) {
                 otmp = pick_list[i].item.a_obj;
                 for (otmp2 = invent; otmp2; otmp2 = otmp2->nobj)
@@ -874,6 +877,7 @@ int retry;
                 }
                 n_dropped += drop(otmp);
             }
+            end_invbatch();
             bypass_objlist(invent, FALSE); /* reset invent to normal */
             free((genericptr_t) pick_list);
         }
@@ -1273,6 +1277,7 @@ boolean at_stairs, falling, portal;
     assign_level(&u.uz0, &u.uz);
     assign_level(&u.uz, newlevel);
     assign_level(&u.utolev, newlevel);
+    status_dirty(BL_DIRTY_LEVEL | BL_DIRTY_SCORE);
     u.utotype = 0;
     if (!builds_up(&u.uz)) { /* usual case */
         if (dunlev(&u.uz) > dunlev_reached(&u.uz))
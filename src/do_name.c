@@ -1020,6 +1020,7 @@ int lth; /* desired length (caller handles adding 1 for terminator) */
         else
             free_oname(obj); /* already has oextra, might also have name */
         ONAME(obj) = (char *) alloc((unsigned) lth);
+        objnam_changed(); /* new name might reuse a freed one's memory */
     } else {
         /* zero length: the new name is empty; get rid of the old name */
         if (has_oname(obj))
@@ -1461,6 +1462,7 @@ struct obj *obj;
     if (!*buf || *buf == '\033')
         return;
 
+    objnam_changed();
     /* clear old name */
     str1 = &(objects[obj->otyp].oc_uname);
     if (*str1)
@@ -1944,12 +1946,13 @@ char *code;
 {
     static char buf[BUFSZ];
     char *mname;
-    int name;
+    int name, oldrng;
 #define BOGUSMONSIZE 100 /* arbitrary */
 
     if (code)
         *code = '\0';
 
+    oldrng = rng_select(RNG_DISP);
     do {
         name = rn1(SPECIAL_PM + BOGUSMONSIZE - LOW_PM, LOW_PM);
     } while (name < SPECIAL_PM
@@ -1960,6 +1963,7 @@ char *code;
     } else {
         mname = strcpy(buf, mons[name].mname);
     }
+    (void) rng_select(oldrng);
     return mname;
 #undef BOGUSMONSIZE
 }
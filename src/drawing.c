@@ -24,6 +24,7 @@ int currentgraphics = 0;
 nhsym showsyms[SYM_MAX] = DUMMY; /* symbols to be displayed */
 nhsym l_syms[SYM_MAX] = DUMMY;   /* loaded symbols          */
 nhsym r_syms[SYM_MAX] = DUMMY;   /* rogue symbols           */
+unsigned showsyms_gen = 0;       /* bumped when showsyms[] is reloaded */
 
 nhsym warnsyms[WARNCOUNT] = DUMMY; /* the current warning display symbols */
 const char invisexplain[] = "remembered, unseen, creature";
@@ -378,6 +379,7 @@ init_showsyms()
         else if (i == SYM_INVISIBLE)
             showsyms[i + SYM_OFF_X] = DEF_INVISIBLE;
     }
+    showsyms_gen++;
 }
 
 /* initialize defaults for the loadable symset */
@@ -473,6 +475,7 @@ int whichset;
         currentgraphics = PRIMARY;
         break;
     }
+    showsyms_gen++;
 }
 
 void
@@ -494,6 +497,7 @@ int nondefault;
         if (SYMHANDLING(H_DEC) && decgraphics_mode_callback)
             (*decgraphics_mode_callback)();
 #endif
+        showsyms_gen++;
     } else
         init_symbols();
 }
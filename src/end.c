@@ -676,22 +676,16 @@ char *defquery;
 STATIC_OVL void
 dump_plines()
 {
-    int i, j;
-    char buf[BUFSZ], **strp;
-    extern char *saved_plines[];
-    extern unsigned saved_pline_index;
+    int i;
+    char buf[BUFSZ];
+    const char *msg;
 
     Strcpy(buf, " "); /* one space for indentation */
     putstr(0, 0, "Latest messages:");
-    for (i = 0, j = (int) saved_pline_index; i < DUMPLOG_MSG_COUNT;
-         ++i, j = (j + 1) % DUMPLOG_MSG_COUNT) {
-        strp = &saved_plines[j];
-        if (*strp) {
-            copynchars(&buf[1], *strp, BUFSZ - 1 - 1);
+    for (i = DUMPLOG_MSG_COUNT - 1; i >= 0; --i) {
+        if ((msg = msghist_get(MSGH_DUMPLOG, i)) != 0) {
+            copynchars(&buf[1], msg, BUFSZ - 1 - 1);
             putstr(0, 0, buf);
-#ifdef FREE_ALL_MEMORY
-            free(*strp), *strp = 0;
-#endif
         }
     }
 }
@@ -1455,6 +1449,9 @@ int how;
         destroy_nhwindow(endwin);
 
     dump_close_log();
+#ifdef PERFSTATS
+    perfstats_dump();
+#endif
     /* "So when I die, the first thing I will see in Heaven is a
      * score list?" */
     if (have_windows && !iflags.toptenwin)
@@ -171,6 +171,7 @@ register int exper, rexp;
         newrexp = LONG_MAX;
     u.uexp = newexp;
     u.urexp = newrexp;
+    status_dirty(BL_DIRTY_SCORE);
 
     if (exper
 #ifdef SCORE_ON_BOTL
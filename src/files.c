@@ -2783,6 +2783,24 @@ const char *line;
     return TRUE;
 }
 
+/* line of the config file being read, for problems found later */
+int
+config_error_lineno()
+{
+    return config_error_data ? config_error_data->line_num : 0;
+}
+
+/* attribute further errors to an earlier line, without echoing it */
+void
+config_error_setline(line_num)
+int line_num;
+{
+    if (!config_error_data)
+        return;
+    config_error_data->line_num = line_num;
+    config_error_data->origline_shown = TRUE;
+}
+
 /*VARARGS1*/
 void config_error_add
 VA_DECL(const char *, str)
@@ -2860,8 +2878,11 @@ int src;
     free_config_sections();
     iflags.parse_config_file_src = src;
 
+    defer_rule_regexes();
     rv = parse_conf_file(fp, parse_config_line);
     (void) fclose(fp);
+    if (!check_rule_regexes())
+        rv = FALSE;
 
     free_config_sections();
     /* turn off detection of duplicate configfile options */
@@ -2777,6 +2777,8 @@ register int nval;
 {
     if (multi < nval)
         return;              /* This is a bug fix by ab@unido */
+    if (multi > 0 && nval <= 0)
+        uncoalesce_keys(multi); /* give back keys a cut run didn't use */
     u.uinvulnerable = FALSE; /* Kludge to avoid ctrl-C bug -dlc */
     u.usleep = 0;
     multi = nval;
@@ -2937,19 +2939,31 @@ int
 inv_weight()
 {
     register struct obj *otmp = invent;
-    register int wt = 0;
+    int wt = 0;
 
-    while (otmp) {
-        if (otmp->oclass == COIN_CLASS)
-            wt += (int) (((long) otmp->quan + 50L) / 100L);
-        else if (otmp->otyp != BOULDER || !throws_rocks(youmonst.data))
-            wt += otmp->owt;
-        otmp = otmp->nobj;
+    if (!invbatch_weight(&wt)) {
+        while (otmp) {
+            wt += inv_objweight(otmp);
+            otmp = otmp->nobj;
+        }
+        invbatch_setweight(wt);
     }
     wc = weight_cap();
     return (wt - wc);
 }
 
+/* how much obj contributes to inv_weight() when carried by the hero */
+int
+inv_objweight(obj)
+struct obj *obj;
+{
+    if (obj->oclass == COIN_CLASS)
+        return (int) (((long) obj->quan + 50L) / 100L);
+    else if (obj->otyp != BOULDER || !throws_rocks(youmonst.data))
+        return (int) obj->owt;
+    return 0;
+}
+
 /*
  * Returns 0 if below normal capacity, or the number of "capacity units"
  * over the normal capacity the player is loaded.  Max is 5.
@@ -7,8 +7,9 @@
 #include "hack.h" /* for config.h+extern.h */
 /*=
     Assorted 'small' utility routines.  They're virtually independent of
-    NetHack, except that rounddiv may call panic().  setrandom calls one
-    of srandom(), srand48(), or srand() depending upon configuration.
+    NetHack, except that rounddiv may call panic().  setrandom seeds the
+    game's random number streams and calls one of srandom(), srand48(),
+    or srand() depending upon configuration.
 
       return type     routine name    argument type(s)
         boolean         digit           (char)
@@ -50,6 +51,18 @@
         char *          strstri         (const char *, const char *)
         boolean         fuzzymatch      (const char *, const char *,
                                          const char *, boolean)
+        unsigned long   namehash        (const char *, int)
+        int             nametab_lookup  (const struct nametab *,
+                                         const char *, const short **)
+        void            idtab_add       (struct id_table *, unsigned,
+                                         anything *)
+        anything *      idtab_find      (struct id_table *, unsigned)
+        void            idtab_del       (struct id_table *, unsigned,
+                                         genericptr_t)
+        void            idtab_clear     (struct id_table *)
+        genericptr_t    pool_alloc      (struct nhpool *, int)
+        void            pool_free       (struct nhpool *, genericptr_t)
+        void            pool_trim       (struct nhpool *)
         void            setrandom       (void)
         time_t          getnow          (void)
         int             getyear         (void)
@@ -817,6 +830,309 @@ boolean caseblind;
     return (boolean) (!c1 && !c2);
 }
 
+/* string hash used by the makedefs-generated name tables (nametab.h) */
+unsigned long
+namehash(key, seed)
+const char *key;
+int seed;
+{
+    unsigned long h = NAMEHASH_BASIS ^ NAMEHASH_SEED(seed);
+
+    while (*key)
+        h = NAMEHASH_STEP(h, *key++);
+    return h;
+}
+
+/* look up an already-normalized key; returns the number of values
+   and points *vals at the first of them */
+int
+nametab_lookup(tab, key, vals)
+const struct nametab *tab;
+const char *key;
+const short **vals;
+{
+    const struct nametab_ent *ent;
+    int d;
+
+    d = tab->disp[namehash(key, 0) % (unsigned long) tab->ndisp];
+    ent = &tab->ents[namehash(key, d) % (unsigned long) tab->nents];
+    if (!ent->key || strcmp(ent->key, key))
+        return 0;
+    *vals = &tab->vals[ent->first];
+    return ent->count;
+}
+
+/*
+ * Open-addressed tables mapping nonzero id numbers (o_id, m_id) to
+ * values.  Linear probing; deletion shifts later entries back instead
+ * of leaving tombstones.  Kept at most half full.
+ */
+#define IDTAB_HOME(tab, id) \
+    ((int) (((unsigned long) (id) * 2654435761UL) & 0xffffffffUL) \
+     & ((tab)->size - 1))
+
+/* add or replace the value for id */
+void
+idtab_add(tab, id, val)
+struct id_table *tab;
+unsigned id;
+anything *val;
+{
+    struct id_entry *ent;
+    int i;
+
+    if (!id) {
+        impossible("idtab_add: id 0");
+        return;
+    }
+    if (2 * (tab->count + 1) > tab->size) {
+        struct id_entry *old = tab->ents;
+        int oldsize = tab->size;
+
+        tab->size = oldsize ? 2 * oldsize : 256;
+        tab->ents = (struct id_entry *) alloc(
+                            (unsigned) (tab->size * sizeof (struct id_entry)));
+        (void) memset((genericptr_t) tab->ents, 0,
+                      tab->size * sizeof (struct id_entry));
+        tab->count = 0;
+        for (i = 0; i < oldsize; i++)
+            if (old[i].id)
+                idtab_add(tab, old[i].id, &old[i].val);
+        if (old)
+            free((genericptr_t) old);
+    }
+    for (i = IDTAB_HOME(tab, id); (ent = &tab->ents[i])->id;
+         i = (i + 1) & (tab->size - 1))
+        if (ent->id == id)
+            break;
+    if (!ent->id)
+        tab->count++;
+    ent->id = id;
+    ent->val = *val;
+}
+
+/* value for id, or null */
+anything *
+idtab_find(tab, id)
+struct id_table *tab;
+unsigned id;
+{
+    int i;
+
+    if (!tab->count || !id)
+        return (anything *) 0;
+    for (i = IDTAB_HOME(tab, id); tab->ents[i].id;
+         i = (i + 1) & (tab->size - 1))
+        if (tab->ents[i].id == id)
+            return &tab->ents[i].val;
+    return (anything *) 0;
+}
+
+/* remove id's entry; if ptr is non-null, only when it maps to ptr */
+void
+idtab_del(tab, id, ptr)
+struct id_table *tab;
+unsigned id;
+genericptr_t ptr;
+{
+    int i, j, k, mask = tab->size - 1;
+
+    if (!tab->count || !id)
+        return;
+    for (i = IDTAB_HOME(tab, id); tab->ents[i].id != id;
+         i = (i + 1) & mask)
+        if (!tab->ents[i].id)
+            return;
+    if (ptr && tab->ents[i].val.a_void != ptr)
+        return;
+    /* pull back any entry that can no longer be reached past slot i */
+    for (j = (i + 1) & mask; tab->ents[j].id; j = (j + 1) & mask) {
+        k = IDTAB_HOME(tab, tab->ents[j].id);
+        if ((i <= j) ? (k <= i || k > j) : (k <= i && k > j)) {
+            tab->ents[i] = tab->ents[j];
+            i = j;
+        }
+    }
+    tab->ents[i].id = 0;
+    tab->ents[i].val = zeroany;
+    tab->count--;
+}
+
+void
+idtab_clear(tab)
+struct id_table *tab;
+{
+    if (tab->ents)
+        free((genericptr_t) tab->ents);
+    tab->ents = (struct id_entry *) 0;
+    tab->size = tab->count = 0;
+}
+
+/*
+ * Fixed-size allocation pools.  Items are carved out of slabs of
+ * POOL_SLABITEMS; each item is preceded by a pointer back to its slab
+ * and freed items go onto their slab's free list.  Slabs are grouped
+ * into arenas--the caller passes the current level's ledger number--so
+ * that the things made on a level tend to share slabs, and when the
+ * level is freed on departure its slabs empty out and are handed back
+ * to free() whole instead of leaving scattered holes in the heap.
+ */
+#define POOL_SLABITEMS 64
+
+union pool_hdr {
+    struct pool_slab *slab; /* owning slab */
+    long l;                 /* alignment */
+    double d;
+};
+
+struct pool_slab {
+    struct pool_slab *next, *prev; /* arena's slabs which have room */
+    genericptr_t freelist;         /* free items, linked through 1st word */
+    int arena;
+    unsigned short nfree;
+    boolean listed; /* on its arena's list */
+    union pool_hdr items[1]; /* POOL_SLABITEMS items follow */
+};
+
+#define POOL_ITEM(slab, stride, i) \
+    ((union pool_hdr *) ((char *) (slab)->items + (i) * (stride)))
+
+STATIC_DCL void FDECL(pool_link, (struct nhpool *, struct pool_slab *));
+STATIC_DCL void FDECL(pool_unlink, (struct nhpool *, struct pool_slab *));
+
+STATIC_OVL void
+pool_link(pool, slab)
+struct nhpool *pool;
+struct pool_slab *slab;
+{
+    struct pool_slab **head = &pool->arenas[slab->arena];
+
+    slab->prev = (struct pool_slab *) 0;
+    slab->next = *head;
+    if (*head)
+        (*head)->prev = slab;
+    *head = slab;
+    slab->listed = TRUE;
+}
+
+STATIC_OVL void
+pool_unlink(pool, slab)
+struct nhpool *pool;
+struct pool_slab *slab;
+{
+    if (slab->prev)
+        slab->prev->next = slab->next;
+    else
+        pool->arenas[slab->arena] = slab->next;
+    if (slab->next)
+        slab->next->prev = slab->prev;
+    slab->next = slab->prev = (struct pool_slab *) 0;
+    slab->listed = FALSE;
+}
+
+genericptr_t
+pool_alloc(pool, arena)
+struct nhpool *pool;
+int arena;
+{
+    struct pool_slab *slab;
+    union pool_hdr *item;
+    int i;
+
+    if (!pool->stride) {
+        unsigned hsz = (unsigned) sizeof (union pool_hdr);
+
+        pool->stride = hsz + ((pool->size + hsz - 1) / hsz) * hsz;
+    }
+    if (arena < 0)
+        arena = 0;
+    if (arena >= pool->narenas) {
+        int n = pool->narenas ? pool->narenas : 16;
+        struct pool_slab **arenas;
+
+        while (n <= arena)
+            n *= 2;
+        arenas = (struct pool_slab **) alloc(n * sizeof *arenas);
+        for (i = 0; i < n; i++)
+            arenas[i] = (i < pool->narenas) ? pool->arenas[i]
+                                            : (struct pool_slab *) 0;
+        if (pool->arenas)
+            free((genericptr_t) pool->arenas);
+        pool->arenas = arenas;
+        pool->narenas = n;
+    }
+
+    if ((slab = pool->arenas[arena]) == 0) {
+        if ((slab = pool->spare) != 0) {
+            pool->spare = (struct pool_slab *) 0;
+        } else {
+            slab = (struct pool_slab *) alloc(
+                (unsigned) (sizeof (struct pool_slab)
+                            + POOL_SLABITEMS * pool->stride));
+            slab->freelist = (genericptr_t) 0;
+            for (i = POOL_SLABITEMS - 1; i >= 0; i--) {
+                item = POOL_ITEM(slab, pool->stride, i);
+                *(genericptr_t *) (item + 1) = slab->freelist;
+                slab->freelist = (genericptr_t) (item + 1);
+            }
+            slab->nfree = POOL_SLABITEMS;
+            pool->nslabs++;
+        }
+        slab->arena = arena;
+        pool_link(pool, slab);
+    }
+
+    item = (union pool_hdr *) slab->freelist - 1;
+    slab->freelist = *(genericptr_t *) slab->freelist;
+    item->slab = slab;
+    if (!--slab->nfree)
+        pool_unlink(pool, slab); /* full */
+    pool->nitems++;
+    return (genericptr_t) (item + 1);
+}
+
+void
+pool_free(pool, ptr)
+struct nhpool *pool;
+genericptr_t ptr;
+{
+    union pool_hdr *item = (union pool_hdr *) ptr - 1;
+    struct pool_slab *slab = item->slab;
+
+    *(genericptr_t *) ptr = slab->freelist;
+    slab->freelist = ptr;
+    pool->nitems--;
+    if (!slab->listed)
+        pool_link(pool, slab);
+    if (++slab->nfree == POOL_SLABITEMS) {
+        /* empty; keep one around to avoid thrashing at a slab boundary */
+        pool_unlink(pool, slab);
+        if (pool->spare) {
+            free((genericptr_t) slab);
+            pool->nslabs--;
+        } else {
+            pool->spare = slab;
+        }
+    }
+}
+
+/* release what an idle pool holds; items still in use are unaffected */
+void
+pool_trim(pool)
+struct nhpool *pool;
+{
+    if (pool->spare) {
+        free((genericptr_t) pool->spare);
+        pool->spare = (struct pool_slab *) 0;
+        pool->nslabs--;
+    }
+    if (!pool->nitems && pool->arenas) {
+        free((genericptr_t) pool->arenas);
+        pool->arenas = (struct pool_slab **) 0;
+        pool->narenas = 0;
+    }
+}
+
 /*
  * Time routines
  *
@@ -866,6 +1182,11 @@ setrandom()
     }
 #endif
 
+    /* game streams (rnd.c); any seeded from the command line are kept */
+    init_rng_streams(seed);
+    /* the remaining direct Rand() users follow the core stream's seed */
+    seed = rng_seed(RNG_CORE);
+
     /* the types are different enough here that sweeping the different
      * routine names into one via #defines is even more confusing
      */
@@ -12,6 +12,8 @@
 STATIC_DCL int FDECL(CFDECLSPEC sortloot_cmp, (const genericptr,
                                                const genericptr));
 STATIC_DCL void NDECL(reorder_invent);
+STATIC_DCL int FDECL(invidx_let, (CHAR_P));
+STATIC_DCL void NDECL(invidx_build);
 STATIC_DCL void FDECL(noarmor, (BOOLEAN_P));
 STATIC_DCL void FDECL(invdisp_nothing, (const char *, const char *));
 STATIC_DCL boolean FDECL(worn_wield_only, (struct obj *));
@@ -32,6 +34,7 @@ STATIC_DCL struct obj *FDECL(find_unpaid, (struct obj *, struct obj **));
 STATIC_DCL void FDECL(menu_identify, (int));
 STATIC_DCL boolean FDECL(tool_in_use, (struct obj *));
 STATIC_DCL char FDECL(obj_to_let, (struct obj *));
+STATIC_DCL boolean FDECL(invbatch_mergeable, (struct obj *));
 
 static int lastinvnr = 51; /* 0 ... 51 (never saved&restored) */
 
@@ -245,6 +248,8 @@ boolean by_nexthere; /* T: traverse via obj->nexthere, F: via obj->nobj */
         }
         *olist = sliarray[0].obj;
         free((genericptr_t) sliarray);
+        if (olist == &invent)
+            invent_changed();
     }
     sortlootmode = 0;
 }
@@ -263,18 +268,28 @@ register struct obj *otmp;
         return;
     }
 
-    for (i = 0; i < 52; i++)
-        inuse[i] = FALSE;
-    for (obj = invent; obj; obj = obj->nobj)
-        if (obj != otmp) {
-            i = obj->invlet;
-            if ('a' <= i && i <= 'z')
-                inuse[i - 'a'] = TRUE;
-            else if ('A' <= i && i <= 'Z')
-                inuse[i - 'A' + 26] = TRUE;
-            if (i == otmp->invlet)
-                otmp->invlet = 0;
+    if (otmp->where != OBJ_INVENT) {
+        /* the usual case, from addinv(); otmp can't be in the index */
+        for (i = 0; i < 52; i++) {
+            obj = invlet_to_obj((i < 26) ? 'a' + i : 'A' + i - 26);
+            inuse[i] = (obj != 0);
         }
+        if ((i = otmp->invlet) != 0 && (obj = invlet_to_obj((char) i)) != 0)
+            otmp->invlet = 0;
+    } else {
+        for (i = 0; i < 52; i++)
+            inuse[i] = FALSE;
+        for (obj = invent; obj; obj = obj->nobj)
+            if (obj != otmp) {
+                i = obj->invlet;
+                if ('a' <= i && i <= 'z')
+                    inuse[i - 'a'] = TRUE;
+                else if ('A' <= i && i <= 'Z')
+                    inuse[i - 'A' + 26] = TRUE;
+                if (i == otmp->invlet)
+                    otmp->invlet = 0;
+            }
+    }
     if ((i = otmp->invlet)
         && (('a' <= i && i <= 'z') || ('A' <= i && i <= 'Z')))
         return;
@@ -324,6 +339,7 @@ reorder_invent()
             }
         }
     } while (need_more_sorting);
+    invent_changed();
 }
 
 #undef inv_rank
@@ -543,6 +559,128 @@ struct obj *obj;
     }
 }
 
+/*
+ * Batched pickup and drop.  Picking up or dropping a long list of
+ * objects used to repeat the same bookkeeping for each one: total up
+ * the whole inventory's weight several times over, search the whole
+ * floor pile for a merge partner, redraw the map square and refresh
+ * the persistent inventory window.  Between begin_invbatch() and
+ * end_invbatch() the inventory weight is kept as a running total, a
+ * dropped object only looks for a merge partner when others of its
+ * type are on its square, and the map and inventory window are
+ * updated once at the end.  Every object still gets its messages,
+ * in the same order as before.
+ */
+static struct invbatch {
+    int depth;          /* begin_invbatch() nesting; 0 if not batching */
+    boolean keepwt;     /* keep a running inventory weight */
+    boolean wtknown;    /* wt is current */
+    int wt;             /* inventory weight, as inv_weight() counts it */
+    boolean invowed;    /* update_inventory() has been put off */
+    boolean symowed;    /* newsym(symx, symy) has been put off */
+    xchar symx, symy;
+    xchar floorx, floory; /* square counted in floorcnt[]; 0 if none */
+    /* objects of each type placed at floorx,floory; may be too high
+       (objects which have gone away are not subtracted) */
+    unsigned short floorcnt[NUM_OBJECTS];
+} invbatch;
+
+/* start a batch; keepwt if nothing but addinv() and freeinv() will
+   change the weight of the hero's inventory until end_invbatch() */
+void
+begin_invbatch(keepwt)
+boolean keepwt;
+{
+    if (invbatch.depth++)
+        return;
+    invbatch.keepwt = keepwt;
+    invbatch.wtknown = invbatch.invowed = invbatch.symowed = FALSE;
+    invbatch.floorx = 0;
+}
+
+void
+end_invbatch()
+{
+    if (invbatch.depth <= 0) {
+        impossible("end_invbatch: no batch in progress");
+        return;
+    }
+    if (--invbatch.depth)
+        return;
+    if (invbatch.symowed)
+        newsym(invbatch.symx, invbatch.symy);
+    if (invbatch.invowed)
+        update_inventory();
+    invbatch.wtknown = invbatch.invowed = invbatch.symowed = FALSE;
+    invbatch.floorx = 0;
+}
+
+/* inv_weight() asks for the running total */
+boolean
+invbatch_weight(wtp)
+int *wtp;
+{
+    if (!invbatch.depth || !invbatch.wtknown)
+        return FALSE;
+    *wtp = invbatch.wt;
+    return TRUE;
+}
+
+/* inv_weight() has counted it up the long way */
+void
+invbatch_setweight(wt)
+int wt;
+{
+    if (invbatch.depth && invbatch.keepwt) {
+        invbatch.wt = wt;
+        invbatch.wtknown = TRUE;
+    }
+}
+
+/* newsym(), put off until the end of the batch */
+void
+invbatch_newsym(x, y)
+int x, y;
+{
+    if (!invbatch.depth) {
+        newsym(x, y);
+        return;
+    }
+    if (invbatch.symowed && (x != invbatch.symx || y != invbatch.symy))
+        newsym(invbatch.symx, invbatch.symy);
+    invbatch.symowed = TRUE;
+    invbatch.symx = x, invbatch.symy = y;
+}
+
+/* place_object() has put obj on the floor */
+void
+invbatch_placed(obj)
+struct obj *obj;
+{
+    if (invbatch.depth && obj->ox == invbatch.floorx
+        && obj->oy == invbatch.floory)
+        invbatch.floorcnt[obj->otyp]++;
+}
+
+/* could stackobj() find something on obj's square to merge obj with? */
+STATIC_OVL boolean
+invbatch_mergeable(obj)
+struct obj *obj;
+{
+    struct obj *otmp;
+
+    if (obj->ox != invbatch.floorx || obj->oy != invbatch.floory) {
+        (void) memset((genericptr_t) invbatch.floorcnt, 0,
+                      sizeof invbatch.floorcnt);
+        for (otmp = level.objects[obj->ox][obj->oy]; otmp;
+             otmp = otmp->nexthere)
+            invbatch.floorcnt[otmp->otyp]++;
+        invbatch.floorx = obj->ox, invbatch.floory = obj->oy;
+    }
+    /* obj itself accounts for one */
+    return (boolean) (invbatch.floorcnt[obj->otyp] > 1);
+}
+
 /*
  * Add obj to the hero's inventory.  Make sure the object is "free".
  * Adjust hero attributes as necessary.
@@ -553,7 +691,9 @@ struct obj *obj;
 {
     struct obj *otmp, *prev;
     int saved_otyp = (int) obj->otyp; /* for panic */
-    boolean obj_was_thrown;
+    boolean obj_was_thrown, was_merged = TRUE;
+    int addwt = 0;
+    long addquan = obj->quan;
 
     if (obj->where != OBJ_FREE)
         panic("addinv: obj not free");
@@ -564,6 +704,12 @@ struct obj *obj;
         picked_container(obj); /* clear no_charge */
     obj_was_thrown = obj->was_thrown;
     obj->was_thrown = 0;       /* not meaningful for invent */
+    if (invbatch.depth && invbatch.wtknown) {
+        if (obj->globby) /* absorption recalculates weight */
+            invbatch.wtknown = FALSE;
+        else
+            addwt = inv_objweight(obj);
+    }
 
     addinv_core1(obj);
 
@@ -585,6 +731,7 @@ struct obj *obj;
             goto added;
         }
     /* didn't merge, so insert into chain */
+    was_merged = FALSE;
     assigninvlet(obj);
     if (flags.invlet_constant || !prev) {
         obj->nobj = invent; /* insert at beginning */
@@ -596,6 +743,7 @@ struct obj *obj;
         obj->nobj = 0;
     }
     obj->where = OBJ_INVENT;
+    invent_changed();
 
     /* fill empty quiver if obj was thrown */
     if (flags.pickup_thrown && !uquiver && obj_was_thrown
@@ -607,9 +755,19 @@ struct obj *obj;
         && (throwing_weapon(obj) || is_ammo(obj)))
         setuqwep(obj);
 added:
+    if (invbatch.depth && invbatch.wtknown) {
+        /* gold weight isn't additive */
+        if (was_merged && obj->oclass == COIN_CLASS)
+            addwt = inv_objweight(obj)
+                    - (int) ((obj->quan - addquan + 50L) / 100L);
+        invbatch.wt += addwt;
+    }
     addinv_core2(obj);
     carry_obj_effects(obj); /* carrying affects the obj */
-    update_inventory();
+    if (invbatch.depth)
+        invbatch.invowed = TRUE;
+    else
+        update_inventory();
     return obj;
 }
 
@@ -806,9 +964,14 @@ void
 freeinv(obj)
 register struct obj *obj;
 {
+    if (invbatch.depth && invbatch.wtknown)
+        invbatch.wt -= inv_objweight(obj);
     extract_nobj(obj, &invent);
     freeinv_core(obj);
-    update_inventory();
+    if (invbatch.depth)
+        invbatch.invowed = TRUE;
+    else
+        update_inventory();
 }
 
 void
@@ -861,6 +1024,12 @@ int x, y;
 {
     register struct obj *otmp;
 
+    /* the pile summary usually answers "no" without a walk */
+    if (!pile_has_class(x, y, objects[otyp].oc_class)
+        || (otyp == BOULDER && !pile_at(x, y)->boulders)
+        || (otyp == CORPSE && !pile_at(x, y)->corpses))
+        return (struct obj *) 0;
+
     for (otmp = level.objects[x][y]; otmp; otmp = otmp->nexthere)
         if (otmp->otyp == otyp)
             break;
@@ -887,16 +1056,152 @@ boolean by_nexthere;
     return otmp;
 }
 
+/*
+ * Inventory index.  For each inventory letter, the first object in
+ * invent using it; for each object type, the first object of that type
+ * and how many inventory stacks are of it.  carrying(), getobj()'s
+ * letter lookup and assigninvlet() consult it instead of walking invent.
+ *
+ * It is rebuilt from invent the first time it's needed after
+ * invent_changed(), which must be called whenever an object enters
+ * or leaves invent, the chain is reordered, or an inventory object's
+ * otyp or invlet is changed in place.  addinv(), extract_nobj(),
+ * splitobj() and replace_object() take care of the common cases.
+ */
+#define INVIDX_LETS 53 /* a-z, A-Z, $ */
+
+static struct invidx {
+    boolean valid;
+    struct obj *bylet[INVIDX_LETS];
+    struct obj *byotyp[NUM_OBJECTS];
+    short otypct[NUM_OBJECTS];
+    short usedotyps[64]; /* the byotyp[] and otypct[] entries in use */
+    int nusedotyps;      /* -1 if there were too many to list */
+} invidx;
+
+STATIC_OVL int
+invidx_let(let)
+char let;
+{
+    if (let >= 'a' && let <= 'z')
+        return let - 'a';
+    else if (let >= 'A' && let <= 'Z')
+        return let - 'A' + 26;
+    else if (let == GOLD_SYM)
+        return 52;
+    return -1;
+}
+
+void
+invent_changed()
+{
+    invidx.valid = FALSE;
+    status_dirty(BL_DIRTY_CAP | BL_DIRTY_SCORE);
+}
+
+STATIC_OVL void
+invidx_build()
+{
+    struct obj *otmp;
+    int i, typ;
+
+    if (invidx.valid)
+        return;
+    if (invidx.nusedotyps < 0) {
+        (void) memset((genericptr_t) invidx.byotyp, 0, sizeof invidx.byotyp);
+        (void) memset((genericptr_t) invidx.otypct, 0, sizeof invidx.otypct);
+    } else {
+        for (i = 0; i < invidx.nusedotyps; ++i) {
+            typ = invidx.usedotyps[i];
+            invidx.byotyp[typ] = (struct obj *) 0;
+            invidx.otypct[typ] = 0;
+        }
+    }
+    invidx.nusedotyps = 0;
+    for (i = 0; i < INVIDX_LETS; ++i)
+        invidx.bylet[i] = (struct obj *) 0;
+
+    for (otmp = invent; otmp; otmp = otmp->nobj) {
+        i = invidx_let(otmp->invlet);
+        if (i >= 0 && !invidx.bylet[i])
+            invidx.bylet[i] = otmp;
+        typ = otmp->otyp;
+        if (!invidx.otypct[typ]++) {
+            invidx.byotyp[typ] = otmp;
+            if (invidx.nusedotyps >= 0) {
+                if (invidx.nusedotyps < SIZE(invidx.usedotyps))
+                    invidx.usedotyps[invidx.nusedotyps++] = (short) typ;
+                else
+                    invidx.nusedotyps = -1;
+            }
+        }
+    }
+    invidx.valid = TRUE;
+}
+
+/* the first inventory object using letter let, if any */
+struct obj *
+invlet_to_obj(let)
+char let;
+{
+    struct obj *otmp;
+    int i = invidx_let(let);
+
+    if (i < 0) {
+        for (otmp = invent; otmp; otmp = otmp->nobj)
+            if (otmp->invlet == let)
+                return otmp;
+        return (struct obj *) 0;
+    }
+    invidx_build();
+    return invidx.bylet[i];
+}
+
+/* how many inventory stacks are of type otyp */
+int
+invent_otyp_count(otyp)
+int otyp;
+{
+    invidx_build();
+    return invidx.otypct[otyp];
+}
+
+/* compare the index with invent; for sanity_check() */
+void
+invent_index_sanity()
+{
+    struct obj *otmp;
+    int i;
+
+    if (!invidx.valid)
+        return;
+    for (otmp = invent; otmp; otmp = otmp->nobj) {
+        if ((i = invidx_let(otmp->invlet)) >= 0 && !invidx.bylet[i])
+            impossible("inventory index: '%c' missing", otmp->invlet);
+        if (!invidx.otypct[otmp->otyp])
+            impossible("inventory index: otyp %d missing", otmp->otyp);
+    }
+    for (i = 0; i < INVIDX_LETS; ++i)
+        if ((otmp = invidx.bylet[i]) != 0
+            && (otmp->where != OBJ_INVENT || invidx_let(otmp->invlet) != i))
+            impossible("inventory index: stale entry for '%c'",
+                       (i < 26) ? 'a' + i : (i < 52) ? 'A' + i - 26 : '$');
+    for (i = 0; i < invidx.nusedotyps; ++i)
+        if ((otmp = invidx.byotyp[invidx.usedotyps[i]]) != 0
+            && (otmp->where != OBJ_INVENT
+                || otmp->otyp != invidx.usedotyps[i]))
+            impossible("inventory index: stale entry for otyp %d",
+                       invidx.usedotyps[i]);
+}
+
 struct obj *
 carrying(type)
 register int type;
 {
-    register struct obj *otmp;
-
-    for (otmp = invent; otmp; otmp = otmp->nobj)
-        if (otmp->otyp == type)
-            return  otmp;
-    return (struct obj *) 0;
+    if (type < 0 || type >= NUM_OBJECTS)
+        return (struct obj *) 0;
+    invidx_build();
+    return invidx.byotyp[type];
 }
 
 /* Fictional and not-so-fictional currencies.
@@ -943,6 +1248,8 @@ have_lizard()
 {
     register struct obj *otmp;
 
+    if (!invent_otyp_count(CORPSE))
+        return FALSE;
     for (otmp = invent; otmp; otmp = otmp->nobj)
         if (otmp->otyp == CORPSE && otmp->corpsenm == PM_LIZARD)
             return  TRUE;
@@ -953,12 +1260,7 @@ have_lizard()
 struct obj *
 u_have_novel()
 {
-    register struct obj *otmp;
-
-    for (otmp = invent; otmp; otmp = otmp->nobj)
-        if (otmp->otyp == SPE_NOVEL)
-            return otmp;
-    return (struct obj *) 0;
+    return carrying(SPE_NOVEL);
 }
 
 struct obj *
@@ -997,6 +1299,8 @@ register int x, y;
 {
     register struct obj *obj = level.objects[x][y];
 
+    if (!pile_has_class(x, y, COIN_CLASS))
+        return (struct obj *) 0;
     while (obj) {
         if (obj->oclass == COIN_CLASS)
             return obj;
@@ -1408,9 +1712,7 @@ redo_menu:
             /* they typed a letter (not a space) at the prompt */
         }
         /* find the item which was picked */
-        for (otmp = invent; otmp; otmp = otmp->nobj)
-            if (otmp->invlet == ilet)
-                break;
+        otmp = invlet_to_obj(ilet);
         /* some items have restrictions */
         if (ilet == def_oc_syms[COIN_CLASS].sym
             /* guard against the [hypothetical] chace of having more
@@ -3143,6 +3445,8 @@ struct obj *obj;
 {
     struct obj *otmp;
 
+    if (invbatch.depth && !invbatch_mergeable(obj))
+        return;
     for (otmp = level.objects[obj->ox][obj->oy]; otmp; otmp = otmp->nexthere)
         if (otmp != obj && merged(&obj, &otmp))
             break;
@@ -3537,6 +3841,7 @@ reassign()
         goldobj->nobj = invent;
         invent = goldobj;
     }
+    invent_changed();
     if (i >= 52)
         i = 52 - 1;
     lastinvnr = i;
@@ -25,12 +25,11 @@
  * The major working function is do_light_sources(). It is called
  * when the vision system is recreating its "could see" array.  Here
  * we add a flag (TEMP_LIT) to the array for all locations that are lit
- * via a light source.  The bad part of this is that we have to
- * re-calculate the LOS of each light source every time the vision
- * system runs.  Even if the light sources and any topology (vision blocking
- * positions) have not changed.  The good part is that no extra memory
- * is used, plus we don't have to figure out how far the sources have moved,
- * or if the topology has changed.
+ * via a light source.  Each light source remembers the squares it lit
+ * last time, along with where it was, its range, and the vision
+ * system's clear/blocked generation; the LOS is only re-calculated
+ * when the source has moved or changed range, or some vision blocking
+ * position inside its circle has changed since then.
  *
  * The structure of the save/restore mechanism is amazingly similar to
  * the timer save/restore.  This is because they both have the same
@@ -42,8 +41,23 @@
 #define LSF_SHOW 0x1        /* display the light source */
 #define LSF_NEEDS_FIXUP 0x2 /* need oid fixup */
 
+/*
+ * A light source plus its cached map.  Only the light_source part is
+ * saved; a restored source starts out with no map.  Bit dx of lit[dy]
+ * is set if (x - range + dx, y - range + dy) was lit.
+ */
+struct ls_node {
+    light_source ls; /* must be first */
+    xchar cx, cy;    /* where the map was computed */
+    short crange;
+    unsigned long cgen; /* vision_clear_gen() then; 0 if no map */
+    unsigned long lit[2 * MAX_RADIUS + 1];
+};
+
 static light_source *light_base = 0;
 
+STATIC_DCL light_source *NDECL(alloc_ls);
+STATIC_DCL void FDECL(light_map, (struct ls_node *));
 STATIC_DCL void FDECL(write_ls, (int, light_source *));
 STATIC_DCL int FDECL(maybe_write_ls, (int, int, BOOLEAN_P));
 
@@ -65,7 +79,7 @@ anything *id;
         return;
     }
 
-    ls = (light_source *) alloc(sizeof(light_source));
+    ls = alloc_ls();
 
     ls->next = light_base;
     ls->x = x;
@@ -126,6 +140,60 @@ anything *id;
                fmt_ptr((genericptr_t) id->a_obj));
 }
 
+/* a new light source, with no cached map */
+STATIC_OVL light_source *
+alloc_ls()
+{
+    struct ls_node *node;
+
+    node = (struct ls_node *) alloc(sizeof (struct ls_node));
+    (void) memset((genericptr_t) node, 0, sizeof (struct ls_node));
+    return &node->ls;
+}
+
+/* recompute the cached map of a light source that isn't at the hero */
+STATIC_OVL void
+light_map(node)
+struct ls_node *node;
+{
+    light_source *ls = &node->ls;
+    int x, y, min_x, max_x, max_y, offset;
+    unsigned long bits;
+    char *limits;
+
+    /*
+     * Walk the points in the circle and see if they are
+     * visible from the center.  If so, mark'em.
+     *
+     * Kevin's tests indicated that doing this brute-force
+     * method is faster for radius <= 3 (or so).
+     */
+    (void) memset((genericptr_t) node->lit, 0, sizeof node->lit);
+    limits = circle_ptr(ls->range);
+    if ((max_y = (ls->y + ls->range)) >= ROWNO)
+        max_y = ROWNO - 1;
+    if ((y = (ls->y - ls->range)) < 0)
+        y = 0;
+    for (; y <= max_y; y++) {
+        offset = limits[abs(y - ls->y)];
+        if ((min_x = (ls->x - offset)) < 0)
+            min_x = 0;
+        if ((max_x = (ls->x + offset)) >= COLNO)
+            max_x = COLNO - 1;
+
+        bits = 0L;
+        for (x = min_x; x <= max_x; x++)
+            if ((ls->x == x && ls->y == y)
+                || clear_path((int) ls->x, (int) ls->y, x, y))
+                bits |= 1L << (x - ls->x + ls->range);
+        node->lit[y - ls->y + ls->range] = bits;
+    }
+    node->cx = ls->x;
+    node->cy = ls->y;
+    node->crange = ls->range;
+    node->cgen = vision_clear_gen();
+}
+
 /* Mark locations that are temporarily lit via mobile light sources. */
 void
 do_light_sources(cs_rows)
@@ -135,16 +203,18 @@ char **cs_rows;
     char *limits;
     short at_hero_range = 0;
     light_source *ls;
+    struct ls_node *node;
+    unsigned long bits;
     char *row;
 
+    PERF_START(PERF_LIGHTS);
     for (ls = light_base; ls; ls = ls->next) {
         ls->flags &= ~LSF_SHOW;
 
         /*
-         * Check for moved light sources.  It may be possible to
-         * save some effort if an object has not moved, but not in
-         * the current setup -- we need to recalculate for every
-         * vision recalc.
+         * Check for moved light sources.  The lit squares are only
+         * recalculated below if the source has moved or something
+         * around it has started or stopped blocking light.
          */
         if (ls->type == LS_OBJECT) {
             if (get_obj_location(ls->id.a_obj, &ls->x, &ls->y, 0))
@@ -163,13 +233,20 @@ char **cs_rows;
                 at_hero_range = ls->range;
         }
 
-        if (ls->flags & LSF_SHOW) {
+        if (!(ls->flags & LSF_SHOW))
+            continue;
+
+        if (ls->x == u.ux && ls->y == u.uy) {
             /*
-             * Walk the points in the circle and see if they are
-             * visible from the center.  If so, mark'em.
-             *
-             * Kevin's tests indicated that doing this brute-force
-             * method is faster for radius <= 3 (or so).
+             * If the light source is located at the hero, then
+             * we can use the COULD_SEE bits already calculated
+             * by the vision system.  More importantly than
+             * this optimization, is that it allows the vision
+             * system to correct problems with clear_path().
+             * The function clear_path() is a simple LOS
+             * path checker that doesn't go out of its way
+             * make things look "correct".  The vision system
+             * does this.
              */
             limits = circle_ptr(ls->range);
             if ((max_y = (ls->y + ls->range)) >= ROWNO)
@@ -183,31 +260,34 @@ char **cs_rows;
                     min_x = 0;
                 if ((max_x = (ls->x + offset)) >= COLNO)
                     max_x = COLNO - 1;
-
-                if (ls->x == u.ux && ls->y == u.uy) {
-                    /*
-                     * If the light source is located at the hero, then
-                     * we can use the COULD_SEE bits already calculated
-                     * by the vision system.  More importantly than
-                     * this optimization, is that it allows the vision
-                     * system to correct problems with clear_path().
-                     * The function clear_path() is a simple LOS
-                     * path checker that doesn't go out of its way
-                     * make things look "correct".  The vision system
-                     * does this.
-                     */
-                    for (x = min_x; x <= max_x; x++)
-                        if (row[x] & COULD_SEE)
-                            row[x] |= TEMP_LIT;
-                } else {
-                    for (x = min_x; x <= max_x; x++)
-                        if ((ls->x == x && ls->y == y)
-                            || clear_path((int) ls->x, (int) ls->y, x, y))
-                            row[x] |= TEMP_LIT;
-                }
+                for (x = min_x; x <= max_x; x++)
+                    if (row[x] & COULD_SEE)
+                        row[x] |= TEMP_LIT;
             }
+            continue;
+        }
+
+        node = (struct ls_node *) ls;
+        if (!node->cgen || node->cx != ls->x || node->cy != ls->y
+            || node->crange != ls->range
+            || vision_clear_changed(node->cgen, ls->x - ls->range,
+                                    ls->y - ls->range, ls->x + ls->range,
+                                    ls->y + ls->range))
+            light_map(node);
+
+        if ((max_y = (ls->y + ls->range)) >= ROWNO)
+            max_y = ROWNO - 1;
+        if ((y = (ls->y - ls->range)) < 0)
+            y = 0;
+        for (; y <= max_y; y++) {
+            row = cs_rows[y];
+            bits = node->lit[y - ls->y + ls->range];
+            for (x = ls->x - ls->range; bits; x++, bits >>= 1)
+                if (bits & 1L)
+                    row[x] |= TEMP_LIT;
         }
     }
+    PERF_STOP(PERF_LIGHTS);
 }
 
 /* (mon->mx == 0) implies migrating */
@@ -222,6 +302,19 @@ unsigned fmflags;
 
     if (!nid)
         return &youmonst;
+    if ((mtmp = mon_by_id(nid)) != 0) {
+        /* monsters on the map are on fmon; the ones with no location
+           are on migrating_mons or mydogs */
+        if (mtmp->mx)
+            return ((fmflags & FM_FMON) && !DEADMONSTER(mtmp))
+                       ? mtmp : (struct monst *) 0;
+        if ((fmflags & (FM_MIGRATE | FM_MYDOGS))
+            == (FM_MIGRATE | FM_MYDOGS))
+            return mtmp;
+    } else {
+        return (struct monst *) 0;
+    }
+    /* only one of migrating_mons and mydogs is wanted; check which */
     if (fmflags & FM_FMON)
         for (mtmp = fmon; mtmp; mtmp = mtmp->nmon)
             if (!DEADMONSTER(mtmp) && mtmp->m_id == nid)
@@ -299,7 +392,7 @@ int fd;
     mread(fd, (genericptr_t) &count, sizeof count);
 
     while (count-- > 0) {
-        ls = (light_source *) alloc(sizeof(light_source));
+        ls = alloc_ls();
         mread(fd, (genericptr_t) ls, sizeof(light_source));
         ls->next = light_base;
         light_base = ls;
@@ -315,11 +408,11 @@ long *count, *size;
 {
     light_source *ls;
 
-    Sprintf(hdrbuf, hdrfmt, (long) sizeof (light_source));
+    Sprintf(hdrbuf, hdrfmt, (long) sizeof (struct ls_node));
     *count = *size = 0L;
     for (ls = light_base; ls; ls = ls->next) {
         ++*count;
-        *size += (long) sizeof *ls;
+        *size += (long) sizeof (struct ls_node);
     }
 }
 
@@ -560,7 +653,7 @@ struct obj *src, *dest;
              * never interfere us walking down the list - we are already
              * past the insertion point.
              */
-            new_ls = (light_source *) alloc(sizeof(light_source));
+            new_ls = alloc_ls();
             *new_ls = *ls;
             if (Is_candle(src)) {
                 /* split candles may emit less light than original group */
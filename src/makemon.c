@@ -32,6 +32,45 @@ extern const int monstr[];
 #define toostrong(monindx, lev) (monstr[monindx] > lev)
 #define tooweak(monindx, lev) (monstr[monindx] < lev)
 
+/* m_id -> monst for every monster on fmon, migrating_mons or mydogs
+   (and dead ones not yet released by dmonsfree()) */
+static struct id_table mon_ids;
+
+/* make mon findable by its current m_id; replaces any earlier monster
+   with the same id (replmon()) */
+void
+mon_id_register(mon)
+struct monst *mon;
+{
+    anything val;
+
+    val = zeroany;
+    val.a_monst = mon;
+    idtab_add(&mon_ids, mon->m_id, &val);
+}
+
+void
+mon_id_unregister(mon)
+struct monst *mon;
+{
+    idtab_del(&mon_ids, mon->m_id, (genericptr_t) mon);
+}
+
+struct monst *
+mon_by_id(id)
+unsigned id;
+{
+    anything *val = idtab_find(&mon_ids, id);
+
+    return val ? val->a_monst : (struct monst *) 0;
+}
+
+void
+free_mon_ids()
+{
+    idtab_clear(&mon_ids);
+}
+
 boolean
 is_home_elemental(ptr)
 struct permonst *ptr;
@@ -823,6 +862,7 @@ xchar x, y; /* clone's preferred location or 0 (near mon) */
     m2->m_id = context.ident++;
     if (!m2->m_id)
         m2->m_id = context.ident++; /* ident overflowed */
+    mon_id_register(m2);
     m2->mx = mm.x;
     m2->my = mm.y;
 
@@ -999,7 +1039,8 @@ newmextra()
 {
     struct mextra *mextra;
 
-    mextra = (struct mextra *) alloc(sizeof(struct mextra));
+    mextra = (struct mextra *) pool_alloc(&mextra_pool,
+                                          (int) ledger_no(&u.uz));
     mextra->mname = 0;
     mextra->egd = 0;
     mextra->epri = 0;
@@ -1183,6 +1224,7 @@ int mmflags;
     mtmp->m_id = context.ident++;
     if (!mtmp->m_id)
         mtmp->m_id = context.ident++; /* ident overflowed */
+    mon_id_register(mtmp);
     set_mon_data(mtmp, ptr, 0);
     if (ptr->msound == MS_LEADER && quest_info(MS_LEADER) == mndx)
         quest_status.leader_m_id = mtmp->m_id;
@@ -57,17 +57,41 @@ static const int explcolors[] = {
 #define is_objpile(x,y) (!Hallucination && level.objects[(x)][(y)] \
                          && level.objects[(x)][(y)]->nexthere)
 
-/*ARGSUSED*/
-int
-mapglyph(glyph, ochar, ocolor, ospecial, x, y)
-int glyph, *ocolor, x, y;
-int *ochar;
-unsigned *ospecial;
+/*
+ * mapglyph() is called for every map cell a window port draws, so the
+ * parts of its answer that don't depend on the location are worked out
+ * once per glyph and kept in glyphmap[].  The table is rebuilt on the
+ * next call whenever the symbols are reloaded (drawing.c bumps
+ * showsyms_gen) or reset_glyphmap() has been called because object
+ * colors (shuffled along with their descriptions), use_color or the
+ * colors the terminal has changed.  The location-dependent parts
+ * (object piles and the hero's color) are still checked on each call.
+ */
+struct glyphmap {
+    short idx;        /* index into showsyms[] */
+    schar color;      /* final color, or NO_COLOR */
+    boolean pileable; /* can get MG_OBJPILE */
+    unsigned special; /* MG_xxx flags */
+};
+
+static struct glyphmap glyphmap[MAX_GLYPH];
+static boolean glyphmap_valid = FALSE;
+static unsigned glyphmap_gen;        /* showsyms_gen when built */
+static boolean glyphmap_rogue_color; /* has_rogue_color when built */
+
+STATIC_DCL void FDECL(glyph_decode, (int, struct glyphmap *));
+STATIC_DCL void NDECL(build_glyphmap);
+
+/* map one glyph back to a symbol index, color and special flags */
+STATIC_OVL void
+glyph_decode(glyph, gm)
+int glyph;
+struct glyphmap *gm;
 {
     register int offset, idx;
     int color = NO_COLOR;
-    nhsym ch;
     unsigned special = 0;
+    boolean pileable = FALSE;
     /* condense multiple tests in macro version down to single */
     boolean has_rogue_ibm_graphics = HAS_ROGUE_IBM_GRAPHICS;
     boolean has_rogue_color = (has_rogue_ibm_graphics
@@ -86,8 +110,7 @@ unsigned *ospecial;
         else
             obj_color(STATUE);
         special |= MG_STATUE;
-        if (is_objpile(x,y))
-            special |= MG_OBJPILE;
+        pileable = TRUE;
     } else if ((offset = (glyph - GLYPH_WARNING_OFF)) >= 0) { /* warn flash */
         idx = offset + SYM_OFF_W;
         if (has_rogue_color)
@@ -159,8 +182,8 @@ unsigned *ospecial;
             }
         } else
             obj_color(offset);
-        if (offset != BOULDER && is_objpile(x,y))
-            special |= MG_OBJPILE;
+        if (offset != BOULDER)
+            pileable = TRUE;
     } else if ((offset = (glyph - GLYPH_RIDDEN_OFF)) >= 0) { /* mon ridden */
         idx = mons[offset].mlet + SYM_OFF_M;
         if (has_rogue_color)
@@ -178,8 +201,7 @@ unsigned *ospecial;
         else
             mon_color(offset);
         special |= MG_CORPSE;
-        if (is_objpile(x,y))
-            special |= MG_OBJPILE;
+        pileable = TRUE;
     } else if ((offset = (glyph - GLYPH_DETECT_OFF)) >= 0) { /* mon detect */
         idx = mons[offset].mlet + SYM_OFF_M;
         if (has_rogue_color)
@@ -203,40 +225,89 @@ unsigned *ospecial;
         else
             pet_color(offset);
         special |= MG_PET;
-    } else { /* a monster */
+    } else { /* a monster; the hero is handled by mapglyph() */
         idx = mons[glyph].mlet + SYM_OFF_M;
-        if (has_rogue_color && iflags.use_color) {
-            if (x == u.ux && y == u.uy)
-                /* actually player should be yellow-on-gray if in corridor */
-                color = CLR_YELLOW;
-            else
-                color = NO_COLOR;
-        } else {
+        if (has_rogue_color && iflags.use_color)
+            color = NO_COLOR;
+        else
             mon_color(glyph);
+    }
+
 #ifdef TEXTCOLOR
-            /* special case the hero for `showrace' option */
-            if (iflags.use_color && x == u.ux && y == u.uy
-                && flags.showrace && !Upolyd)
-                color = HI_DOMESTIC;
+    /* Turn off color if no color defined. */
+    if (!has_color(color))
+        color = NO_COLOR;
 #endif
-        }
-    }
+    gm->idx = (short) idx;
+    gm->color = (schar) color;
+    gm->pileable = pileable;
+    gm->special = special;
+}
+
+STATIC_OVL void
+build_glyphmap()
+{
+    int glyph;
+
+    for (glyph = 0; glyph < MAX_GLYPH; glyph++)
+        glyph_decode(glyph, &glyphmap[glyph]);
+    glyphmap_gen = showsyms_gen;
+    glyphmap_rogue_color = (HAS_ROGUE_IBM_GRAPHICS
+                            && symset[currentgraphics].nocolor == 0);
+    glyphmap_valid = TRUE;
+}
+
+/* symbols, object colors or color options have changed */
+void
+reset_glyphmap()
+{
+    glyphmap_valid = FALSE;
+}
+
+/*ARGSUSED*/
+int
+mapglyph(glyph, ochar, ocolor, ospecial, x, y)
+int glyph, *ocolor, x, y;
+int *ochar;
+unsigned *ospecial;
+{
+    register const struct glyphmap *gm;
+    int color;
+    unsigned special;
+
+    if (!glyphmap_valid || glyphmap_gen != showsyms_gen)
+        build_glyphmap();
+    gm = &glyphmap[glyph];
+    color = gm->color;
+    special = gm->special;
+    if (gm->pileable && is_objpile(x, y))
+        special |= MG_OBJPILE;
 
-    ch = showsyms[idx];
 #ifdef TEXTCOLOR
-    /* Turn off color if no color defined, or rogue level w/o PC graphics. */
-    if (!has_color(color) || (Is_rogue_level(&u.uz) && !has_rogue_color))
+    if (glyph < GLYPH_PET_OFF && x == u.ux && y == u.uy
+        && iflags.use_color) {
+        if (glyphmap_rogue_color)
+            /* actually player should be yellow-on-gray if in corridor */
+            color = CLR_YELLOW;
+        /* special case the hero for `showrace' option */
+        else if (flags.showrace && !Upolyd)
+            color = HI_DOMESTIC;
+        if (!has_color(color))
+            color = NO_COLOR;
+    }
+    /* Turn off color on the rogue level w/o PC graphics. */
+    if (Is_rogue_level(&u.uz) && !glyphmap_rogue_color)
         color = NO_COLOR;
 #endif
 
-    *ochar = (int) ch;
+    *ochar = (int) showsyms[gm->idx];
     *ospecial = special;
 #ifdef TEXTCOLOR
     *ocolor = color;
 #else
     nhUse(ocolor);
 #endif
-    return idx;
+    return gm->idx;
 }
 
 char *
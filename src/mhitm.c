@@ -16,6 +16,7 @@ static const char brief_feeling[] =
     "have a %s feeling for a moment, then it passes.";
 
 STATIC_DCL char *FDECL(mon_nam_too, (char *, struct monst *, struct monst *));
+STATIC_DCL int FDECL(mattackm_core, (struct monst *, struct monst *));
 STATIC_DCL int FDECL(hitmm, (struct monst *, struct monst *,
                              struct attack *));
 STATIC_DCL int FDECL(gazemm, (struct monst *, struct monst *,
@@ -291,6 +292,17 @@ boolean quietly;
 int
 mattackm(magr, mdef)
 register struct monst *magr, *mdef;
+{
+    int oldrng = rng_select(RNG_COMBAT), res;
+
+    res = mattackm_core(magr, mdef);
+    (void) rng_select(oldrng);
+    return res;
+}
+
+STATIC_OVL int
+mattackm_core(magr, mdef)
+register struct monst *magr, *mdef;
 {
     int i,          /* loop counter */
         tmp,        /* amour class difference */
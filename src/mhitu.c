@@ -9,6 +9,7 @@
 STATIC_VAR NEARDATA struct obj *mon_currwep = (struct obj *) 0;
 
 STATIC_DCL boolean FDECL(u_slip_free, (struct monst *, struct attack *));
+STATIC_DCL int FDECL(mattacku_core, (struct monst *));
 STATIC_DCL int FDECL(passiveum, (struct permonst *, struct monst *,
                                  struct attack *));
 STATIC_DCL void FDECL(mayberem, (struct obj *, const char *));
@@ -346,6 +347,17 @@ struct attack *alt_attk_buf;
 int
 mattacku(mtmp)
 register struct monst *mtmp;
+{
+    int oldrng = rng_select(RNG_COMBAT), res;
+
+    res = mattacku_core(mtmp);
+    (void) rng_select(oldrng);
+    return res;
+}
+
+STATIC_OVL int
+mattacku_core(mtmp)
+register struct monst *mtmp;
 {
     struct attack *mattk, alt_attk;
     int i, j = 0, tmp, sum[NATTK];
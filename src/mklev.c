@@ -598,6 +598,7 @@ clear_level_structures()
             level.monsters[x][y] = (struct monst *) 0;
         }
     }
+    (void) memset((genericptr_t) level.piles, 0, sizeof level.piles);
     level.objlist = (struct obj *) 0;
     level.buriedobjlist = (struct obj *) 0;
     level.monlist = (struct monst *) 0;
@@ -981,11 +982,14 @@ void
 mklev()
 {
     struct mkroom *croom;
-    int ridx;
+    int ridx, oldrng;
 
     init_mapseen(&u.uz);
-    if (getbones())
+    oldrng = rng_select(RNG_LEVGEN);
+    if (getbones()) {
+        (void) rng_select(oldrng);
         return;
+    }
 
     in_mklev = TRUE;
     makelevel();
@@ -1010,6 +1014,7 @@ mklev()
        entered; rooms[].orig_rtype always retains original rtype value */
     for (ridx = 0; ridx < SIZE(rooms); ridx++)
         rooms[ridx].orig_rtype = rooms[ridx].rtype;
+    (void) rng_select(oldrng);
 }
 
 void
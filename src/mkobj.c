@@ -10,6 +10,8 @@ STATIC_DCL void FDECL(maybe_adjust_light, (struct obj *, int));
 STATIC_DCL void FDECL(obj_timer_checks, (struct obj *,
                                          XCHAR_P, XCHAR_P, int));
 STATIC_DCL void FDECL(container_weight, (struct obj *));
+STATIC_DCL void FDECL(pile_add, (struct obj *, struct objpile *));
+STATIC_DCL void FDECL(pile_del, (struct obj *, int, int));
 STATIC_DCL struct obj *FDECL(save_mtraits, (struct obj *, struct monst *));
 STATIC_DCL void FDECL(objlist_sanity, (struct obj *, int, const char *));
 STATIC_DCL void FDECL(mon_obj_sanity, (struct monst *, const char *));
@@ -65,12 +67,44 @@ static const struct icp hellprobs[] = { { 20, WEAPON_CLASS },
                                         { 8, RING_CLASS },
                                         { 4, AMULET_CLASS } };
 
+/* o_id -> obj for every object in memory, including ones on billobjs
+   and free ones; find_oid() decides which of them count */
+static struct id_table obj_ids;
+
+/* make obj findable by its current o_id; done whenever one is assigned */
+void
+obj_id_register(obj)
+struct obj *obj;
+{
+    anything val;
+
+    val = zeroany;
+    val.a_obj = obj;
+    idtab_add(&obj_ids, obj->o_id, &val);
+}
+
+struct obj *
+obj_by_id(id)
+unsigned id;
+{
+    anything *val = idtab_find(&obj_ids, id);
+
+    return val ? val->a_obj : (struct obj *) 0;
+}
+
+void
+free_obj_ids()
+{
+    idtab_clear(&obj_ids);
+}
+
 struct oextra *
 newoextra()
 {
     struct oextra *oextra;
 
-    oextra = (struct oextra *) alloc(sizeof(struct oextra));
+    oextra = (struct oextra *) pool_alloc(&oextra_pool,
+                                          (int) ledger_no(&u.uz));
     oextra->oname = 0;
     oextra->omonst = 0;
     oextra->omid = 0;
@@ -97,7 +131,7 @@ struct obj *o;
         if (x->omailcmd)
             free((genericptr_t) x->omailcmd);
 
-        free((genericptr_t) x);
+        pool_free(&oextra_pool, (genericptr_t) x);
         o->oextra = (struct oextra *) 0;
     }
 }
@@ -127,7 +161,7 @@ struct obj *otmp;
         if (m) {
             if (m->mextra)
                 dealloc_mextra(m);
-            free((genericptr_t) m);
+            pool_free(&monst_pool, (genericptr_t) m);
             OMONST(otmp) = (struct monst *) 0;
         }
     }
@@ -422,6 +456,7 @@ long num;
     otmp->o_id = context.ident++;
     if (!otmp->o_id)
         otmp->o_id = context.ident++; /* ident overflowed */
+    obj_id_register(otmp);
     otmp->timed = 0;                  /* not timed, yet */
     otmp->lamplit = 0;                /* ditto */
     otmp->owornmask = 0L;             /* new object isn't worn */
@@ -433,10 +468,14 @@ long num;
     context.objsplit.parent_oid = obj->o_id;
     context.objsplit.child_oid = otmp->o_id;
     obj->nobj = otmp;
+    if (obj->where == OBJ_INVENT)
+        invent_changed();
     /* Only set nexthere when on the floor, nexthere is also used */
     /* as a back pointer to the container object when contained. */
-    if (obj->where == OBJ_FLOOR)
+    if (obj->where == OBJ_FLOOR) {
         obj->nexthere = otmp;
+        pile_add(otmp, pile_at(obj->ox, obj->oy));
+    }
     copy_oextra(otmp, obj);
     if (has_omid(otmp))
         free_omid(otmp); /* only one association with m_id*/
@@ -573,6 +612,8 @@ struct obj *otmp;
         obj->nexthere = otmp;
         extract_nobj(obj, &fobj);
         extract_nexthere(obj, &level.objects[obj->ox][obj->oy]);
+        pile_add(otmp, pile_at(otmp->ox, otmp->oy));
+        pile_del(obj, obj->ox, obj->oy);
         break;
     default:
         panic("replace_object: obj position");
@@ -629,6 +670,7 @@ register struct obj *otmp;
     dummy->o_id = context.ident++;
     if (!dummy->o_id)
         dummy->o_id = context.ident++; /* ident overflowed */
+    obj_id_register(dummy);
     dummy->timed = 0;
     copy_oextra(dummy, otmp);
     if (has_omid(dummy))
@@ -748,6 +790,7 @@ boolean artif;
     otmp->o_id = context.ident++;
     if (!otmp->o_id)
         otmp->o_id = context.ident++; /* ident overflowed */
+    obj_id_register(otmp);
     otmp->quan = 1L;
     otmp->oclass = let;
     otmp->otyp = otyp;
@@ -1708,6 +1751,8 @@ int x, y;
     /* set the new object's location */
     otmp->ox = x;
     otmp->oy = y;
+    pile_add(otmp, pile_at(x, y));
+    invbatch_placed(otmp);
 
     otmp->where = OBJ_FLOOR;
 
@@ -1848,13 +1893,62 @@ register struct obj *otmp;
         panic("remove_object: obj not on floor");
     extract_nexthere(otmp, &level.objects[x][y]);
     extract_nobj(otmp, &fobj);
+    pile_del(otmp, x, y);
     /* update vision iff this was the only boulder at its spot */
-    if (otmp->otyp == BOULDER && !sobj_at(BOULDER, x, y))
+    if (otmp->otyp == BOULDER && !pile_at(x, y)->boulders)
         unblock_point(x, y); /* vision */
     if (otmp->timed)
         obj_timer_checks(otmp, x, y, 0);
 }
 
+/* count an object which has just joined the pile at some spot */
+STATIC_OVL void
+pile_add(otmp, pile)
+struct obj *otmp;
+struct objpile *pile;
+{
+    pile->count++;
+    pile->classes |= 1L << otmp->oclass;
+    if (otmp->otyp == BOULDER)
+        pile->boulders++;
+    else if (otmp->otyp == CORPSE)
+        pile->corpses++;
+    else if (Is_container(otmp))
+        pile->containers++;
+}
+
+/* uncount an object which has just been taken out of the pile at <x,y> */
+STATIC_OVL void
+pile_del(otmp, x, y)
+struct obj *otmp;
+int x, y;
+{
+    struct objpile *pile = pile_at(x, y);
+    struct obj *obj;
+
+    if (!pile->count) {
+        impossible("pile_del: no objects at <%d,%d>?", x, y);
+        return;
+    }
+    pile->count--;
+    if (otmp->otyp == BOULDER) {
+        if (pile->boulders)
+            pile->boulders--;
+    } else if (otmp->otyp == CORPSE) {
+        if (pile->corpses)
+            pile->corpses--;
+    } else if (Is_container(otmp)) {
+        if (pile->containers)
+            pile->containers--;
+    }
+    /* the class is still present if anything left here shares it;
+       in a mixed pile that is usually found within a few objects */
+    for (obj = level.objects[x][y]; obj; obj = obj->nexthere)
+        if (obj->oclass == otmp->oclass)
+            return;
+    pile->classes &= ~(1L << otmp->oclass);
+}
+
 /* throw away all of a monster's inventory */
 void
 discard_minvent(mtmp)
@@ -1948,6 +2042,8 @@ struct obj *obj, **head_ptr;
     }
     if (!curr)
         panic("extract_nobj: object lost");
+    if (head_ptr == &invent)
+        invent_changed();
     obj->where = OBJ_FREE;
     obj->nobj = NULL;
 }
@@ -2107,7 +2203,8 @@ struct obj *obj;
 
     if (obj->oextra)
         dealloc_oextra(obj);
-    free((genericptr_t) obj);
+    idtab_del(&obj_ids, obj->o_id, (genericptr_t) obj);
+    pool_free(&obj_pool, (genericptr_t) obj);
 }
 
 /* create an object from a horn of plenty; mirrors bagotricks(makemon.c) */
@@ -2224,7 +2321,24 @@ obj_sanity_check()
                 }
             }
 
+    /* check that each square's pile summary matches its objects */
+    for (x = 0; x < COLNO; x++)
+        for (y = 0; y < ROWNO; y++) {
+            struct objpile chk, *pile = pile_at(x, y);
+
+            chk.count = chk.boulders = chk.containers = chk.corpses = 0;
+            chk.classes = 0L;
+            for (obj = level.objects[x][y]; obj; obj = obj->nexthere)
+                pile_add(obj, &chk);
+            if (chk.count != pile->count || chk.boulders != pile->boulders
+                || chk.containers != pile->containers
+                || chk.corpses != pile->corpses
+                || chk.classes != pile->classes)
+                impossible("pile summary sanity at <%d,%d>", x, y);
+        }
+
     objlist_sanity(invent, OBJ_INVENT, "invent sanity");
+    invent_index_sanity();
     objlist_sanity(migrating_objs, OBJ_MIGRATING, "migrating sanity");
     objlist_sanity(level.buriedobjlist, OBJ_BURIED, "buried sanity");
     objlist_sanity(billobjs, OBJ_ONBILL, "bill sanity");
@@ -679,6 +679,7 @@ movemon()
 {
     register struct monst *mtmp, *nmtmp;
     register boolean somebody_can_move = FALSE;
+    int oldrng, res;
 
     /*
      * Some of you may remember the former assertion here that
@@ -770,7 +771,10 @@ movemon()
                 && fightm(mtmp))
                 continue; /* mon might have died */
         }
-        if (dochugw(mtmp)) /* otherwise just move the monster */
+        oldrng = rng_select(RNG_AI);
+        res = dochugw(mtmp); /* otherwise just move the monster */
+        (void) rng_select(oldrng);
+        if (res)
             continue;
     }
 
@@ -1588,6 +1592,7 @@ struct monst *mtmp, *mtmp2;
     }
     mtmp2->nmon = fmon;
     fmon = mtmp2;
+    mon_id_register(mtmp2); /* takes over mtmp's entry if ids match */
     if (u.ustuck == mtmp)
         u.ustuck = mtmp2;
     if (u.usteed == mtmp)
@@ -1677,6 +1682,8 @@ struct monst *mtmp2, *mtmp1;
     if (ESHK(mtmp1)) {
         if (!ESHK(mtmp2))
             neweshk(mtmp2);
+        else
+            forget_bill_index(ESHK(mtmp2));
         *ESHK(mtmp2) = *ESHK(mtmp1);
     }
     if (EMIN(mtmp1)) {
@@ -1706,15 +1713,17 @@ struct monst *m;
             free((genericptr_t) x->egd);
         if (x->epri)
             free((genericptr_t) x->epri);
-        if (x->eshk)
+        if (x->eshk) {
+            forget_bill_index(x->eshk);
             free((genericptr_t) x->eshk);
+        }
         if (x->emin)
             free((genericptr_t) x->emin);
         if (x->edog)
             free((genericptr_t) x->edog);
         /* [no action needed for x->mcorpsenm] */
 
-        free((genericptr_t) x);
+        pool_free(&mextra_pool, (genericptr_t) x);
         m->mextra = (struct mextra *) 0;
     }
 }
@@ -1727,7 +1736,8 @@ struct monst *mon;
         panic("dealloc_monst with nmon");
     if (mon->mextra)
         dealloc_mextra(mon);
-    free((genericptr_t) mon);
+    mon_id_unregister(mon);
+    pool_free(&monst_pool, (genericptr_t) mon);
 }
 
 /* remove effects of mtmp from other data structures */
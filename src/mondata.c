@@ -4,6 +4,9 @@
 /* NetHack may be freely redistributed.  See license for details. */
 
 #include "hack.h"
+
+STATIC_DCL boolean FDECL(mon_suffix, (const char *));
+
 /*
  *      These routines provide basic data for any type of monster.
  */
@@ -661,6 +664,24 @@ struct alt_spl {
     short pm_val;
 };
 
+/* does the rest of a name, following a monster name, look like a plural
+   or possessive ending (optionally followed by more words)? */
+STATIC_OVL boolean
+mon_suffix(rest)
+const char *rest;
+{
+    static const char *const suffixes[] = { "s", "'", "'s", "es", 0 };
+    const char *const *sfx;
+    int n;
+
+    for (sfx = suffixes; *sfx; sfx++) {
+        n = (int) strlen(*sfx);
+        if (!strncmp(rest, *sfx, n) && (!rest[n] || rest[n] == ' '))
+            return TRUE;
+    }
+    return FALSE;
+}
+
 /* figure out what type of monster a user-supplied string is specifying */
 int
 name_to_mon(in_str)
@@ -678,7 +699,6 @@ const char *in_str;
      * This also permits plurals created by adding suffixes such as 's'
      * or 'es'.  Other plurals must still be handled explicitly.
      */
-    register int i;
     register int mntmp = NON_PM;
     register char *s, *str, *term;
     char buf[BUFSZ];
@@ -707,84 +727,23 @@ const char *in_str;
         Strcpy(term - 3, "f");
 
     slen = strlen(str); /* length possibly needs recomputing */
-
-    {
-        static const struct alt_spl names[] = {
-            /* Alternate spellings */
-            { "grey dragon", PM_GRAY_DRAGON },
-            { "baby grey dragon", PM_BABY_GRAY_DRAGON },
-            { "grey unicorn", PM_GRAY_UNICORN },
-            { "grey ooze", PM_GRAY_OOZE },
-            { "gray-elf", PM_GREY_ELF },
-            { "mindflayer", PM_MIND_FLAYER },
-            { "master mindflayer", PM_MASTER_MIND_FLAYER },
-            /* More alternates; priest and priestess are separate monster
-               types but that isn't the case for {aligned,high} priests */
-            { "aligned priestess", PM_ALIGNED_PRIEST },
-            { "high priestess", PM_HIGH_PRIEST },
-            /* Inappropriate singularization by -ves check above */
-            { "master of thief", PM_MASTER_OF_THIEVES },
-            /* Potential misspellings where we want to avoid falling back
-               to the rank title prefix (input has been singularized) */
-            { "master thief", PM_MASTER_OF_THIEVES },
-            { "master of assassin", PM_MASTER_ASSASSIN },
-            /* Outdated names */
-            { "invisible stalker", PM_STALKER },
-            { "high-elf", PM_ELVENKING }, /* PM_HIGH_ELF is obsolete */
-            { "halfling", PM_HOBBIT },    /* potential guess for polyself */
-            /* Hyphenated names */
-            { "ki rin", PM_KI_RIN },
-            { "uruk hai", PM_URUK_HAI },
-            { "orc captain", PM_ORC_CAPTAIN },
-            { "woodland elf", PM_WOODLAND_ELF },
-            { "green elf", PM_GREEN_ELF },
-            { "grey elf", PM_GREY_ELF },
-            { "gray elf", PM_GREY_ELF },
-            { "elf lord", PM_ELF_LORD },
-            { "olog hai", PM_OLOG_HAI },
-            { "arch lich", PM_ARCH_LICH },
-            /* Some irregular plurals */
-            { "incubi", PM_INCUBUS },
-            { "succubi", PM_SUCCUBUS },
-            { "violet fungi", PM_VIOLET_FUNGUS },
-            { "homunculi", PM_HOMUNCULUS },
-            { "baluchitheria", PM_BALUCHITHERIUM },
-            { "lurkers above", PM_LURKER_ABOVE },
-            { "cavemen", PM_CAVEMAN },
-            { "cavewomen", PM_CAVEWOMAN },
-            { "djinn", PM_DJINNI },
-            { "mumakil", PM_MUMAK },
-            { "erinyes", PM_ERINYS },
-            /* end of list */
-            { 0, NON_PM }
-        };
-        register const struct alt_spl *namep;
-
-        for (namep = names; namep->name; namep++)
-            if (!strncmpi(str, namep->name, (int) strlen(namep->name)))
-                return namep->pm_val;
-    }
-
-    for (len = 0, i = LOW_PM; i < NUMMONS; i++) {
-        register int m_i_len = strlen(mons[i].mname);
-
-        if (m_i_len > len && !strncmpi(mons[i].mname, str, m_i_len)) {
-            if (m_i_len == slen) {
-                return i; /* exact match */
-            } else if (slen > m_i_len
-                       && (str[m_i_len] == ' '
-                           || !strcmpi(&str[m_i_len], "s")
-                           || !strncmpi(&str[m_i_len], "s ", 2)
-                           || !strcmpi(&str[m_i_len], "'")
-                           || !strncmpi(&str[m_i_len], "' ", 2)
-                           || !strcmpi(&str[m_i_len], "'s")
-                           || !strncmpi(&str[m_i_len], "'s ", 3)
-                           || !strcmpi(&str[m_i_len], "es")
-                           || !strncmpi(&str[m_i_len], "es ", 3))) {
-                mntmp = i;
-                len = m_i_len;
-            }
-        }
+    for (s = str; *s; s++)
+        *s = lowc(*s);
+
+    /* alternate spellings and irregular plurals are in mon_nametab too
+       (see makedefs), so one probe per possible end of the name is enough;
+       try the longest candidate first */
+    for (len = slen; len > 0 && mntmp == NON_PM; len--) {
+        const short *vals;
+        char c;
+
+        term = str + len;
+        if (*term && *term != ' ' && !mon_suffix(term))
+            continue;
+        c = *term, *term = '\0';
+        if (nametab_lookup(&mon_nametab, str, &vals))
+            mntmp = vals[0];
+        *term = c;
     }
     if (mntmp == NON_PM)
         mntmp = title_to_mon(str, (int *) 0, (int *) 0);
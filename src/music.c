@@ -501,6 +501,7 @@ play_song()
 	register struct monst *mtmp;
 	int distance;
 
+	PERF_START(PERF_SONG);
 	distance = (P_SKILL(P_MUSICALIZE) - P_UNSKILLED + 1) * 9 + (u.ulevel/2);
 
 	/* songs only have effect after the 1st turn */
@@ -525,6 +526,7 @@ play_song()
 			tame_song(distance);
 			break;
 		}
+	PERF_STOP(PERF_SONG);
 
 	song_delay--;
 	if (song_delay <= 0) {
@@ -176,6 +176,7 @@ init_objects()
     }
     /* shuffle descriptions */
     shuffle_all();
+    reset_glyphmap(); /* object colors moved with their descriptions */
 #ifdef USE_TILES
     shuffle_tiles();
 #endif
@@ -333,6 +334,8 @@ register int fd;
             objects[i].oc_uname = (char *) alloc(len);
             mread(fd, (genericptr_t) objects[i].oc_uname, len);
         }
+    objnam_changed();
+    reset_glyphmap();
 #ifdef USE_TILES
     shuffle_tiles();
 #endif
@@ -356,6 +359,7 @@ boolean credit_hero;
                 break;
         disco[dindx] = oindx;
 
+        objnam_changed();
         if (mark_as_known) {
             objects[oindx].oc_name_known = 1;
             if (credit_hero)
@@ -389,6 +393,7 @@ register int oindx;
             disco[dindx - 1] = 0;
         else
             impossible("named object not in disco");
+        objnam_changed();
         update_inventory();
     }
 }
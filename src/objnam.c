@@ -13,6 +13,7 @@
 STATIC_DCL char *FDECL(strprepend, (char *, const char *));
 STATIC_DCL short FDECL(rnd_otyp_by_wpnskill, (SCHAR_P));
 STATIC_DCL short FDECL(rnd_otyp_by_namedesc, (char *, CHAR_P));
+STATIC_DCL void FDECL(nametab_key, (char *, const char *));
 STATIC_DCL boolean FDECL(wishymatch, (const char *, const char *, BOOLEAN_P));
 STATIC_DCL char *NDECL(nextobuf);
 STATIC_DCL void FDECL(releaseobuf, (char *));
@@ -24,6 +25,11 @@ STATIC_DCL boolean FDECL(singplur_lookup, (char *, char *, BOOLEAN_P,
 STATIC_DCL char *FDECL(singplur_compound, (char *));
 STATIC_DCL char *FDECL(xname_flags, (struct obj *, unsigned));
 STATIC_DCL boolean FDECL(badman, (const char *, BOOLEAN_P));
+STATIC_DCL unsigned NDECL(onc_state);
+STATIC_DCL boolean FDECL(onc_usable, (struct obj *, unsigned));
+STATIC_DCL void FDECL(onc_snapshot, (struct obj *, struct obj *));
+STATIC_DCL const char *FDECL(onc_lookup, (struct obj *, unsigned));
+STATIC_DCL void FDECL(onc_remember, (struct obj *, unsigned, const char *));
 
 struct Jitem {
     int item;
@@ -386,6 +392,192 @@ boolean forward;
     }
 }
 
+/*
+ * Formatted name cache.  The results of doname() and xname() are kept
+ * per object so that redisplaying a pile or the inventory doesn't have
+ * to rebuild every description.  An entry is reused only while the
+ * object's own fields, its type's naming state, the hero-side state
+ * which formatting consults (onc_state()) and objnam_gen are all the
+ * same as when it was made.  objnam_gen is bumped by objnam_changed()
+ * whenever naming state that a snapshot can't see changes:  text given
+ * via #call or #name, fruit names, discoveries, egg knowledge, and
+ * restoring a game.  Only outermost calls use the cache; doname()'s own
+ * call to xname() is formatted normally.
+ */
+#define DONAME_WITH_PRICE 1
+#define DONAME_VAGUE_QUAN 2
+
+#define ONC_SIZE 1024      /* must be a power of 2 */
+#define ONC_DONAME 0x8000U /* 'how' for doname; otherwise CXN_xxx flags */
+
+struct onc_entry {
+    struct obj *obj; /* null for an unused entry */
+    struct obj snap; /* obj's fields, minus list links and position */
+    const char *oname, *uname;
+    struct permonst *ydata; /* for body_part() */
+    unsigned long gen;
+    unsigned how, state;
+    Bitfield(nn, 1); /* objects[].oc_name_known */
+    char name[BUFSZ];
+};
+
+static struct onc_entry *onc = 0;
+static unsigned long objnam_gen = 0L;
+static int onc_busy = 0;
+static long onc_hits = 0L, onc_misses = 0L;
+
+/* naming state changed in a way that the cache's snapshots can't detect */
+void
+objnam_changed()
+{
+    ++objnam_gen;
+}
+
+void
+free_objnam_cache()
+{
+    if (onc)
+        free((genericptr_t) onc), onc = 0;
+    ++objnam_gen;
+}
+
+/* hero-side state which affects the formatted names */
+STATIC_OVL unsigned
+onc_state()
+{
+    unsigned state = 0;
+
+    if (Blind)
+        state |= 0x01;
+    if (distantname)
+        state |= 0x02;
+    if (Hallucination)
+        state |= 0x04;
+    if (u.twoweap)
+        state |= 0x08;
+    if (mrg_to_wielded)
+        state |= 0x10;
+    if (iflags.implicit_uncursed)
+        state |= 0x20;
+    if (wizard && iflags.wizweight)
+        state |= 0x40;
+    if (warn_obj_cnt && (EWarn_of_mon & W_WEP) != 0L)
+        state |= 0x80;
+    return state;
+}
+
+/* some results depend on things outside the object; don't cache those */
+STATIC_OVL boolean
+onc_usable(obj, how)
+struct obj *obj;
+unsigned how;
+{
+    if (onc_busy || iflags.override_ID || program_state.gameover)
+        return FALSE;
+    if (how & ONC_DONAME) {
+        /* shop prices, container contents, the leashed monster's name,
+           and a hallucinatory glow color for the wielded weapon */
+        if ((how & DONAME_WITH_PRICE) || obj->unpaid || Has_contents(obj)
+            || (obj->otyp == LEASH && obj->leashmon != 0)
+            || (Hallucination && obj == uwep))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+STATIC_OVL void
+onc_snapshot(obj, snap)
+struct obj *obj, *snap;
+{
+    (void) memcpy((genericptr_t) snap, (genericptr_t) obj, sizeof *snap);
+    snap->nobj = snap->cobj = (struct obj *) 0;
+    snap->v.v_nexthere = (struct obj *) 0;
+    snap->ox = snap->oy = 0;
+    snap->invlet = 0;
+}
+
+#define onc_index(obj, how) \
+    (((unsigned) (obj)->o_id + (how) * 509U) & (ONC_SIZE - 1))
+
+STATIC_OVL const char *
+onc_lookup(obj, how)
+struct obj *obj;
+unsigned how;
+{
+    struct onc_entry *e;
+    struct obj snap;
+
+    if (!onc || !onc_usable(obj, how))
+        return (const char *) 0;
+    e = &onc[onc_index(obj, how)];
+    if (e->obj != obj || e->how != how || e->gen != objnam_gen
+        || e->state != onc_state() || e->ydata != youmonst.data
+        || e->nn != objects[obj->otyp].oc_name_known
+        || e->uname != objects[obj->otyp].oc_uname
+        || e->oname != (has_oname(obj) ? ONAME(obj) : (char *) 0)) {
+        ++onc_misses;
+        return (const char *) 0;
+    }
+    onc_snapshot(obj, &snap);
+    if (memcmp((genericptr_t) &snap, (genericptr_t) &e->snap, sizeof snap)) {
+        ++onc_misses;
+        return (const char *) 0;
+    }
+    ++onc_hits;
+    return e->name;
+}
+
+/* called after formatting, so that the snapshot includes any side-effects
+   of formatting (dknown and bknown, for instance) */
+STATIC_OVL void
+onc_remember(obj, how, name)
+struct obj *obj;
+unsigned how;
+const char *name;
+{
+    struct onc_entry *e;
+
+    if (!onc_usable(obj, how) || strlen(name) >= BUFSZ - PREFIX)
+        return;
+    if (!onc) {
+        onc = (struct onc_entry *) alloc(ONC_SIZE * sizeof *onc);
+        (void) memset((genericptr_t) onc, 0, ONC_SIZE * sizeof *onc);
+    }
+    e = &onc[onc_index(obj, how)];
+    e->obj = obj;
+    onc_snapshot(obj, &e->snap);
+    e->oname = has_oname(obj) ? ONAME(obj) : (char *) 0;
+    e->uname = objects[obj->otyp].oc_uname;
+    e->nn = objects[obj->otyp].oc_name_known;
+    e->ydata = youmonst.data;
+    e->gen = objnam_gen;
+    e->how = how;
+    e->state = onc_state();
+    Strcpy(e->name, name);
+}
+
+/* what naming an object tells the hero about it; also used by menus
+   which only format the names of the lines they get around to showing */
+void
+objname_observe(obj)
+struct obj *obj;
+{
+    struct objclass *ocl = &objects[obj->otyp];
+
+    /*
+     * clean up known when it's tied to oc_name_known, eg after AD_DRIN
+     * This is only required for unique objects since the article
+     * printed for the object is tied to the combination of the two
+     * and printing the wrong article gives away information.
+     */
+    if (!ocl->oc_name_known && ocl->oc_uses_known && ocl->oc_unique)
+        obj->known = 0;
+    if (!Blind && !distantname)
+        obj->dknown = TRUE;
+    if (Role_if(PM_PRIEST))
+        obj->bknown = TRUE;
+}
+
 char *
 xname(obj)
 struct obj *obj;
@@ -407,24 +599,19 @@ unsigned cxn_flags; /* bitmask of CXN_xxx values */
     const char *un = ocl->oc_uname;
     boolean pluralize = (obj->quan != 1L) && !(cxn_flags & CXN_SINGULAR);
     boolean known, dknown, bknown;
+    const char *cached = onc_lookup(obj, cxn_flags);
 
     buf = nextobuf() + PREFIX; /* leave room for "17 -3 " */
+    if (cached) {
+        Strcpy(buf, cached);
+        return buf;
+    }
+    ++onc_busy;
     if (Role_if(PM_SAMURAI) && Japanese_item_name(typ))
         actualn = Japanese_item_name(typ);
 
     buf[0] = '\0';
-    /*
-     * clean up known when it's tied to oc_name_known, eg after AD_DRIN
-     * This is only required for unique objects since the article
-     * printed for the object is tied to the combination of the two
-     * and printing the wrong article gives away information.
-     */
-    if (!nn && ocl->oc_uses_known && ocl->oc_unique)
-        obj->known = 0;
-    if (!Blind && !distantname)
-        obj->dknown = TRUE;
-    if (Role_if(PM_PRIEST))
-        obj->bknown = TRUE;
+    objname_observe(obj);
 
     if (iflags.override_ID) {
         known = dknown = bknown = TRUE;
@@ -705,6 +892,8 @@ unsigned cxn_flags; /* bitmask of CXN_xxx values */
 
     if (!strncmpi(buf, "the ", 4))
         buf += 4;
+    if (!--onc_busy)
+        onc_remember(obj, cxn_flags, buf);
     return buf;
 }
 
@@ -890,9 +1079,6 @@ struct obj *obj;
     return FALSE;
 }
 
-#define DONAME_WITH_PRICE 1
-#define DONAME_VAGUE_QUAN 2
-
 STATIC_OVL char *
 doname_base(obj, doname_flags)
 struct obj *obj;
@@ -907,7 +1093,16 @@ unsigned doname_flags;
     char tmpbuf[PREFIX + 1]; /* for when we have to add something at
                                 the start of prefix instead of the
                                 end (Strcat is used on the end) */
-    register char *bp = xname(obj);
+    register char *bp;
+    const char *cached = onc_lookup(obj, doname_flags | ONC_DONAME);
+
+    if (cached) {
+        bp = nextobuf();
+        Strcpy(bp, cached);
+        return bp;
+    }
+    ++onc_busy;
+    bp = xname(obj);
 
     if (iflags.override_ID) {
         known = dknown = cknown = bknown = lknown = TRUE;
@@ -1222,6 +1417,8 @@ unsigned doname_flags;
         Sprintf(eos(bp), " (%d aum)", obj->owt);
     }
     bp = strprepend(bp, prefix);
+    if (!--onc_busy)
+        onc_remember(obj, doname_flags | ONC_DONAME, bp);
     return bp;
 }
 
@@ -1495,6 +1692,9 @@ unsigned lenlimit;
     outbuf = (*func)(obj);
     if ((unsigned) strlen(outbuf) <= lenlimit)
         return outbuf;
+    /* the truncated names below live on the stack; don't let a result
+       cached by a previous call with different stack contents match */
+    objnam_changed();
 
     /* shorten called string to fairly small amount */
     save_uname = objects[obj->otyp].oc_uname;
@@ -2708,20 +2908,60 @@ schar skill;
     return otyp;
 }
 
+/* normalize a string the way makedefs did for the object name tables:
+   lowercase, with spaces and hyphens removed (as fuzzymatch() ignores) */
+STATIC_OVL void
+nametab_key(buf, str)
+char *buf;
+const char *str;
+{
+    char c;
+
+    do {
+        c = *str++;
+        if (c != ' ' && c != '-')
+            *buf++ = lowc(c);
+    } while (c);
+}
+
 STATIC_OVL short
 rnd_otyp_by_namedesc(name, oclass)
 char *name;
 char oclass;
 {
-    int i, n = 0;
+    int i, j, k, n = 0;
     short validobjs[NUM_OBJECTS];
+    boolean hit[NUM_OBJECTS], deschit[NUM_OBJECTS];
+    const short *vals;
     register const char *zn;
+    char key[BUFSZ], *p;
     long maxprob = 0;
 
     if (!name)
         return STRANGE_OBJECT;
 
     memset((genericptr_t) validobjs, 0, sizeof(validobjs));
+    memset((genericptr_t) hit, 0, sizeof hit);
+    memset((genericptr_t) deschit, 0, sizeof deschit);
+
+    /* names and descriptions, with their variant spellings, are in the
+       makedefs-generated tables; only the user-called names need a scan */
+    nametab_key(key, name);
+    for (k = nametab_lookup(&objname_nametab, key, &vals); --k >= 0; )
+        hit[vals[k]] = TRUE;
+    for (k = nametab_lookup(&objdesc_nametab, key, &vals); --k >= 0; )
+        deschit[vals[k]] = TRUE;
+    /* "foo of bar" from the user can match a name of the form "bar foo" */
+    if ((zn = strstri(name, " of ")) != 0) {
+        Strcpy(key, zn + 4);
+        p = eos(strcat(key, " "));
+        (void) strncpy(p, name, (size_t) (zn - name));
+        p[zn - name] = '\0';
+        nametab_key(key, key);
+        for (k = nametab_lookup(&objname_nametab, key, &vals); --k >= 0; )
+            if (!strstri(OBJ_NAME(objects[vals[k]]), " of "))
+                hit[vals[k]] = TRUE;
+    }
 
     for (i = oclass ? bases[(int)oclass] : STRANGE_OBJECT + 1;
          i < NUM_OBJECTS && (!oclass || objects[i].oc_class == oclass);
@@ -2729,9 +2969,8 @@ char oclass;
         /* don't match extra descriptions (w/o real name) */
         if ((zn = OBJ_NAME(objects[i])) == 0)
             continue;
-        if (wishymatch(name, zn, TRUE)
-            || ((zn = OBJ_DESCR(objects[i])) != 0
-                && wishymatch(name, zn, FALSE))
+        j = objects[i].oc_descr_idx;
+        if (hit[i] || (OBJ_DESCR(objects[i]) != 0 && deschit[j])
             || ((zn = objects[i].oc_uname) != 0
                 && wishymatch(name, zn, FALSE))) {
             validobjs[n++] = (short) i;
@@ -4097,4 +4336,54 @@ const char *lastR;
     return qbuf;
 }
 
+#define BENCH_PILE 500
+#define BENCH_PASSES 20
+
+/* #wiznamebench command - time doname() over a pile with and without
+   the formatted name cache */
+void
+objnam_bench()
+{
+    struct obj **pile, *otmp;
+    clock_t start, uncached, cached;
+    long hits = onc_hits, misses = onc_misses;
+    int i, pass;
+
+    pile = (struct obj **) alloc(BENCH_PILE * sizeof *pile);
+    for (i = 0; i < BENCH_PILE; i++) {
+        otmp = mkobj(RANDOM_CLASS, FALSE);
+        /* a pile that's been handled has a mix of known attributes */
+        if (i % 2)
+            otmp->bknown = 1;
+        if (i % 3)
+            otmp->dknown = 1;
+        pile[i] = otmp;
+    }
+
+    ++onc_busy; /* suppress the cache */
+    start = clock();
+    for (pass = 0; pass < BENCH_PASSES; pass++)
+        for (i = 0; i < BENCH_PILE; i++)
+            (void) doname(pile[i]);
+    uncached = clock() - start;
+    --onc_busy;
+
+    start = clock();
+    for (pass = 0; pass < BENCH_PASSES; pass++)
+        for (i = 0; i < BENCH_PILE; i++)
+            (void) doname(pile[i]);
+    cached = clock() - start;
+
+    for (i = 0; i < BENCH_PILE; i++)
+        obfree(pile[i], (struct obj *) 0);
+    free((genericptr_t) pile);
+
+    pline("%d objects formatted %d times: %ld ms uncached, %ld ms cached.",
+          BENCH_PILE, BENCH_PASSES,
+          (long) (uncached * 1000L / CLOCKS_PER_SEC),
+          (long) (cached * 1000L / CLOCKS_PER_SEC));
+    pline("Cache hits %ld, misses %ld.", onc_hits - hits,
+          onc_misses - misses);
+}
+
 /*objnam.c*/
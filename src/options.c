@@ -16,6 +16,7 @@ NEARDATA struct instance_flags iflags; /* provide linkage */
 #else
 #include "hack.h"
 #include "tcap.h"
+#include "nametab.h"
 #include <ctype.h>
 #endif
 
@@ -522,6 +523,9 @@ STATIC_DCL int FDECL(change_inv_order, (char *));
 STATIC_DCL boolean FDECL(warning_opts, (char *, const char *));
 STATIC_DCL int FDECL(feature_alert_opts, (char *, const char *));
 STATIC_DCL boolean FDECL(duplicate_opt_detection, (const char *, int));
+STATIC_DCL boolean FDECL(optname_overlap, (const char *, const char *));
+STATIC_DCL void NDECL(boolopt_hash_init);
+STATIC_DCL int FDECL(boolopt_lookup, (const char *));
 STATIC_DCL void FDECL(complain_about_duplicate, (const char *, int));
 
 STATIC_DCL const char *FDECL(attr2attrname, (int));
@@ -531,6 +535,18 @@ STATIC_DCL boolean FDECL(msgtype_add, (int, char *));
 STATIC_DCL void FDECL(free_one_msgtype, (int));
 STATIC_DCL int NDECL(msgtype_count);
 STATIC_DCL boolean FDECL(test_regex_pattern, (const char *, const char *));
+STATIC_DCL struct regex_set *FDECL(regex_set_alloc, (int));
+STATIC_DCL void FDECL(regex_set_build, (struct regex_set *, int, int, int));
+STATIC_DCL int FDECL(regex_set_find, (struct regex_set *, const char *,
+                                      int, int, int));
+STATIC_DCL int FDECL(regex_set_first, (struct regex_set *, const char *));
+STATIC_DCL void FDECL(regex_set_free, (struct regex_set **));
+STATIC_DCL struct nhregex *FDECL(rule_regex, (const char *));
+STATIC_DCL void FDECL(defer_rule_regex, (int, genericptr_t,
+                                         struct nhregex **, const char *));
+STATIC_DCL void NDECL(msgtype_set_build);
+STATIC_DCL void NDECL(menucolor_set_build);
+STATIC_DCL void FDECL(ape_set_build, (int));
 STATIC_DCL boolean FDECL(add_menu_coloring_parsed, (char *, int, int));
 STATIC_DCL void FDECL(free_one_menu_coloring, (int));
 STATIC_DCL int NDECL(count_menucolors);
@@ -615,6 +631,105 @@ boolean val_allowed;
                       && !strncmpi(opt_name, user_string, len));
 }
 
+/*
+ * Boolean options by full name.  parseoptions() tries its whole chain
+ * of special and compound options before it gets to boolopt[], yet most
+ * config file lines are booleans spelled out in full; those which
+ * nothing ahead of them could claim are hashed so they can skip it.
+ */
+#define BOOLOPT_HASHSZ 512 /* a power of 2, well over SIZE(boolopt) */
+static short boolopt_hash[BOOLOPT_HASHSZ]; /* boolopt[] index + 1, or 0 */
+static boolean boolopt_hashed = FALSE;
+
+/* names parseoptions() recognizes which aren't in compopt[] */
+static const char *const parseopt_extra[] = {
+    "colour", "female", "male", "IBM_", "palette", "hicolor", "fruit",
+    "videocolours", "character", "warnings", "menucolor", "prayconfirm",
+    "hilite_status", "font", "DECgraphics", "IBMgraphics", "MACgraphics",
+};
+
+/* could one of these names be taken for an abbreviation of the other? */
+STATIC_OVL boolean
+optname_overlap(name1, name2)
+const char *name1, *name2;
+{
+    size_t len1 = strlen(name1), len2 = strlen(name2);
+
+    return (boolean) !strncmpi(name1, name2, min(len1, len2));
+}
+
+STATIC_OVL void
+boolopt_hash_init()
+{
+    const char *name;
+    unsigned long h;
+    int i, j;
+
+    for (i = 0; (name = boolopt[i].name) != 0; i++) {
+        if (strlen(name) < 3)
+            continue;
+        for (j = 0; compopt[j].name; j++)
+            if (optname_overlap(name, compopt[j].name))
+                break;
+        if (compopt[j].name)
+            continue;
+        for (j = 0; j < SIZE(parseopt_extra); j++)
+            if (optname_overlap(name, parseopt_extra[j]))
+                break;
+        if (j < SIZE(parseopt_extra))
+            continue;
+        for (j = 0; j < SIZE(default_menu_cmd_info); j++)
+            if (optname_overlap(name, default_menu_cmd_info[j].name))
+                break;
+        if (j < SIZE(default_menu_cmd_info))
+            continue;
+        /* an earlier boolean which this one abbreviates would win */
+        for (j = 0; j < i; j++)
+            if (optname_overlap(name, boolopt[j].name))
+                break;
+        if (j < i)
+            continue;
+
+        for (h = NAMEHASH_BASIS; *name; name++)
+            h = NAMEHASH_STEP(h, lowc(*name));
+        j = (int) (h & (BOOLOPT_HASHSZ - 1));
+        while (boolopt_hash[j])
+            j = (j + 1) & (BOOLOPT_HASHSZ - 1);
+        boolopt_hash[j] = (short) (i + 1);
+    }
+    boolopt_hashed = TRUE;
+}
+
+/* boolopt[] index of the option which opts names in full, or -1 if it
+   isn't one or has to be looked for the long way */
+STATIC_OVL int
+boolopt_lookup(opts)
+const char *opts;
+{
+    const char *p = index(opts, ':'), *q = index(opts, '=');
+    unsigned long h = NAMEHASH_BASIS;
+    int i, j, len;
+
+    if (!boolopt_hashed)
+        boolopt_hash_init();
+    if (!p || (q && q < p))
+        p = q;
+    if (!p)
+        p = eos((char *) opts);
+    while (p > opts && isspace((uchar) *(p - 1)))
+        p--;
+    len = (int) (p - opts);
+    for (p = opts; p < opts + len; p++)
+        h = NAMEHASH_STEP(h, lowc(*p));
+    for (j = (int) (h & (BOOLOPT_HASHSZ - 1)); boolopt_hash[j];
+         j = (j + 1) & (BOOLOPT_HASHSZ - 1)) {
+        i = boolopt_hash[j] - 1;
+        if (!strncmpi(boolopt[i].name, opts, len) && !boolopt[i].name[len])
+            return i;
+    }
+    return -1;
+}
+
 /* most environment variables will eventually be printed in an error
  * message if they don't work, and most error message paths go through
  * BUFSZ buffers, which could be overflowed by a maliciously long
@@ -1199,15 +1314,17 @@ int iscompound; /* 0 == boolean option, 1 == compound */
     int i, *optptr;
 
     if (!iscompound && iflags.opt_booldup && initial && from_file) {
-        for (i = 0; boolopt[i].name; i++) {
-            if (match_optname(opts, boolopt[i].name, 3, FALSE)) {
-                optptr = iflags.opt_booldup + i;
-                *optptr += 1;
-                if (*optptr > 1)
-                    return TRUE;
-                else
-                    return FALSE;
-            }
+        if ((i = boolopt_lookup(opts)) < 0)
+            for (i = 0; boolopt[i].name; i++)
+                if (match_optname(opts, boolopt[i].name, 3, FALSE))
+                    break;
+        if (boolopt[i].name) {
+            optptr = iflags.opt_booldup + i;
+            *optptr += 1;
+            if (*optptr > 1)
+                return TRUE;
+            else
+                return FALSE;
         }
     } else if (iscompound && iflags.opt_compdup && initial && from_file) {
         for (i = 0; compopt[i].name; i++) {
@@ -1513,6 +1630,336 @@ query_msgtype()
     return -1;
 }
 
+/*
+ * Rule lists matched as a set.
+ *
+ * The expressions of a rule list (MSGTYPE, MENUCOLOR, autopickup
+ * exceptions) are kept in a binary tree: each leaf is one rule's own
+ * expression, and each inner node, when the regex implementation can
+ * manage it, is a single expression combining all the rules below it.
+ * A string that matches none of the rules costs one match at the root;
+ * one that does is steered to the first (in list order) matching rule
+ * in a number of matches that grows with the depth of the tree rather
+ * than the length of the list.  The leaves remain authoritative, so an
+ * implementation that can't combine expressions just gets the old
+ * rule-by-rule scan.  A set is built on first use and discarded
+ * whenever its list changes.
+ */
+struct regex_set {
+    int n;                  /* number of rules */
+    struct nhregex ***leaf; /* where each rule keeps its expression */
+    const char **pat;      /* and its source text (borrowed) */
+    genericptr_t *rule;    /* the rule itself */
+    struct nhregex **node; /* node[i] covers some range of leaves, or 0 */
+};
+
+static struct regex_set *msgtype_set = 0, *menucolor_set = 0,
+                        *ape_set[2] = { 0, 0 };
+
+/*
+ * While a config file is being read, the patterns of its MSGTYPE,
+ * MENUCOLOR and AUTOPICKUP_EXCEPTION rules are only noted.  Once the
+ * file is done they're checked a whole kind at a time, in a single
+ * compilation when the regex implementation can combine them, and each
+ * rule's own expression is left for regex_set_find() to compile the
+ * first time it's needed.
+ */
+#define RULE_MSGTYPE 0
+#define RULE_MENUCOLOR 1
+#define RULE_APE 2
+#define NUM_RULE_KINDS 3
+
+struct regex_pending {
+    int kind;            /* RULE_xxx */
+    genericptr_t rule;
+    struct nhregex **re; /* the rule's expression, still null */
+    const char *pat;     /* the rule's pattern */
+    int line;            /* where it came from */
+    struct regex_pending *next;
+};
+
+static struct regex_pending *regex_pending = 0;
+static boolean regex_deferred = FALSE;
+
+/*
+ * Combine ERE patterns as "(s0)|(s1)|...".  Returns an alloc'd string, or
+ * null if one of them can't safely be wrapped: unbalanced parentheses
+ * would change meaning, as would back-references since the groups get
+ * renumbered.  Used by regex implementations for regex_compile_set().
+ */
+char *
+regex_set_pattern(s, n)
+const char *const *s;
+int n;
+{
+    const char *p;
+    char *buf, *q;
+    int i, depth;
+    unsigned len = 1;
+
+    for (i = 0; i < n; i++) {
+        for (depth = 0, p = s[i]; *p; p++) {
+            if (*p == '\\') {
+                if (!*++p || digit(*p))
+                    return (char *) 0;
+            } else if (*p == '[') {
+                /* skip bracket expression; ']' first is a member */
+                if (*++p == '^')
+                    ++p;
+                if (*p == ']')
+                    ++p;
+                while (*p && *p != ']')
+                    ++p;
+                if (!*p)
+                    return (char *) 0;
+            } else if (*p == '(') {
+                ++depth;
+            } else if (*p == ')') {
+                if (--depth < 0)
+                    return (char *) 0;
+            }
+        }
+        if (depth)
+            return (char *) 0;
+        len += (unsigned) strlen(s[i]) + 3;
+    }
+    buf = q = (char *) alloc(len);
+    for (i = 0; i < n; i++) {
+        if (i)
+            *q++ = '|';
+        *q++ = '(';
+        Strcpy(q, s[i]);
+        q = eos(q);
+        *q++ = ')';
+    }
+    *q = '\0';
+    return buf;
+}
+
+STATIC_OVL struct regex_set *
+regex_set_alloc(n)
+int n;
+{
+    struct regex_set *rs = (struct regex_set *) alloc(sizeof *rs);
+
+    rs->n = n;
+    rs->leaf = (struct nhregex ***) alloc((unsigned) (n * sizeof *rs->leaf));
+    rs->pat = (const char **) alloc((unsigned) (n * sizeof *rs->pat));
+    rs->rule = (genericptr_t *) alloc((unsigned) (n * sizeof *rs->rule));
+    rs->node = (struct nhregex **) alloc((unsigned) (4 * n
+                                                     * sizeof *rs->node));
+    (void) memset((genericptr_t) rs->node, 0, 4 * n * sizeof *rs->node);
+    return rs;
+}
+
+/* compile the inner node i covering leaves [lo,hi) and those below it */
+STATIC_OVL void
+regex_set_build(rs, i, lo, hi)
+struct regex_set *rs;
+int i, lo, hi;
+{
+    int mid = (lo + hi) / 2;
+
+    if (hi - lo < 2)
+        return;
+    rs->node[i] = regex_init();
+    if (!regex_compile_set(&rs->pat[lo], hi - lo, rs->node[i])) {
+        regex_free(rs->node[i]);
+        rs->node[i] = (struct nhregex *) 0;
+    }
+    regex_set_build(rs, 2 * i, lo, mid);
+    regex_set_build(rs, 2 * i + 1, mid, hi);
+}
+
+STATIC_OVL int
+regex_set_find(rs, str, i, lo, hi)
+struct regex_set *rs;
+const char *str;
+int i, lo, hi;
+{
+    int mid = (lo + hi) / 2, res;
+
+    if (hi - lo == 1) {
+        struct nhregex **re = rs->leaf[lo];
+
+        if (!*re) /* checked but not compiled yet; see check_rule_regexes */
+            *re = rule_regex(rs->pat[lo]);
+        return (*re && regex_match(str, *re)) ? lo : -1;
+    }
+    if (rs->node[i] && !regex_match(str, rs->node[i]))
+        return -1;
+    if ((res = regex_set_find(rs, str, 2 * i, lo, mid)) < 0)
+        res = regex_set_find(rs, str, 2 * i + 1, mid, hi);
+    return res;
+}
+
+/* index of the first rule matching str, or -1 */
+STATIC_OVL int
+regex_set_first(rs, str)
+struct regex_set *rs;
+const char *str;
+{
+    if (!rs || !rs->n || !str)
+        return -1;
+    return regex_set_find(rs, str, 1, 0, rs->n);
+}
+
+STATIC_OVL void
+regex_set_free(rsp)
+struct regex_set **rsp;
+{
+    struct regex_set *rs = *rsp;
+    int i;
+
+    if (!rs)
+        return;
+    for (i = 0; i < 4 * rs->n; i++)
+        if (rs->node[i])
+            regex_free(rs->node[i]);
+    free((genericptr_t) rs->node);
+    free((genericptr_t) rs->rule);
+    free((genericptr_t) rs->pat);
+    free((genericptr_t) rs->leaf);
+    free((genericptr_t) rs);
+    *rsp = (struct regex_set *) 0;
+}
+
+/* compile one rule's pattern, or null if it won't */
+STATIC_OVL struct nhregex *
+rule_regex(pat)
+const char *pat;
+{
+    struct nhregex *re = regex_init();
+
+    if (!regex_compile(pat, re)) {
+        regex_free(re);
+        re = (struct nhregex *) 0;
+    }
+    return re;
+}
+
+STATIC_OVL void
+defer_rule_regex(kind, rule, re, pat)
+int kind;
+genericptr_t rule;
+struct nhregex **re;
+const char *pat;
+{
+    struct regex_pending *rp = (struct regex_pending *) alloc(sizeof *rp);
+
+    rp->kind = kind;
+    rp->rule = rule;
+    rp->re = re;
+    rp->pat = pat;
+    rp->line = config_error_lineno();
+    rp->next = regex_pending;
+    regex_pending = rp;
+}
+
+/* config file reading is about to start */
+void
+defer_rule_regexes()
+{
+    regex_deferred = TRUE;
+}
+
+/* config file reading is done; drop any rules with bad patterns,
+   reporting them against the lines they came from */
+boolean
+check_rule_regexes()
+{
+    static const char *const re_error[NUM_RULE_KINDS] = {
+        "MSGTYPE regex error", "Menucolor regex error",
+        "regex error in AUTOPICKUP_EXCEPTION",
+    };
+    struct regex_pending *rp, *next, *prev = 0;
+    const char **pats;
+    struct nhregex *re;
+    boolean ok, retval = TRUE;
+    int kind, n, idx;
+
+    regex_deferred = FALSE;
+    /* they were noted newest first; report them in file order */
+    for (n = 0, rp = regex_pending; rp; rp = next, n++) {
+        next = rp->next;
+        rp->next = prev;
+        prev = rp;
+    }
+    regex_pending = prev;
+    if (!n)
+        return TRUE;
+
+    pats = (const char **) alloc((unsigned) (n * sizeof *pats));
+    for (kind = 0; kind < NUM_RULE_KINDS; kind++) {
+        for (n = 0, rp = regex_pending; rp; rp = rp->next)
+            if (rp->kind == kind)
+                pats[n++] = rp->pat;
+        if (!n)
+            continue;
+        /* if they all compile as one, each of them is good */
+        re = regex_init();
+        ok = regex_compile_set(pats, n, re);
+        regex_free(re);
+        if (ok)
+            continue;
+
+        for (rp = regex_pending; rp; rp = rp->next) {
+            if (rp->kind != kind)
+                continue;
+            *rp->re = regex_init();
+            if (regex_compile(rp->pat, *rp->re))
+                continue;
+            config_error_setline(rp->line);
+            config_error_add("%s: %s", re_error[kind],
+                             regex_error_desc(*rp->re));
+            regex_free(*rp->re);
+            *rp->re = (struct nhregex *) 0;
+            retval = FALSE;
+            if (kind == RULE_APE) {
+                remove_autopickup_exception(
+                                 (struct autopickup_exception *) rp->rule);
+            } else if (kind == RULE_MSGTYPE) {
+                struct plinemsg_type *mt = plinemsg_types;
+
+                for (idx = 0; mt != (struct plinemsg_type *) rp->rule;
+                     mt = mt->next)
+                    idx++;
+                free_one_msgtype(idx);
+            } else {
+                struct menucoloring *mc = menu_colorings;
+
+                for (idx = 0; mc != (struct menucoloring *) rp->rule;
+                     mc = mc->next)
+                    idx++;
+                free_one_menu_coloring(idx);
+            }
+        }
+    }
+    free((genericptr_t) pats);
+    while ((rp = regex_pending) != 0) {
+        regex_pending = rp->next;
+        free((genericptr_t) rp);
+    }
+    return retval;
+}
+
+STATIC_OVL void
+msgtype_set_build()
+{
+    struct plinemsg_type *tmp;
+    int n = 0;
+
+    for (tmp = plinemsg_types; tmp; tmp = tmp->next)
+        n++;
+    msgtype_set = regex_set_alloc(n);
+    for (n = 0, tmp = plinemsg_types; tmp; tmp = tmp->next, n++) {
+        msgtype_set->leaf[n] = &tmp->regex;
+        msgtype_set->pat[n] = tmp->pattern;
+        msgtype_set->rule[n] = (genericptr_t) tmp;
+    }
+    regex_set_build(msgtype_set, 1, 0, n);
+}
+
 STATIC_OVL boolean
 msgtype_add(typ, pattern)
 int typ;
@@ -1522,18 +1969,26 @@ char *pattern;
         *tmp = (struct plinemsg_type *) alloc(sizeof (struct plinemsg_type));
 
     tmp->msgtype = typ;
-    tmp->regex = regex_init();
-    if (!regex_compile(pattern, tmp->regex)) {
-        static const char *re_error = "MSGTYPE regex error";
-
-        config_error_add("%s: %s", re_error, regex_error_desc(tmp->regex));
-        regex_free(tmp->regex);
-        free((genericptr_t) tmp);
-        return FALSE;
+    tmp->regex = (struct nhregex *) 0;
+    if (!regex_deferred) {
+        tmp->regex = regex_init();
+        if (!regex_compile(pattern, tmp->regex)) {
+            static const char *re_error = "MSGTYPE regex error";
+
+            config_error_add("%s: %s", re_error,
+                             regex_error_desc(tmp->regex));
+            regex_free(tmp->regex);
+            free((genericptr_t) tmp);
+            return FALSE;
+        }
     }
     tmp->pattern = dupstr(pattern);
     tmp->next = plinemsg_types;
     plinemsg_types = tmp;
+    regex_set_free(&msgtype_set);
+    if (regex_deferred)
+        defer_rule_regex(RULE_MSGTYPE, (genericptr_t) tmp, &tmp->regex,
+                         tmp->pattern);
     return TRUE;
 }
 
@@ -1545,10 +2000,12 @@ msgtype_free()
     for (tmp = plinemsg_types; tmp; tmp = tmp2) {
         tmp2 = tmp->next;
         free((genericptr_t) tmp->pattern);
-        regex_free(tmp->regex);
+        if (tmp->regex)
+            regex_free(tmp->regex);
         free((genericptr_t) tmp);
     }
     plinemsg_types = (struct plinemsg_type *) 0;
+    regex_set_free(&msgtype_set);
 }
 
 STATIC_OVL void
@@ -1562,13 +2019,15 @@ int idx; /* 0 .. */
         if (idx == 0) {
             struct plinemsg_type *next = tmp->next;
 
-            regex_free(tmp->regex);
+            if (tmp->regex)
+                regex_free(tmp->regex);
             free((genericptr_t) tmp->pattern);
             free((genericptr_t) tmp);
             if (prev)
                 prev->next = next;
             else
                 plinemsg_types = next;
+            regex_set_free(&msgtype_set);
             return;
         }
         idx--;
@@ -1582,15 +2041,14 @@ msgtype_type(msg, norepeat)
 const char *msg;
 boolean norepeat; /* called from Norep(via pline) */
 {
-    struct plinemsg_type *tmp = plinemsg_types;
+    int i;
 
-    while (tmp) {
-        /* we don't exclude entries with negative msgtype values
-           because then the msg might end up matching a later pattern */
-        if (regex_match(msg, tmp->regex))
-            return tmp->msgtype;
-        tmp = tmp->next;
-    }
+    if (plinemsg_types && !msgtype_set)
+        msgtype_set_build();
+    /* we don't exclude entries with negative msgtype values
+       because then the msg might end up matching a later pattern */
+    if ((i = regex_set_first(msgtype_set, msg)) >= 0)
+        return ((struct plinemsg_type *) msgtype_set->rule[i])->msgtype;
     return norepeat ? MSGTYP_NOREP : MSGTYP_NORMAL;
 }
 
@@ -1691,20 +2149,27 @@ int c, a;
     if (!str)
         return FALSE;
     tmp = (struct menucoloring *) alloc(sizeof (struct menucoloring));
-    tmp->match = regex_init();
-    if (!regex_compile(str, tmp->match)) {
-        config_error_add("%s: %s", re_error, regex_error_desc(tmp->match));
-        regex_free(tmp->match);
-        free(tmp);
-        return FALSE;
-    } else {
-        tmp->next = menu_colorings;
-        tmp->origstr = dupstr(str);
-        tmp->color = c;
-        tmp->attr = a;
-        menu_colorings = tmp;
-        return TRUE;
+    tmp->match = (struct nhregex *) 0;
+    if (!regex_deferred) {
+        tmp->match = regex_init();
+        if (!regex_compile(str, tmp->match)) {
+            config_error_add("%s: %s", re_error,
+                             regex_error_desc(tmp->match));
+            regex_free(tmp->match);
+            free(tmp);
+            return FALSE;
+        }
     }
+    tmp->next = menu_colorings;
+    tmp->origstr = dupstr(str);
+    tmp->color = c;
+    tmp->attr = a;
+    menu_colorings = tmp;
+    regex_set_free(&menucolor_set);
+    if (regex_deferred)
+        defer_rule_regex(RULE_MENUCOLOR, (genericptr_t) tmp, &tmp->match,
+                         tmp->origstr);
+    return TRUE;
 }
 
 /* parse '"regex_string"=color&attr' and add it to menucoloring */
@@ -1761,17 +2226,38 @@ const char *str;
 int *color, *attr;
 {
     struct menucoloring *tmpmc;
+    int i;
 
-    if (iflags.use_menu_color)
-        for (tmpmc = menu_colorings; tmpmc; tmpmc = tmpmc->next)
-            if (regex_match(str, tmpmc->match)) {
-                *color = tmpmc->color;
-                *attr = tmpmc->attr;
-                return TRUE;
-            }
+    if (iflags.use_menu_color && menu_colorings) {
+        if (!menucolor_set)
+            menucolor_set_build();
+        if ((i = regex_set_first(menucolor_set, str)) >= 0) {
+            tmpmc = (struct menucoloring *) menucolor_set->rule[i];
+            *color = tmpmc->color;
+            *attr = tmpmc->attr;
+            return TRUE;
+        }
+    }
     return FALSE;
 }
 
+STATIC_OVL void
+menucolor_set_build()
+{
+    struct menucoloring *tmp;
+    int n = 0;
+
+    for (tmp = menu_colorings; tmp; tmp = tmp->next)
+        n++;
+    menucolor_set = regex_set_alloc(n);
+    for (n = 0, tmp = menu_colorings; tmp; tmp = tmp->next, n++) {
+        menucolor_set->leaf[n] = &tmp->match;
+        menucolor_set->pat[n] = tmp->origstr;
+        menucolor_set->rule[n] = (genericptr_t) tmp;
+    }
+    regex_set_build(menucolor_set, 1, 0, n);
+}
+
 void
 free_menu_coloring()
 {
@@ -1780,11 +2266,14 @@ free_menu_coloring()
     while (tmp) {
         struct menucoloring *tmp2 = tmp->next;
 
-        regex_free(tmp->match);
+        if (tmp->match)
+            regex_free(tmp->match);
         free((genericptr_t) tmp->origstr);
         free((genericptr_t) tmp);
         tmp = tmp2;
     }
+    menu_colorings = (struct menucoloring *) 0;
+    regex_set_free(&menucolor_set);
 }
 
 STATIC_OVL void
@@ -1798,13 +2287,15 @@ int idx; /* 0 .. */
         if (idx == 0) {
             struct menucoloring *next = tmp->next;
 
-            regex_free(tmp->match);
+            if (tmp->match)
+                regex_free(tmp->match);
             free((genericptr_t) tmp->origstr);
             free((genericptr_t) tmp);
             if (prev)
                 prev->next = next;
             else
                 menu_colorings = next;
+            regex_set_free(&menucolor_set);
             return;
         }
         idx--;
@@ -1928,6 +2419,10 @@ boolean tinitial, tfrom_file;
         negated = !negated;
     }
 
+    /* a boolean given by its full name needn't wait for the rest */
+    if ((i = boolopt_lookup(opts)) >= 0)
+        goto boolopt_found;
+
     /* variant spelling */
 
     if (match_optname(opts, "colour", 5, FALSE))
@@ -3678,6 +4173,7 @@ boolean tinitial, tfrom_file;
      */
     for (i = 0; boolopt[i].name; i++) {
         if (match_optname(opts, boolopt[i].name, 3, TRUE)) {
+ boolopt_found:
             /* options that don't exist */
             if (!boolopt[i].addr) {
                 if (!initial && !negated)
@@ -3777,6 +4273,7 @@ boolean tinitial, tfrom_file;
 #endif
 #ifdef TEXTCOLOR
             } else if (boolopt[i].addr == &iflags.use_color) {
+                reset_glyphmap();
                 need_redraw = TRUE;
 #ifdef TOS
                 if (iflags.BIOS) {
@@ -5554,13 +6051,16 @@ const char *mapping;
     }
 
     ape = (struct autopickup_exception *) alloc(sizeof *ape);
-    ape->regex = regex_init();
-    if (!regex_compile(text, ape->regex)) {
-        config_error_add("%s: %s", APE_regex_error,
-                         regex_error_desc(ape->regex));
-        regex_free(ape->regex);
-        free((genericptr_t) ape);
-        return 0;
+    ape->regex = (struct nhregex *) 0;
+    if (!regex_deferred) {
+        ape->regex = regex_init();
+        if (!regex_compile(text, ape->regex)) {
+            config_error_add("%s: %s", APE_regex_error,
+                             regex_error_desc(ape->regex));
+            regex_free(ape->regex);
+            free((genericptr_t) ape);
+            return 0;
+        }
     }
     apehead = (grab) ? &iflags.autopickup_exceptions[AP_GRAB]
                      : &iflags.autopickup_exceptions[AP_LEAVE];
@@ -5569,6 +6069,10 @@ const char *mapping;
     ape->grab = grab;
     ape->next = *apehead;
     *apehead = ape;
+    regex_set_free(&ape_set[grab ? AP_GRAB : AP_LEAVE]);
+    if (regex_deferred)
+        defer_rule_regex(RULE_APE, (genericptr_t) ape, &ape->regex,
+                         ape->pattern);
     return 1;
 }
 
@@ -5588,9 +6092,11 @@ struct autopickup_exception *whichape;
                 prev->next = ape;
             else
                 iflags.autopickup_exceptions[chain] = ape;
-            regex_free(freeape->regex);
+            if (freeape->regex)
+                regex_free(freeape->regex);
             free((genericptr_t) freeape->pattern);
             free((genericptr_t) freeape);
+            regex_set_free(&ape_set[chain]);
         } else {
             prev = ape;
             ape = ape->next;
@@ -5629,14 +6135,50 @@ free_autopickup_exceptions()
 
     for (pass = AP_LEAVE; pass <= AP_GRAB; ++pass) {
         while ((ape = iflags.autopickup_exceptions[pass]) != 0) {
-            regex_free(ape->regex);
+            if (ape->regex)
+                regex_free(ape->regex);
             free((genericptr_t) ape->pattern);
             iflags.autopickup_exceptions[pass] = ape->next;
             free((genericptr_t) ape);
         }
+        regex_set_free(&ape_set[pass]);
     }
 }
 
+STATIC_OVL void
+ape_set_build(pass)
+int pass;
+{
+    struct autopickup_exception *ape;
+    int n = 0;
+
+    for (ape = iflags.autopickup_exceptions[pass]; ape; ape = ape->next)
+        n++;
+    ape_set[pass] = regex_set_alloc(n);
+    for (n = 0, ape = iflags.autopickup_exceptions[pass]; ape;
+         ape = ape->next, n++) {
+        ape_set[pass]->leaf[n] = &ape->regex;
+        ape_set[pass]->pat[n] = ape->pattern;
+        ape_set[pass]->rule[n] = (genericptr_t) ape;
+    }
+    regex_set_build(ape_set[pass], 1, 0, n);
+}
+
+/* does objdesc match one of the autopickup exceptions of this kind? */
+boolean
+match_autopickup_exception(objdesc, grab)
+const char *objdesc;
+boolean grab;
+{
+    int pass = grab ? AP_GRAB : AP_LEAVE;
+
+    if (!iflags.autopickup_exceptions[pass])
+        return FALSE;
+    if (!ape_set[pass])
+        ape_set_build(pass);
+    return (boolean) (regex_set_first(ape_set[pass], objdesc) >= 0);
+}
+
 /* bundle some common usage into one easy-to-use routine */
 int
 load_symset(s, which_set)
@@ -5956,6 +6498,7 @@ struct fruit *replace_fruit;
                update it in place rather than looking it up again */
             f = replace_fruit;
             copynchars(f->fname, str, PL_FSIZ - 1);
+            objnam_changed(); /* existing slime molds get the new name */
             goto nonew;
         }
     } else {
@@ -45,6 +45,19 @@ STATIC_DCL boolean NDECL(reverse_loot);
 STATIC_DCL boolean FDECL(mon_beside, (int, int));
 STATIC_DCL int FDECL(do_loot_cont, (struct obj **, int, int));
 STATIC_DCL void FDECL(tipcontainer, (struct obj *));
+STATIC_DCL void FDECL(objlist_fill, (genericptr_t, int, menu_fill *));
+
+/* query_objlist()'s menu lines, formatted by objlist_fill() on demand */
+struct objlist_line {
+    struct obj *obj; /* null for a heading */
+    char let;        /* accelerator, or object class for a heading */
+};
+
+struct objlist_menu {
+    struct objlist_line *lines;
+    struct obj *hero; /* stands for the engulfed hero */
+    int how;
+};
 
 /* define for query_objlist() and autopickup() */
 #define FOLLOW(curr, flags) \
@@ -304,14 +317,13 @@ STATIC_OVL void
 check_here(picked_some)
 boolean picked_some;
 {
-    register struct obj *obj;
-    register int ct = 0;
+    register int ct;
 
     /* count the objects here */
-    for (obj = level.objects[u.ux][u.uy]; obj; obj = obj->nexthere) {
-        if (obj != uchain)
-            ct++;
-    }
+    ct = (int) pile_at(u.ux, u.uy)->count;
+    if (uchain && uchain->where == OBJ_FLOOR && uchain->ox == u.ux
+        && uchain->oy == u.uy)
+        ct--;
 
     /* If there are objects here, take a look. */
     if (ct) {
@@ -596,6 +608,7 @@ int what; /* should be a long */
 
     menu_pickup:
         n_tried = n;
+        begin_invbatch(TRUE);
         for (n_picked = i = 0; i < n; i++) {
             res = pickup_object(pick_list[i].item.a_obj, pick_list[i].count,
                                 FALSE);
@@ -603,6 +616,7 @@ int what; /* should be a long */
                 break; /* can't continue */
             n_picked += res;
         }
+        end_invbatch();
         if (pick_list)
             free((genericptr_t) pick_list);
 
@@ -727,20 +741,9 @@ boolean grab; /* forced pickup, rather than forced leave behind? */
     /*
      *  Does the text description of this match an exception?
      */
-    struct autopickup_exception
-        *ape = (grab) ? iflags.autopickup_exceptions[AP_GRAB]
-                      : iflags.autopickup_exceptions[AP_LEAVE];
-
-    if (ape) {
-        char *objdesc = makesingular(doname(obj));
-
-        while (ape) {
-            if (regex_match(objdesc, ape->regex))
-                return TRUE;
-            ape = ape->next;
-        }
-    }
-    return FALSE;
+    if (!iflags.autopickup_exceptions[grab ? AP_GRAB : AP_LEAVE])
+        return FALSE;
+    return match_autopickup_exception(makesingular(doname(obj)), grab);
 }
 
 boolean
@@ -841,11 +844,11 @@ menu_item **pick_list;            /* return list of items picked */
 int how;                          /* type of query */
 boolean FDECL((*allow), (OBJ_P)); /* allow function */
 {
-    int i, n;
+    int i, n, nlines;
     winid win;
     struct obj *curr, *last, fake_hero_object, *olist = *olist_p;
+    struct objlist_menu om;
     char *pack;
-    anything any;
     boolean printed_type_name, first,
             sorted = (qflags & INVORDER_SORT) != 0,
             engulfer = (qflags & INCLUDE_HERO) != 0;
@@ -887,15 +890,19 @@ boolean FDECL((*allow), (OBJ_P)); /* allow function */
         *olist_p = olist;
     }
 
-    win = create_nhwindow(NHW_MENU);
-    start_menu(win);
-    any = zeroany;
     /*
-     * Run through the list and add the objects to the menu.  If
-     * INVORDER_SORT is set, we'll run through the list once for
+     * Run through the list and collect the menu's lines; the objects
+     * are only formatted when (or if) the window port displays them.
+     * If INVORDER_SORT is set, we'll run through the list once for
      * each type so we can group them.  The allow function will only
-     * be called once per object in the list.
+     * be called once per object in the list.  Each object may need a
+     * heading, plus two more lines for the engulfed hero.
      */
+    om.lines = (struct objlist_line *) alloc((2 * n + 2)
+                                             * sizeof (struct objlist_line));
+    om.hero = &fake_hero_object;
+    om.how = how;
+    nlines = 0;
     pack = flags.inv_order;
     first = TRUE;
     do {
@@ -905,28 +912,22 @@ boolean FDECL((*allow), (OBJ_P)); /* allow function */
                 continue;
             if ((qflags & FEEL_COCKATRICE) && curr->otyp == CORPSE
                 && will_feel_cockatrice(curr, FALSE)) {
-                destroy_nhwindow(win); /* stop the menu and revert */
+                free((genericptr_t) om.lines); /* stop the menu and revert */
                 (void) look_here(0, FALSE);
                 return 0;
             }
             if ((*allow)(curr)) {
                 /* if sorting, print type name (once only) */
                 if (sorted && !printed_type_name) {
-                    any = zeroany;
-                    add_menu(win, NO_GLYPH, &any, 0, 0, iflags.menu_headings,
-                             let_to_name(*pack, FALSE,
-                                         ((how != PICK_NONE)
-                                          && iflags.menu_head_objsym)),
-                             MENU_UNSELECTED);
+                    om.lines[nlines].obj = (struct obj *) 0;
+                    om.lines[nlines++].let = *pack;
                     printed_type_name = TRUE;
                 }
 
-                any.a_obj = curr;
-                add_menu(win, obj_to_glyph(curr), &any,
-                         (qflags & USE_INVLET) ? curr->invlet
-                           : (first && curr->oclass == COIN_CLASS) ? '$' : 0,
-                         def_oc_syms[(int) objects[curr->otyp].oc_class].sym,
-                         ATR_NONE, doname_with_price(curr), MENU_UNSELECTED);
+                om.lines[nlines].obj = curr;
+                om.lines[nlines++].let =
+                    (qflags & USE_INVLET) ? curr->invlet
+                      : (first && curr->oclass == COIN_CLASS) ? '$' : 0;
                 first = FALSE;
             }
         }
@@ -934,27 +935,23 @@ boolean FDECL((*allow), (OBJ_P)); /* allow function */
     } while (sorted && *pack);
 
     if (engulfer) {
-        char buf[BUFSZ];
-
-        any = zeroany;
         if (sorted && n > 1) {
-            Sprintf(buf, "%s Creatures",
-                    is_animal(u.ustuck->data) ? "Swallowed" : "Engulfed");
-            add_menu(win, NO_GLYPH, &any, 0, 0, iflags.menu_headings, buf,
-                     MENU_UNSELECTED);
+            om.lines[nlines].obj = (struct obj *) 0;
+            om.lines[nlines++].let = 0;
         }
         fake_hero_object = zeroobj;
         fake_hero_object.quan = 1L; /* not strictly necessary... */
-        any.a_obj = &fake_hero_object;
-        add_menu(win, mon_to_glyph(&youmonst), &any,
-                 /* fake inventory letter, no group accelerator */
-                 CONTAINED_SYM, 0, ATR_NONE, an(self_lookat(buf)),
-                 MENU_UNSELECTED);
+        om.lines[nlines].obj = &fake_hero_object;
+        om.lines[nlines++].let = CONTAINED_SYM;
     }
 
+    win = create_nhwindow(NHW_MENU);
+    start_menu(win);
+    add_menu_items(win, nlines, objlist_fill, (genericptr_t) &om);
     end_menu(win, qstr);
     n = select_menu(win, how, pick_list);
     destroy_nhwindow(win);
+    free((genericptr_t) om.lines);
 
     if (n > 0) {
         menu_item *mi;
@@ -990,6 +987,48 @@ boolean FDECL((*allow), (OBJ_P)); /* allow function */
     return n;
 }
 
+STATIC_OVL void
+objlist_fill(arg, idx, mf)
+genericptr_t arg;
+int idx;
+menu_fill *mf;
+{
+    struct objlist_menu *om = (struct objlist_menu *) arg;
+    struct objlist_line *ol = &om->lines[idx];
+    struct obj *otmp = ol->obj;
+    char buf[BUFSZ];
+
+    if (!otmp) {
+        mf->attr = iflags.menu_headings;
+        if (!mf->str)
+            return;
+        if (ol->let)
+            Strcpy(mf->str, let_to_name(ol->let, FALSE,
+                                        ((om->how != PICK_NONE)
+                                         && iflags.menu_head_objsym)));
+        else
+            Sprintf(mf->str, "%s Creatures",
+                    is_animal(u.ustuck->data) ? "Swallowed" : "Engulfed");
+    } else if (otmp == om->hero) {
+        mf->glyph = mon_to_glyph(&youmonst);
+        mf->identifier.a_obj = otmp;
+        /* fake inventory letter, no group accelerator */
+        mf->accelerator = CONTAINED_SYM;
+        if (mf->str)
+            Strcpy(mf->str, an(self_lookat(buf)));
+    } else {
+        mf->glyph = obj_to_glyph(otmp);
+        mf->identifier.a_obj = otmp;
+        mf->accelerator = ol->let;
+        mf->groupacc = def_oc_syms[(int) objects[otmp->otyp].oc_class].sym;
+        if (mf->str)
+            Strcpy(mf->str, doname_with_price(otmp));
+        else
+            /* it's been listed even if its line is never shown */
+            objname_observe(otmp);
+    }
+}
+
 /*
  * allow menu-based category (class) selection (for Drop,take off etc.)
  *
@@ -1514,7 +1553,7 @@ struct obj *otmp;
     boolean robshop = (!u.uswallow && otmp != uball && costly_spot(ox, oy));
 
     obj_extract_self(otmp);
-    newsym(ox, oy);
+    invbatch_newsym(ox, oy);
 
     /* for shop items, addinv() needs to be after addtobill() (so that
        object merger can take otmp->unpaid into account) but before
@@ -1594,6 +1633,8 @@ encumber_msg()
         }
         context.botl = 1;
     }
+    if (newcap != oldcap)
+        status_dirty(BL_DIRTY_CAP);
 
     oldcap = newcap;
     return newcap;
@@ -1605,18 +1646,9 @@ container_at(x, y, countem)
 int x, y;
 boolean countem;
 {
-    struct obj *cobj, *nobj;
-    int container_count = 0;
+    int container_count = (int) pile_at(x, y)->containers;
 
-    for (cobj = level.objects[x][y]; cobj; cobj = nobj) {
-        nobj = cobj->nexthere;
-        if (Is_container(cobj)) {
-            container_count++;
-            if (!countem)
-                break;
-        }
-    }
-    return container_count;
+    return (countem || !container_count) ? container_count : 1;
 }
 
 STATIC_OVL boolean
@@ -14,51 +14,154 @@ static char *FDECL(You_buf, (int));
 #if defined(MSGHANDLER) && (defined(POSIX_TYPES) || defined(__GNUC__))
 static void FDECL(execplinehandler, (const char *));
 #endif
+STATIC_DCL void NDECL(msghist_drop);
+STATIC_DCL void FDECL(msghist_tagged, (int));
+
+/*
+ * Message history.  Every remembered message is copied once into
+ * msgarena[], a fixed circular buffer, and described by a record in
+ * msgrecs[], a ring of records in the order they were added.  When
+ * either fills up, the oldest records are dropped to make room, so
+ * keeping more history costs no extra memory and nothing is malloc'd
+ * or freed per message.
+ *
+ * A record is tagged with the consumers which want it: MSGH_DUMPLOG
+ * for the raw stream of messages written to the dumplog, MSGH_PREV
+ * for what the interface showed on its message line (for ^P and the
+ * save file).  Those usually coincide, so when an interface hands back
+ * a message which was just logged, the existing record gets the extra
+ * tag instead of a second copy of the text.  Consumers get pointers
+ * into the arena, valid until the record is dropped.
+ */
+#define MSGHIST_ARENA 32768 /* bytes of message text */
+#define MSGHIST_RECS 512    /* messages */
+
+static char msgarena[MSGHIST_ARENA];
+static struct msgrec {
+    unsigned off;        /* text is at msgarena[off] */
+    unsigned short len;  /* strlen() of text */
+    unsigned char tags;  /* MSGH_xxx */
+} msgrecs[MSGHIST_RECS];
+static int msgrec_first = 0, msgrec_ct = 0; /* oldest record, record count */
+static unsigned msgarena_next = 0;           /* where the next text goes */
+static unsigned long msgh_added[2] = { 0L, 0L }; /* per tag, ever */
+
+#define MSGREC(i) msgrecs[(msgrec_first + (i)) % MSGHIST_RECS]
+
+STATIC_OVL void
+msghist_drop()
+{
+    msgrec_first = (msgrec_first + 1) % MSGHIST_RECS;
+    --msgrec_ct;
+}
 
-#ifdef DUMPLOG
-/* also used in end.c */
-unsigned saved_pline_index = 0; /* slot in saved_plines[] to use next */
-char *saved_plines[DUMPLOG_MSG_COUNT] = { (char *) 0 };
+STATIC_OVL void
+msghist_tagged(tags)
+int tags;
+{
+    if (tags & MSGH_DUMPLOG)
+        ++msgh_added[0];
+    if (tags & MSGH_PREV)
+        ++msgh_added[1];
+}
 
-/* keep the most recent DUMPLOG_MSG_COUNT messages */
+/* remember msg for the consumers in tags */
 void
-dumplogmsg(line)
-const char *line;
+msghist_add(msg, tags)
+const char *msg;
+int tags;
 {
-    /*
-     * TODO:
-     *  This essentially duplicates message history, which is
-     *  currently implemented in an interface-specific manner.
-     *  The core should take responsibility for that and have
-     *  this share it.
-     */
-    unsigned indx = saved_pline_index; /* next slot to use */
-    char *oldest = saved_plines[indx]; /* current content of that slot */
-
-    if (oldest && strlen(oldest) >= strlen(line)) {
-        /* this buffer will gradually shrink until the 'else' is needed;
-           there's no pressing need to track allocation size instead */
-        Strcpy(oldest, line);
-    } else {
-        if (oldest)
-            free((genericptr_t) oldest);
-        saved_plines[indx] = dupstr(line);
+    struct msgrec *rec;
+    unsigned len = (unsigned) strlen(msg), need;
+    int i;
+
+    if (len > BUFSZ - 1)
+        len = BUFSZ - 1;
+    /* look back for this message among those not yet given these tags */
+    for (i = msgrec_ct - 1; i >= 0 && i >= msgrec_ct - 8; --i) {
+        rec = &MSGREC(i);
+        if ((rec->tags & tags) != 0)
+            break;
+        if (rec->len == len && !strncmp(&msgarena[rec->off], msg, len)) {
+            rec->tags |= tags;
+            msghist_tagged(tags);
+            return;
+        }
+    }
+
+    need = len + 1;
+    if (msgarena_next + need > MSGHIST_ARENA) {
+        /* no room at the end; drop whatever was there and wrap */
+        while (msgrec_ct && MSGREC(0).off >= msgarena_next)
+            msghist_drop();
+        msgarena_next = 0;
     }
-    saved_pline_index = (indx + 1) % DUMPLOG_MSG_COUNT;
+    while (msgrec_ct && MSGREC(0).off >= msgarena_next
+           && MSGREC(0).off < msgarena_next + need)
+        msghist_drop();
+    if (msgrec_ct == MSGHIST_RECS)
+        msghist_drop();
+
+    rec = &MSGREC(msgrec_ct);
+    ++msgrec_ct;
+    rec->off = msgarena_next;
+    rec->len = (unsigned short) len;
+    rec->tags = (unsigned char) tags;
+    (void) strncpy(&msgarena[rec->off], msg, len);
+    msgarena[rec->off + len] = '\0';
+    msgarena_next += need;
+    msghist_tagged(tags);
+}
+
+/* the n'th most recent message with tag (0 for the latest), or null */
+const char *
+msghist_get(tag, n)
+int tag, n;
+{
+    int i;
+
+    for (i = msgrec_ct - 1; i >= 0; --i)
+        if ((MSGREC(i).tags & tag) != 0 && n-- == 0)
+            return &msgarena[MSGREC(i).off];
+    return (const char *) 0;
+}
+
+/* number of messages with tag still being remembered */
+int
+msghist_count(tag)
+int tag;
+{
+    int i, ct = 0;
+
+    for (i = 0; i < msgrec_ct; ++i)
+        if ((MSGREC(i).tags & tag) != 0)
+            ++ct;
+    return ct;
+}
+
+/* number of messages ever given tag; lets a caller tell whether
+   something it called added one */
+unsigned long
+msghist_serial(tag)
+int tag;
+{
+    return msgh_added[(tag & MSGH_PREV) ? 1 : 0];
 }
 
-/* called during save (unlike the interface-specific message history,
-   this data isn't saved and restored); end-of-game releases saved_pline[]
-   while writing its contents to the final dump log */
 void
-dumplogfreemessages()
+msghist_clear()
 {
-    unsigned indx;
+    msgrec_first = msgrec_ct = 0;
+    msgarena_next = 0;
+}
 
-    for (indx = 0; indx < DUMPLOG_MSG_COUNT; ++indx)
-        if (saved_plines[indx])
-            free((genericptr_t) saved_plines[indx]), saved_plines[indx] = 0;
-    saved_pline_index = 0;
+#ifdef DUMPLOG
+/* keep a message for the dumplog */
+void
+dumplogmsg(line)
+const char *line;
+{
+    msghist_add(line, MSGH_DUMPLOG);
 }
 #endif
 
@@ -2029,6 +2029,7 @@ dodip()
             }
         }
         obj->odiluted = (obj->otyp != POT_WATER);
+        invent_changed();
 
         if (obj->otyp == POT_WATER && !Hallucination) {
             pline_The("mixture bubbles%s.", Blind ? "" : ", then clears");
@@ -2143,6 +2144,7 @@ more_dips:
         if ((obj->otyp == MAGIC_LAMP) && obj->spe == 0) {
             obj->otyp = OIL_LAMP;
             obj->age = 0;
+            invent_changed();
         }
         if (obj->age > 1000L) {
             pline("%s %s full.", Yname2(obj), otense(obj, "are"));
@@ -2184,6 +2186,8 @@ more_dips:
 
         costly_alteration(singlepotion, COST_NUTRLZ);
         singlepotion->otyp = mixture;
+        if (carried(singlepotion))
+            invent_changed();
         singlepotion->blessed = 0;
         if (mixture == POT_WATER)
             singlepotion->cursed = singlepotion->odiluted = 0;
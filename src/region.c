@@ -383,6 +383,7 @@ run_regions()
     register int i, j, k;
     int f_indx;
 
+    PERF_START(PERF_REGIONS);
     /* End of life ? */
     /* Do it backward because the array will be modified */
     for (i = n_regions - 1; i >= 0; i--) {
@@ -419,6 +420,7 @@ run_regions()
             }
         }
     }
+    PERF_STOP(PERF_REGIONS);
 }
 
 /*
@@ -60,21 +60,12 @@ static struct restore_procs {
 /*
  * Save a mapping of IDs from ghost levels to the current level.  This
  * map is used by the timer routines when restoring ghost levels.
+ * Ghost ID -> new ID (in a_uint).
  */
-#define N_PER_BUCKET 64
-struct bucket {
-    struct bucket *next;
-    struct {
-        unsigned gid; /* ghost ID */
-        unsigned nid; /* new ID */
-    } map[N_PER_BUCKET];
-};
-
 STATIC_DCL void NDECL(clear_id_mapping);
 STATIC_DCL void FDECL(add_id_mapping, (unsigned, unsigned));
 
-static int n_ids_mapped = 0;
-static struct bucket *id_map = 0;
+static struct id_table id_map;
 
 #ifdef AMII_GRAPHICS
 void FDECL(amii_setpens, (int)); /* use colors from save file */
@@ -100,6 +91,7 @@ find_lev_obj()
     for (x = 0; x < COLNO; x++)
         for (y = 0; y < ROWNO; y++)
             level.objects[x][y] = (struct obj *) 0;
+    (void) memset((genericptr_t) level.piles, 0, sizeof level.piles);
 
     /*
      * Reverse the entire fobj chain, which is necessary so that we can
@@ -287,6 +279,7 @@ boolean ghostly, frozen;
             add_id_mapping(otmp->o_id, nid);
             otmp->o_id = nid;
         }
+        obj_id_register(otmp);
         if (ghostly && otmp->otyp == SLIME_MOLD)
             ghostfruit(otmp);
         /* Ghost levels get object age shifted from old player's clock
@@ -409,6 +402,7 @@ boolean ghostly;
             add_id_mapping(mtmp->m_id, nid);
             mtmp->m_id = nid;
         }
+        mon_id_register(mtmp);
         offset = mtmp->mnum;
         mtmp->data = &mons[offset];
         if (ghostly) {
@@ -603,6 +597,7 @@ unsigned int *stuckid, *steedid;
     restore_timers(fd, RANGE_GLOBAL, FALSE, 0L);
     restore_light_sources(fd);
     invent = restobjchn(fd, FALSE, FALSE);
+    invent_changed();
     /* tmp_bc only gets set here if the ball & chain were orphaned
        because you were swallowed; otherwise they will be on the floor
        or in your inventory */
@@ -649,6 +644,7 @@ unsigned int *stuckid, *steedid;
     mread(fd, (genericptr_t) spl_book, sizeof(struct spell) * (MAXSPELL + 1));
     restore_artifacts(fd);
     restore_oracles(fd);
+    restore_rngstate(fd);
     if (u.ustuck)
         mread(fd, (genericptr_t) stuckid, sizeof(*stuckid));
     if (u.usteed)
@@ -1193,13 +1189,7 @@ register int fd;
 STATIC_OVL void
 clear_id_mapping()
 {
-    struct bucket *curr;
-
-    while ((curr = id_map) != 0) {
-        id_map = curr->next;
-        free((genericptr_t) curr);
-    }
-    n_ids_mapped = 0;
+    idtab_clear(&id_map);
 }
 
 /* Add a mapping to the ID map. */
@@ -1207,20 +1197,11 @@ STATIC_OVL void
 add_id_mapping(gid, nid)
 unsigned gid, nid;
 {
-    int idx;
-
-    idx = n_ids_mapped % N_PER_BUCKET;
-    /* idx is zero on first time through, as well as when a new bucket is */
-    /* needed */
-    if (idx == 0) {
-        struct bucket *gnu = (struct bucket *) alloc(sizeof(struct bucket));
-        gnu->next = id_map;
-        id_map = gnu;
-    }
+    anything val;
 
-    id_map->map[idx].gid = gid;
-    id_map->map[idx].nid = nid;
-    n_ids_mapped++;
+    val = zeroany;
+    val.a_uint = nid;
+    idtab_add(&id_map, gid, &val);
 }
 
 /*
@@ -1232,27 +1213,12 @@ boolean
 lookup_id_mapping(gid, nidp)
 unsigned gid, *nidp;
 {
-    int i;
-    struct bucket *curr;
-
-    if (n_ids_mapped)
-        for (curr = id_map; curr; curr = curr->next) {
-            /* first bucket might not be totally full */
-            if (curr == id_map) {
-                i = n_ids_mapped % N_PER_BUCKET;
-                if (i == 0)
-                    i = N_PER_BUCKET;
-            } else
-                i = N_PER_BUCKET;
-
-            while (--i >= 0)
-                if (gid == curr->map[i].gid) {
-                    *nidp = curr->map[i].nid;
-                    return TRUE;
-                }
-        }
+    anything *val = idtab_find(&id_map, gid);
 
-    return FALSE;
+    if (!val)
+        return FALSE;
+    *nidp = val->a_uint;
+    return TRUE;
 }
 
 STATIC_OVL void
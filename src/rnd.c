@@ -3,19 +3,229 @@
 /* NetHack may be freely redistributed.  See license for details. */
 
 #include "hack.h"
+#include "lev.h"
 
-/* "Rand()"s definition is determined by [OS]conf.h */
-#if defined(LINT) && defined(UNIX) /* rand() is long... */
-extern int NDECL(rand);
-#define RND(x) (rand() % x)
-#else /* LINT */
-#if defined(UNIX) || defined(RANDOM)
-#define RND(x) ((int) (Rand() % (long) (x)))
-#else
-/* Good luck: the bottom order bits are cyclic. */
-#define RND(x) ((int) ((Rand() >> 3) % (x)))
+/*
+ * Random number streams.
+ *
+ * Rather than drawing everything from the system's Rand(), the game
+ * keeps several independent xoshiro128** generators, one per subsystem,
+ * so that a change in (say) monster movement doesn't perturb what the
+ * level generator produces from the same seed.  rn2() and friends draw
+ * from whichever stream is currently selected; callers which want a
+ * particular stream for a stretch of code use rng_select() and put the
+ * old selection back afterward.  Stream seeds may be fixed from the
+ * command line (-seed) and the full generator state is kept in the save
+ * file, so a restored game continues along the same sequences.
+ *
+ * Arithmetic is done in unsigned long and masked to 32 bits so that
+ * results don't depend on the width of long.
+ */
+#define RNG_MASK 0xffffffffUL
+#define RNG_ROTL(v, k) ((((v) << (k)) | ((v) >> (32 - (k)))) & RNG_MASK)
+
+struct rng_stream {
+    const char *name;
+    unsigned long seed;
+    unsigned long s[4];
+    boolean fixed; /* seed came from the command line; setrandom() keeps it */
+};
+
+static struct rng_stream rngs[NUM_RNG_STREAMS] = {
+    { "core", 0UL, { 0UL, 0UL, 0UL, 0UL }, FALSE },
+    { "levgen", 0UL, { 0UL, 0UL, 0UL, 0UL }, FALSE },
+    { "combat", 0UL, { 0UL, 0UL, 0UL, 0UL }, FALSE },
+    { "ai", 0UL, { 0UL, 0UL, 0UL, 0UL }, FALSE },
+    { "display", 0UL, { 0UL, 0UL, 0UL, 0UL }, FALSE },
+};
+static int cur_rng = RNG_CORE;
+
+STATIC_DCL unsigned long FDECL(rng_next, (struct rng_stream *));
+STATIC_DCL unsigned long FDECL(splitmix32, (unsigned long *));
+STATIC_DCL void FDECL(seed_stream, (struct rng_stream *, unsigned long));
+
+STATIC_OVL unsigned long
+rng_next(r)
+struct rng_stream *r;
+{
+    unsigned long *s = r->s;
+    unsigned long result, t;
+
+    result = (RNG_ROTL((s[1] * 5UL) & RNG_MASK, 7) * 9UL) & RNG_MASK;
+    t = (s[1] << 9) & RNG_MASK;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = RNG_ROTL(s[3], 11);
+    return result;
+}
+
+/* used to spread a single seed value across a stream's state words */
+STATIC_OVL unsigned long
+splitmix32(x)
+unsigned long *x;
+{
+    unsigned long z;
+
+    *x = (*x + 0x9e3779b9UL) & RNG_MASK;
+    z = *x;
+    z = ((z ^ (z >> 16)) * 0x85ebca6bUL) & RNG_MASK;
+    z = ((z ^ (z >> 13)) * 0xc2b2ae35UL) & RNG_MASK;
+    return z ^ (z >> 16);
+}
+
+STATIC_OVL void
+seed_stream(r, seed)
+struct rng_stream *r;
+unsigned long seed;
+{
+    unsigned long x = seed & RNG_MASK;
+    int i;
+
+    r->seed = x;
+    for (i = 0; i < 4; i++)
+        r->s[i] = splitmix32(&x);
+    /* all-zero state would be a fixed point */
+    if (!(r->s[0] | r->s[1] | r->s[2] | r->s[3]))
+        r->s[0] = 1UL;
+}
+
+/* seed every stream which wasn't given an explicit seed; each stream
+   gets its own value derived from the base seed */
+void
+init_rng_streams(seed)
+unsigned long seed;
+{
+    int i;
+
+    for (i = 0; i < NUM_RNG_STREAMS; i++)
+        if (!rngs[i].fixed)
+            seed_stream(&rngs[i], seed + (unsigned long) i * 0x6c078965UL);
+    cur_rng = RNG_CORE;
+}
+
+unsigned long
+rng_seed(which)
+int which;
+{
+    return rngs[which].seed;
+}
+
+const char *
+rng_name(which)
+int which;
+{
+    return rngs[which].name;
+}
+
+/* make 'which' the stream used by rn2() et al; returns the previous
+   selection so that the caller can put it back */
+int
+rng_select(which)
+int which;
+{
+    int old = cur_rng;
+
+    if (which >= 0 && which < NUM_RNG_STREAMS)
+        cur_rng = which;
+    return old;
+}
+
+/*
+ * Parse the value of the -seed command line option:
+ *      N                   seed all streams from base value N
+ *      name:N[,name:N...]  seed individual streams (name=N also accepted)
+ * Streams seeded here are left alone by setrandom().
+ */
+boolean
+parse_rng_seeds(opts)
+const char *opts;
+{
+    char buf[BUFSZ], *op, *nxt, *val;
+    unsigned long seed;
+    int i;
+
+    if (!opts || !*opts)
+        return FALSE;
+    copynchars(buf, opts, BUFSZ - 1);
+    if (digit(*buf)) {
+        seed = (unsigned long) atol(buf);
+        for (i = 0; i < NUM_RNG_STREAMS; i++)
+            rngs[i].fixed = FALSE;
+        init_rng_streams(seed);
+        for (i = 0; i < NUM_RNG_STREAMS; i++)
+            rngs[i].fixed = TRUE;
+        return TRUE;
+    }
+    for (op = buf; op && *op; op = nxt) {
+        if ((nxt = index(op, ',')) != 0)
+            *nxt++ = '\0';
+        if ((val = index(op, ':')) == 0 && (val = index(op, '=')) == 0)
+            return FALSE;
+        *val++ = '\0';
+        for (i = 0; i < NUM_RNG_STREAMS; i++)
+            if (!strcmpi(op, rngs[i].name))
+                break;
+        if (i == NUM_RNG_STREAMS || !digit(*val))
+            return FALSE;
+        seed_stream(&rngs[i], (unsigned long) atol(val));
+        rngs[i].fixed = TRUE;
+    }
+    return TRUE;
+}
+
+void
+save_rngstate(fd, mode)
+int fd, mode;
+{
+    unsigned long v[5];
+    int i;
+
+    if (!perform_bwrite(mode))
+        return;
+    for (i = 0; i < NUM_RNG_STREAMS; i++) {
+        v[0] = rngs[i].seed;
+        v[1] = rngs[i].s[0], v[2] = rngs[i].s[1];
+        v[3] = rngs[i].s[2], v[4] = rngs[i].s[3];
+        bwrite(fd, (genericptr_t) v, sizeof v);
+    }
+}
+
+void
+restore_rngstate(fd)
+int fd;
+{
+    unsigned long v[5];
+    int i;
+
+    for (i = 0; i < NUM_RNG_STREAMS; i++) {
+        mread(fd, (genericptr_t) v, sizeof v);
+        rngs[i].seed = v[0];
+        rngs[i].s[0] = v[1], rngs[i].s[1] = v[2];
+        rngs[i].s[2] = v[3], rngs[i].s[3] = v[4];
+    }
+    cur_rng = RNG_CORE;
+}
+
+#define RND(x) ((int) (rng_next(&rngs[cur_rng]) % (unsigned long) (x)))
+
+/* 0 <= rn2_on(which, x) < x, drawn from a specific stream regardless
+   of the current selection */
+int
+rn2_on(which, x)
+int which;
+register int x;
+{
+#ifdef BETA
+    if (x <= 0) {
+        impossible("rn2_on(%d,%d) attempted", which, x);
+        return 0;
+    }
 #endif
-#endif /* LINT */
+    return (int) (rng_next(&rngs[which]) % (unsigned long) x);
+}
 
 /* 0 <= rn2(x) < x */
 int
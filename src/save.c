@@ -319,6 +319,7 @@ register int fd, mode;
     savemonchn(fd, migrating_mons, mode);
     if (release_data(mode)) {
         invent = 0;
+        invent_changed();
         migrating_objs = 0;
         migrating_mons = 0;
     }
@@ -334,6 +335,7 @@ register int fd, mode;
            sizeof(struct spell) * (MAXSPELL + 1));
     save_artifacts(fd);
     save_oracles(fd, mode);
+    save_rngstate(fd, mode);
     if (ustuck_id)
         bwrite(fd, (genericptr_t) &ustuck_id, sizeof ustuck_id);
     if (usteed_id)
@@ -1341,6 +1343,7 @@ freedynamicdata()
     unload_qtlist();
     free_menu_coloring();
     free_invbuf();           /* let_to_name (invent.c) */
+    free_objnam_cache();     /* doname/xname cache (objnam.c) */
     free_youbuf();           /* You_buf,&c (pline.c) */
     msgtype_free();
     tmp_at(DISP_FREEMEM, 0); /* temporary display effects */
@@ -1391,6 +1394,10 @@ freedynamicdata()
     freenames();
     free_waterlevel();
     free_dungeons();
+    pool_trim(&obj_pool);
+    pool_trim(&oextra_pool);
+    pool_trim(&monst_pool);
+    pool_trim(&mextra_pool);
 
     /* some pointers in iflags */
     if (iflags.wc_font_map)
@@ -1410,13 +1417,12 @@ freedynamicdata()
     /* miscellaneous */
     /* free_pickinv_cache();  --  now done from really_done()... */
     free_symsets();
+    free_obj_ids(); /* after all the object and monster chains */
+    free_mon_ids();
 #endif /* FREE_ALL_MEMORY */
 #ifdef STATUS_HILITES
     status_finish();
 #endif
-#ifdef DUMPLOG
-    dumplogfreemessages();
-#endif
 
     /* last, because it frees data that might be used by panic() to provide
        feedback to the user; conceivably other freeing might trigger panic */
@@ -75,6 +75,17 @@ STATIC_DCL void FDECL(deserted_shop, (char *));
 STATIC_DCL boolean FDECL(special_stock, (struct obj *, struct monst *,
                                          BOOLEAN_P));
 STATIC_DCL const char *FDECL(cad, (BOOLEAN_P));
+struct billindex;
+STATIC_DCL void FDECL(bill_link, (struct billindex *, int));
+STATIC_DCL void FDECL(bill_unlink, (struct billindex *, int));
+STATIC_DCL struct billindex *FDECL(bill_index, (struct eshk *));
+STATIC_DCL struct bill_x *FDECL(bill_lookup, (struct eshk *, unsigned));
+STATIC_DCL long FDECL(bill_total, (struct eshk *));
+STATIC_DCL void FDECL(bill_append, (struct eshk *));
+STATIC_DCL void FDECL(bill_remove, (struct eshk *, struct bill_x *));
+STATIC_DCL void FDECL(bill_setquan, (struct eshk *, struct bill_x *, long));
+STATIC_DCL void FDECL(bill_setprice, (struct eshk *, struct bill_x *, long));
+STATIC_DCL void FDECL(bill_setid, (struct eshk *, struct bill_x *, unsigned));
 
 /*
         invariants: obj->unpaid iff onbill(obj) [unless bp->useup]
@@ -317,19 +328,206 @@ register struct monst *shkp;
     }
 }
 
+/*
+ * Bill index.  Looking an object up on a shopkeeper's bill and totalling
+ * the bill used to walk all of bill[], which made every onbill() call
+ * (and so every unpaid object being picked up, dropped, used up or
+ * listed) cost O(billct).  Each shopkeeper with a non-empty bill now has
+ * a hash from bo_id to bill slot plus a running total of price * bquan.
+ *
+ * struct eshk is saved as-is, so the index lives outside it: it is kept
+ * on a private list keyed by the eshk pointer and is rebuilt from the
+ * bill on first use (after restore, for instance) or whenever its entry
+ * count disagrees with billct.  Everything here that changes bo_id,
+ * bquan, price or billct goes through the bill_*() routines below so
+ * the index stays current; copy_mextra() and dealloc_mextra() call
+ * forget_bill_index() when they overwrite or free a struct eshk.
+ */
+#define BILLHASH 256 /* power of 2 */
+#define BILLBUCKET(id) ((unsigned) (id) & (BILLHASH - 1))
+
+struct billindex {
+    struct billindex *next;
+    struct eshk *eshkp;
+    int ct;               /* entries indexed; normally eshkp->billct */
+    long total;           /* sum of price * bquan over the bill */
+    short head[BILLHASH]; /* first entry in each bucket, plus 1 */
+    short chain[BILLSZ];  /* next entry in the same bucket, plus 1 */
+};
+
+static struct billindex *billindices = 0;
+
+STATIC_OVL void
+bill_link(bi, indx)
+struct billindex *bi;
+int indx;
+{
+    unsigned h = BILLBUCKET(bi->eshkp->bill[indx].bo_id);
+
+    bi->chain[indx] = bi->head[h];
+    bi->head[h] = (short) (indx + 1);
+}
+
+STATIC_OVL void
+bill_unlink(bi, indx)
+struct billindex *bi;
+int indx;
+{
+    short *sp = &bi->head[BILLBUCKET(bi->eshkp->bill[indx].bo_id)];
+
+    while (*sp) {
+        if (*sp == indx + 1) {
+            *sp = bi->chain[indx];
+            return;
+        }
+        sp = &bi->chain[*sp - 1];
+    }
+    impossible("bill_unlink: entry %d not indexed", indx);
+}
+
+/* find, or build, the index for eshkp's bill */
+STATIC_OVL struct billindex *
+bill_index(eshkp)
+struct eshk *eshkp;
+{
+    struct billindex *bi;
+    int i;
+
+    for (bi = billindices; bi; bi = bi->next)
+        if (bi->eshkp == eshkp)
+            break;
+    if (!bi) {
+        bi = (struct billindex *) alloc(sizeof (struct billindex));
+        bi->eshkp = eshkp;
+        bi->next = billindices;
+        billindices = bi;
+    } else if (bi->ct == eshkp->billct) {
+        return bi;
+    }
+    (void) memset((genericptr_t) bi->head, 0, sizeof bi->head);
+    bi->total = 0L;
+    for (i = 0; i < eshkp->billct; i++) {
+        bill_link(bi, i);
+        bi->total += eshkp->bill[i].price * eshkp->bill[i].bquan;
+    }
+    bi->ct = eshkp->billct;
+    return bi;
+}
+
+/* discard the index of an eshk which is about to be freed or overwritten */
+void
+forget_bill_index(eshkp)
+struct eshk *eshkp;
+{
+    struct billindex *bi, **bip;
+
+    for (bip = &billindices; (bi = *bip) != 0; bip = &bi->next)
+        if (bi->eshkp == eshkp) {
+            *bip = bi->next;
+            free((genericptr_t) bi);
+            return;
+        }
+}
+
+STATIC_OVL struct bill_x *
+bill_lookup(eshkp, id)
+struct eshk *eshkp;
+unsigned id;
+{
+    struct billindex *bi;
+    short e;
+
+    if (!eshkp->billct)
+        return (struct bill_x *) 0;
+    bi = bill_index(eshkp);
+    for (e = bi->head[BILLBUCKET(id)]; e; e = bi->chain[e - 1])
+        if (eshkp->bill[e - 1].bo_id == id)
+            return &eshkp->bill[e - 1];
+    return (struct bill_x *) 0;
+}
+
 STATIC_OVL long
-addupbill(shkp)
-register struct monst *shkp;
+bill_total(eshkp)
+struct eshk *eshkp;
 {
-    register int ct = ESHK(shkp)->billct;
-    register struct bill_x *bp = ESHK(shkp)->bill_p;
-    register long total = 0L;
+    return eshkp->billct ? bill_index(eshkp)->total : 0L;
+}
 
-    while (ct--) {
-        total += bp->price * bp->bquan;
-        bp++;
+/* bill[billct] has just been filled in; make it part of the bill */
+STATIC_OVL void
+bill_append(eshkp)
+struct eshk *eshkp;
+{
+    struct billindex *bi = bill_index(eshkp);
+    struct bill_x *bp = &eshkp->bill[eshkp->billct];
+
+    bill_link(bi, eshkp->billct);
+    bi->total += bp->price * bp->bquan;
+    bi->ct = ++eshkp->billct;
+}
+
+/* take bp off the bill; the last entry is moved into its slot */
+STATIC_OVL void
+bill_remove(eshkp, bp)
+struct eshk *eshkp;
+struct bill_x *bp;
+{
+    struct billindex *bi = bill_index(eshkp);
+    int indx = (int) (bp - eshkp->bill), last = eshkp->billct - 1;
+
+    bi->total -= bp->price * bp->bquan;
+    bill_unlink(bi, indx);
+    if (indx != last) {
+        bill_unlink(bi, last);
+        *bp = eshkp->bill[last];
+        bill_link(bi, indx);
     }
-    return total;
+    bi->ct = eshkp->billct = last;
+}
+
+STATIC_OVL void
+bill_setquan(eshkp, bp, quan)
+struct eshk *eshkp;
+struct bill_x *bp;
+long quan;
+{
+    struct billindex *bi = bill_index(eshkp);
+
+    bi->total += (quan - bp->bquan) * bp->price;
+    bp->bquan = quan;
+}
+
+STATIC_OVL void
+bill_setprice(eshkp, bp, price)
+struct eshk *eshkp;
+struct bill_x *bp;
+long price;
+{
+    struct billindex *bi = bill_index(eshkp);
+
+    bi->total += (price - bp->price) * bp->bquan;
+    bp->price = price;
+}
+
+STATIC_OVL void
+bill_setid(eshkp, bp, id)
+struct eshk *eshkp;
+struct bill_x *bp;
+unsigned id;
+{
+    struct billindex *bi = bill_index(eshkp);
+    int indx = (int) (bp - eshkp->bill);
+
+    bill_unlink(bi, indx);
+    bp->bo_id = id;
+    bill_link(bi, indx);
+}
+
+STATIC_OVL long
+addupbill(shkp)
+register struct monst *shkp;
+{
+    return bill_total(ESHK(shkp));
 }
 
 STATIC_OVL void
@@ -755,13 +953,7 @@ STATIC_OVL long
 shop_debt(eshkp)
 struct eshk *eshkp;
 {
-    struct bill_x *bp;
-    int ct;
-    long debt = eshkp->debit;
-
-    for (bp = eshkp->bill_p, ct = eshkp->billct; ct > 0; bp++, ct--)
-        debt += bp->price * bp->bquan;
-    return debt;
+    return eshkp->debit + bill_total(eshkp);
 }
 
 /* called in response to the `$' command */
@@ -860,16 +1052,13 @@ struct monst *shkp;
 boolean silent;
 {
     if (shkp) {
-        register struct bill_x *bp = ESHK(shkp)->bill_p;
-        register int ct = ESHK(shkp)->billct;
+        register struct bill_x *bp = bill_lookup(ESHK(shkp), obj->o_id);
 
-        while (--ct >= 0)
-            if (bp->bo_id == obj->o_id) {
-                if (!obj->unpaid)
-                    pline("onbill: paid obj on bill?");
-                return bp;
-            } else
-                bp++;
+        if (bp) {
+            if (!obj->unpaid)
+                pline("onbill: paid obj on bill?");
+            return bp;
+        }
     }
     if (obj->unpaid && !silent)
         pline("onbill: unpaid obj not on bill?");
@@ -948,18 +1137,8 @@ register struct obj *obj, *merge;
             return;
         } else {
             /* this was a merger */
-            bpm->bquan += bp->bquan;
-            ESHK(shkp)->billct--;
-#ifdef DUMB
-            {
-                /* DRS/NS 2.2.6 messes up -- Peter Kendell */
-                int indx = ESHK(shkp)->billct;
-
-                *bp = ESHK(shkp)->bill_p[indx];
-            }
-#else
-            *bp = ESHK(shkp)->bill_p[ESHK(shkp)->billct];
-#endif
+            bill_setquan(ESHK(shkp), bpm, bpm->bquan + bp->bquan);
+            bill_remove(ESHK(shkp), bp);
         }
     }
     if (obj->owornmask) {
@@ -1057,7 +1236,8 @@ register struct monst *shkp;
         ESHK(shkp)->surcharge = FALSE;
         while (ct-- > 0) {
             register long reduction = (bp->price + 3L) / 4L;
-            bp->price -= reduction; /* undo 33% increase */
+            /* undo 33% increase */
+            bill_setprice(ESHK(shkp), bp, bp->price - reduction);
             bp++;
         }
     }
@@ -1076,7 +1256,7 @@ register struct monst *shkp;
         ESHK(shkp)->surcharge = TRUE;
         while (ct-- > 0) {
             register long surcharge = (bp->price + 2L) / 3L;
-            bp->price += surcharge;
+            bill_setprice(ESHK(shkp), bp, bp->price + surcharge);
             bp++;
         }
     }
@@ -1528,7 +1708,7 @@ proceed:
                     }
                     if (itemize)
                         bot();
-                    *bp = eshkp->bill_p[--eshkp->billct];
+                    bill_remove(eshkp, bp);
                 }
             }
         }
@@ -1648,7 +1828,7 @@ boolean itemize;
     if (consumed) {
         if (quan != bp->bquan) {
             /* eliminate used-up portion; remainder is still unpaid */
-            bp->bquan = obj->quan;
+            bill_setquan(ESHK(shkp), bp, obj->quan);
             obj->unpaid = 1;
             bp->useup = 0;
             buy = PAY_SOME;
@@ -1932,30 +2112,24 @@ struct obj *
 find_oid(id)
 unsigned id;
 {
-    struct obj *obj;
-    struct monst *mon, *mmtmp[3];
-    int i;
-
-    /* first check various obj lists directly */
-    if ((obj = o_on(id, invent)) != 0)
-        return obj;
-    if ((obj = o_on(id, fobj)) != 0)
-        return obj;
-    if ((obj = o_on(id, level.buriedobjlist)) != 0)
-        return obj;
-    if ((obj = o_on(id, migrating_objs)) != 0)
-        return obj;
+    struct obj *obj, *top;
 
-    /* not found yet; check inventory for members of various monst lists */
-    mmtmp[0] = fmon;
-    mmtmp[1] = migrating_mons;
-    mmtmp[2] = mydogs; /* for use during level changes */
-    for (i = 0; i < 3; i++)
-        for (mon = mmtmp[i]; mon; mon = mon->nmon)
-            if ((obj = o_on(id, mon->minvent)) != 0)
-                return obj;
+    if ((obj = obj_by_id(id)) == 0)
+        return (struct obj *) 0;
 
-    /* not found at all */
+    /* the id index also knows about free objects and ones on billobjs;
+       only accept what's in inventory, on or under the floor, migrating,
+       or carried by a monster, possibly inside a container */
+    for (top = obj; top->where == OBJ_CONTAINED; top = top->ocontainer)
+        continue;
+    switch (top->where) {
+    case OBJ_INVENT:
+    case OBJ_FLOOR:
+    case OBJ_BURIED:
+    case OBJ_MIGRATING:
+    case OBJ_MINVENT:
+        return obj;
+    }
     return (struct obj *) 0;
 }
 
@@ -2293,7 +2467,7 @@ long amt; /* if 0, use regular shop pricing, otherwise force amount;
         if ((bp = onbill(obj, shkp, TRUE)) != 0) {
             new_price = !amt ? get_cost(obj, shkp) : (amt < 0L) ? -amt : amt;
             if (new_price > bp->price || amt < 0L) {
-                bp->price = new_price;
+                bill_setprice(ESHK(shkp), bp, new_price);
                 update_inventory();
             }
             break; /* done */
@@ -2371,7 +2545,7 @@ struct monst *shkp;
     } else
         bp->useup = 0;
     bp->price = get_cost(obj, shkp);
-    eshkp->billct++;
+    bill_append(eshkp);
     obj->unpaid = 1;
 }
 
@@ -2630,7 +2804,7 @@ register struct obj *obj, *otmp;
     if (bp->bquan == otmp->quan) {
         impossible("Zero quantity on bill??");
     }
-    bp->bquan -= otmp->quan;
+    bill_setquan(ESHK(shkp), bp, bp->bquan - otmp->quan);
 
     if (ESHK(shkp)->billct == BILLSZ)
         otmp->unpaid = 0;
@@ -2641,7 +2815,7 @@ register struct obj *obj, *otmp;
         bp->bquan = otmp->quan;
         bp->useup = 0;
         bp->price = tmp;
-        ESHK(shkp)->billct++;
+        bill_append(ESHK(shkp));
     }
 }
 
@@ -2660,25 +2834,18 @@ register struct monst *shkp;
             otmp = newobj();
             *otmp = *obj;
             otmp->oextra = (struct oextra *) 0;
-            bp->bo_id = otmp->o_id = context.ident++;
+            otmp->o_id = context.ident++;
+            bill_setid(ESHK(shkp), bp, otmp->o_id);
+            obj_id_register(otmp);
             otmp->where = OBJ_FREE;
-            otmp->quan = (bp->bquan -= obj->quan);
+            bill_setquan(ESHK(shkp), bp, bp->bquan - obj->quan);
+            otmp->quan = bp->bquan;
             otmp->owt = 0; /* superfluous */
             bp->useup = 1;
             add_to_billobjs(otmp);
             return;
         }
-        ESHK(shkp)->billct--;
-#ifdef DUMB
-        {
-            /* DRS/NS 2.2.6 messes up -- Peter Kendell */
-            int indx = ESHK(shkp)->billct;
-
-            *bp = ESHK(shkp)->bill_p[indx];
-        }
-#else
-        *bp = ESHK(shkp)->bill_p[ESHK(shkp)->billct];
-#endif
+        bill_remove(ESHK(shkp), bp);
         return;
     } else if (obj->unpaid) {
         impossible("sub_one_frombill: unpaid object not on bill");
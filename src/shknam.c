@@ -605,6 +605,7 @@ free_eshk(mtmp)
 struct monst *mtmp;
 {
     if (mtmp->mextra && ESHK(mtmp)) {
+        forget_bill_index(ESHK(mtmp));
         free((genericptr_t) ESHK(mtmp));
         ESHK(mtmp) = (struct eshk *) 0;
     }
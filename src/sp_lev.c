@@ -254,10 +254,13 @@ struct splevstack *st;
                     break;
                 case SPOVAR_VARIABLE:
                 case SPOVAR_STRING:
-                case SPOVAR_SEL:
                     Free(st->stackdata[i]->vardata.str);
                     st->stackdata[i]->vardata.str = NULL;
                     break;
+                case SPOVAR_SEL:
+                    Free(st->stackdata[i]->vardata.sel);
+                    st->stackdata[i]->vardata.sel = NULL;
+                    break;
                 }
                 Free(st->stackdata[i]);
                 st->stackdata[i] = NULL;
@@ -415,9 +418,11 @@ struct opvar *ov;
         break;
     case SPOVAR_VARIABLE:
     case SPOVAR_STRING:
-    case SPOVAR_SEL:
         Free(ov->vardata.str);
         break;
+    case SPOVAR_SEL:
+        Free(ov->vardata.sel);
+        break;
     default:
         impossible("Unknown opvar value type (%i)!", ov->spovartyp);
     }
@@ -463,9 +468,13 @@ struct opvar *ov;
         break;
     case SPOVAR_VARIABLE:
     case SPOVAR_STRING:
-    case SPOVAR_SEL:
         tmpov->vardata.str = dupstr(ov->vardata.str);
         break;
+    case SPOVAR_SEL:
+        tmpov->vardata.sel = (struct selectionvar *) alloc(
+                                               sizeof (struct selectionvar));
+        *tmpov->vardata.sel = *ov->vardata.sel;
+        break;
     default:
         impossible("Unknown push value type (%i)!", ov->spovartyp);
     }
@@ -2718,7 +2727,15 @@ sp_lev *lvl;
                 if (nsize)
                     Fread(opd, 1, nsize, fd);
                 opd[nsize] = 0;
-                ov->vardata.str = opd;
+                if (ov->spovartyp == SPOVAR_SEL) {
+                    /* file has one byte per map location; pack it */
+                    struct opvar *sel = selection_opvar(opd);
+
+                    ov->vardata.sel = sel->vardata.sel;
+                    Free(sel);
+                    Free(opd);
+                } else
+                    ov->vardata.str = opd;
                 break;
             }
             default:
@@ -3636,21 +3653,106 @@ struct sp_coder *coder;
     opvar_free(srcroom);
 }
 
+/*
+ * Selections are kept as packed bitmaps, one row of words per map row,
+ * so that the set operations, growing and random point picking can work
+ * a word at a time instead of a location at a time.
+ */
+#define SEL_MASK 0xffffffffUL
+/* valid bits in the last word of each row */
+#define SEL_LASTMASK                                          \
+    ((COLNO % SEL_WORDBITS)                                   \
+         ? (SEL_MASK >> (SEL_WORDBITS - (COLNO % SEL_WORDBITS))) \
+         : SEL_MASK)
+
+STATIC_DCL int FDECL(sel_popcount, (unsigned long));
+STATIC_DCL void FDECL(sel_row_shl1, (unsigned long *, unsigned long *));
+STATIC_DCL void FDECL(sel_row_shr1, (unsigned long *, unsigned long *));
+STATIC_DCL void FDECL(selection_setspan, (struct selectionvar *, int, int,
+                                          int));
+
+/* number of bits set in the low 32 bits of w */
+STATIC_OVL int
+sel_popcount(w)
+unsigned long w;
+{
+    w &= SEL_MASK;
+    w = w - ((w >> 1) & 0x55555555UL);
+    w = (w & 0x33333333UL) + ((w >> 2) & 0x33333333UL);
+    w = (w + (w >> 4)) & 0x0f0f0f0fUL;
+    return (int) (((w * 0x01010101UL) & SEL_MASK) >> 24);
+}
+
+/* out[x] = in[x - 1]: shift a row one location east */
+STATIC_OVL void
+sel_row_shl1(in, out)
+unsigned long *in, *out;
+{
+    int w;
+
+    for (w = SEL_ROWWORDS - 1; w >= 0; w--)
+        out[w] = ((in[w] << 1) | (w ? (in[w - 1] >> (SEL_WORDBITS - 1)) : 0))
+                 & SEL_MASK;
+    out[SEL_ROWWORDS - 1] &= SEL_LASTMASK;
+}
+
+/* out[x] = in[x + 1]: shift a row one location west */
+STATIC_OVL void
+sel_row_shr1(in, out)
+unsigned long *in, *out;
+{
+    int w;
+
+    for (w = 0; w < SEL_ROWWORDS; w++)
+        out[w] = ((in[w] >> 1)
+                  | ((w < SEL_ROWWORDS - 1)
+                         ? (in[w + 1] << (SEL_WORDBITS - 1)) : 0))
+                 & SEL_MASK;
+}
+
+/* add locations x1..x2 of row y */
+STATIC_OVL void
+selection_setspan(sel, x1, x2, y)
+struct selectionvar *sel;
+int x1, x2, y;
+{
+    int w, lo, hi;
+    unsigned long bits;
+
+    if (y < 0 || y >= ROWNO)
+        return;
+    if (x1 < 0)
+        x1 = 0;
+    if (x2 >= COLNO)
+        x2 = COLNO - 1;
+    for (w = x1 / SEL_WORDBITS; w <= x2 / SEL_WORDBITS && x1 <= x2; w++) {
+        lo = max(x1, w * SEL_WORDBITS) - w * SEL_WORDBITS;
+        hi = min(x2, w * SEL_WORDBITS + SEL_WORDBITS - 1) - w * SEL_WORDBITS;
+        bits = (SEL_MASK >> (SEL_WORDBITS - 1 - hi)) & (SEL_MASK << lo);
+        sel->row[y][w] |= bits & SEL_MASK;
+    }
+}
+
+/* new selection; if nbuf is given, it holds one byte per location in
+   the .lev file format (value + 1, column-major within rows) */
 struct opvar *
 selection_opvar(nbuf)
 char *nbuf;
 {
-    struct opvar *ov;
-    char buf[(COLNO * ROWNO) + 1];
+    struct opvar *ov = (struct opvar *) alloc(sizeof(struct opvar));
+    int i, len;
 
-    if (!nbuf) {
-        (void) memset(buf, 1, sizeof(buf));
-        buf[(COLNO * ROWNO)] = '\0';
-        ov = opvar_new_str(buf);
-    } else {
-        ov = opvar_new_str(nbuf);
-    }
     ov->spovartyp = SPOVAR_SEL;
+    ov->vardata.sel = (struct selectionvar *) alloc(
+                                               sizeof (struct selectionvar));
+    (void) memset((genericptr_t) ov->vardata.sel, 0,
+                  sizeof (struct selectionvar));
+    if (nbuf) {
+        len = (int) strlen(nbuf);
+        for (i = 0; i < len && i < COLNO * ROWNO; i++)
+            if (nbuf[i] > 1)
+                selection_setpoint(i % COLNO, i / COLNO, ov, 1);
+    }
     return ov;
 }
 
@@ -3664,7 +3766,8 @@ struct opvar *ov;
     if (x < 0 || y < 0 || x >= COLNO || y >= ROWNO)
         return 0;
 
-    return (ov->vardata.str[COLNO * y + x] - 1);
+    return (xchar) ((ov->vardata.sel->row[y][x / SEL_WORDBITS]
+                     >> (x % SEL_WORDBITS)) & 1UL);
 }
 
 void
@@ -3673,12 +3776,18 @@ int x, y;
 struct opvar *ov;
 xchar c;
 {
+    unsigned long bit;
+
     if (!ov || ov->spovartyp != SPOVAR_SEL)
         return;
     if (x < 0 || y < 0 || x >= COLNO || y >= ROWNO)
         return;
 
-    ov->vardata.str[COLNO * y + x] = (char) (c + 1);
+    bit = 1UL << (x % SEL_WORDBITS);
+    if (c)
+        ov->vardata.sel->row[y][x / SEL_WORDBITS] |= bit;
+    else
+        ov->vardata.sel->row[y][x / SEL_WORDBITS] &= ~bit;
 }
 
 struct opvar *
@@ -3686,16 +3795,18 @@ selection_not(s)
 struct opvar *s;
 {
     struct opvar *ov;
-    int x, y;
+    int y, w;
 
     ov = selection_opvar((char *) 0);
     if (!ov)
         return NULL;
 
-    for (x = 0; x < COLNO; x++)
-        for (y = 0; y < ROWNO; y++)
-            if (!selection_getpoint(x, y, s))
-                selection_setpoint(x, y, ov, 1);
+    for (y = 0; y < ROWNO; y++) {
+        for (w = 0; w < SEL_ROWWORDS; w++)
+            ov->vardata.sel->row[y][w] =
+                ~s->vardata.sel->row[y][w] & SEL_MASK;
+        ov->vardata.sel->row[y][SEL_ROWWORDS - 1] &= SEL_LASTMASK;
+    }
 
     return ov;
 }
@@ -3706,25 +3817,23 @@ struct opvar *s1, *s2;
 char oper;
 {
     struct opvar *ov;
-    int x, y;
+    int y, w;
 
     ov = selection_opvar((char *) 0);
     if (!ov)
         return NULL;
 
-    for (x = 0; x < COLNO; x++)
-        for (y = 0; y < ROWNO; y++) {
+    for (y = 0; y < ROWNO; y++)
+        for (w = 0; w < SEL_ROWWORDS; w++) {
             switch (oper) {
             default:
             case '|':
-                if (selection_getpoint(x, y, s1)
-                    || selection_getpoint(x, y, s2))
-                    selection_setpoint(x, y, ov, 1);
+                ov->vardata.sel->row[y][w] = s1->vardata.sel->row[y][w]
+                                             | s2->vardata.sel->row[y][w];
                 break;
             case '&':
-                if (selection_getpoint(x, y, s1)
-                    && selection_getpoint(x, y, s2))
-                    selection_setpoint(x, y, ov, 1);
+                ov->vardata.sel->row[y][w] = s1->vardata.sel->row[y][w]
+                                             & s2->vardata.sel->row[y][w];
                 break;
             }
         }
@@ -3737,7 +3846,8 @@ selection_filter_mapchar(ov, mc)
 struct opvar *ov;
 struct opvar *mc;
 {
-    int x, y;
+    int x, y, w, b;
+    unsigned long bits;
     schar mapc;
     xchar lit;
     struct opvar *ret = selection_opvar((char *) 0);
@@ -3746,9 +3856,15 @@ struct opvar *mc;
         return NULL;
     mapc = SP_MAPCHAR_TYP(OV_i(mc));
     lit = SP_MAPCHAR_LIT(OV_i(mc));
-    for (x = 0; x < COLNO; x++)
-        for (y = 0; y < ROWNO; y++)
-            if (selection_getpoint(x, y, ov) && (levl[x][y].typ == mapc)) {
+    for (y = 0; y < ROWNO; y++)
+        for (w = 0; w < SEL_ROWWORDS; w++)
+            for (bits = ov->vardata.sel->row[y][w], b = 0; bits;
+                 bits >>= 1, b++) {
+                if (!(bits & 1UL))
+                    continue;
+                x = w * SEL_WORDBITS + b;
+                if (levl[x][y].typ != mapc)
+                    continue;
                 switch (lit) {
                 default:
                 case -2:
@@ -3772,14 +3888,20 @@ selection_filter_percent(ov, percent)
 struct opvar *ov;
 int percent;
 {
-    int x, y;
+    int y, w, b;
+    unsigned long bits, drop;
 
     if (!ov)
         return;
-    for (x = 0; x < COLNO; x++)
-        for (y = 0; y < ROWNO; y++)
-            if (selection_getpoint(x, y, ov) && (rn2(100) >= percent))
-                selection_setpoint(x, y, ov, 0);
+    for (y = 0; y < ROWNO; y++)
+        for (w = 0; w < SEL_ROWWORDS; w++) {
+            drop = 0UL;
+            for (bits = ov->vardata.sel->row[y][w], b = 0; bits;
+                 bits >>= 1, b++)
+                if ((bits & 1UL) && rn2(100) >= percent)
+                    drop |= 1UL << b;
+            ov->vardata.sel->row[y][w] &= ~drop;
+        }
 }
 
 STATIC_OVL int
@@ -3788,28 +3910,40 @@ struct opvar *ov;
 schar *x, *y;
 boolean removeit;
 {
-    int idx = 0;
-    int c;
-    int dx, dy;
-
-    for (dx = 0; dx < COLNO; dx++)
-        for (dy = 0; dy < ROWNO; dy++)
-            if (isok(dx, dy) && selection_getpoint(dx, dy, ov))
-                idx++;
+    struct selectionvar *sel = ov->vardata.sel;
+    unsigned long bits;
+    int idx = 0, rowcnt[ROWNO];
+    int c, dy, w, b;
+
+    /* column 0 is never a valid location (see isok()) */
+    for (dy = 0; dy < ROWNO; dy++) {
+        rowcnt[dy] = sel_popcount(sel->row[dy][0] & ~1UL);
+        for (w = 1; w < SEL_ROWWORDS; w++)
+            rowcnt[dy] += sel_popcount(sel->row[dy][w]);
+        idx += rowcnt[dy];
+    }
 
     if (idx) {
         c = rn2(idx);
-        for (dx = 0; dx < COLNO; dx++)
-            for (dy = 0; dy < ROWNO; dy++)
-                if (isok(dx, dy) && selection_getpoint(dx, dy, ov)) {
-                    if (!c) {
-                        *x = dx;
-                        *y = dy;
-                        if (removeit) selection_setpoint(dx, dy, ov, 0);
-                        return 1;
-                    }
-                    c--;
-                }
+        for (dy = 0; c >= rowcnt[dy]; dy++)
+            c -= rowcnt[dy];
+        for (w = 0; w < SEL_ROWWORDS; w++) {
+            bits = sel->row[dy][w];
+            if (!w)
+                bits &= ~1UL;
+            if (c >= sel_popcount(bits)) {
+                c -= sel_popcount(bits);
+                continue;
+            }
+            for (b = 0; ; b++, bits >>= 1)
+                if ((bits & 1UL) && !c--)
+                    break;
+            *x = (schar) (w * SEL_WORDBITS + b);
+            *y = (schar) dy;
+            if (removeit)
+                selection_setpoint(*x, *y, ov, 0);
+            return 1;
+        }
     }
     *x = *y = -1;
     return 0;
@@ -3820,51 +3954,63 @@ selection_do_grow(ov, dir)
 struct opvar *ov;
 int dir;
 {
-    int x, y, c;
-    char tmp[COLNO][ROWNO];
+    struct selectionvar *sel;
+    unsigned long tmp[ROWNO][SEL_ROWWORDS], sh[SEL_ROWWORDS];
+    int y, w;
 
-    if (ov->spovartyp != SPOVAR_SEL)
-        return;
     if (!ov)
         return;
+    if (ov->spovartyp != SPOVAR_SEL)
+        return;
+    sel = ov->vardata.sel;
 
     (void) memset(tmp, 0, sizeof(tmp));
 
-    for (x = 0; x < COLNO; x++)
-        for (y = 0; y < ROWNO; y++) {
-            c = 0;
-            if ((dir & W_WEST) && (x > 0)
-                && (selection_getpoint(x - 1, y, ov)))
-                c++;
-            if ((dir & (W_WEST | W_NORTH)) && (x > 0) && (y > 0)
-                && (selection_getpoint(x - 1, y - 1, ov)))
-                c++;
-            if ((dir & W_NORTH) && (y > 0)
-                && (selection_getpoint(x, y - 1, ov)))
-                c++;
-            if ((dir & (W_NORTH | W_EAST)) && (y > 0) && (x < COLNO - 1)
-                && (selection_getpoint(x + 1, y - 1, ov)))
-                c++;
-            if ((dir & W_EAST) && (x < COLNO - 1)
-                && (selection_getpoint(x + 1, y, ov)))
-                c++;
-            if ((dir & (W_EAST | W_SOUTH)) && (x < COLNO - 1)
-                && (y < ROWNO - 1) && (selection_getpoint(x + 1, y + 1, ov)))
-                c++;
-            if ((dir & W_SOUTH) && (y < ROWNO - 1)
-                && (selection_getpoint(x, y + 1, ov)))
-                c++;
-            if ((dir & (W_SOUTH | W_WEST)) && (y < ROWNO - 1) && (x > 0)
-                && (selection_getpoint(x - 1, y + 1, ov)))
-                c++;
-            if (c)
-                tmp[x][y] = 1;
+#define SEL_GROW_OR(src)                  \
+    do {                                  \
+        for (w = 0; w < SEL_ROWWORDS; w++) \
+            tmp[y][w] |= (src)[w];        \
+    } while (0)
+
+    for (y = 0; y < ROWNO; y++) {
+        if (dir & W_WEST) {
+            sel_row_shl1(sel->row[y], sh);
+            SEL_GROW_OR(sh);
+        }
+        if (dir & W_EAST) {
+            sel_row_shr1(sel->row[y], sh);
+            SEL_GROW_OR(sh);
+        }
+        if (y > 0) {
+            if (dir & W_NORTH)
+                SEL_GROW_OR(sel->row[y - 1]);
+            if (dir & (W_WEST | W_NORTH)) {
+                sel_row_shl1(sel->row[y - 1], sh);
+                SEL_GROW_OR(sh);
+            }
+            if (dir & (W_NORTH | W_EAST)) {
+                sel_row_shr1(sel->row[y - 1], sh);
+                SEL_GROW_OR(sh);
+            }
+        }
+        if (y < ROWNO - 1) {
+            if (dir & W_SOUTH)
+                SEL_GROW_OR(sel->row[y + 1]);
+            if (dir & (W_EAST | W_SOUTH)) {
+                sel_row_shr1(sel->row[y + 1], sh);
+                SEL_GROW_OR(sh);
+            }
+            if (dir & (W_SOUTH | W_WEST)) {
+                sel_row_shl1(sel->row[y + 1], sh);
+                SEL_GROW_OR(sh);
+            }
         }
+    }
+#undef SEL_GROW_OR
 
-    for (x = 0; x < COLNO; x++)
-        for (y = 0; y < ROWNO; y++)
-            if (tmp[x][y])
-                selection_setpoint(x, y, ov, 1);
+    for (y = 0; y < ROWNO; y++)
+        for (w = 0; w < SEL_ROWWORDS; w++)
+            sel->row[y][w] |= tmp[y][w];
 }
 
 STATIC_VAR int FDECL((*selection_flood_check_func), (int, int));
@@ -3893,6 +4039,9 @@ int x, y;
             || levl[x][y].typ == SCORR);
 }
 
+/* scanline flood fill: each popped seed is widened into the whole
+   horizontal run of matching locations, and only the start of each
+   matching run in the rows above and below gets pushed */
 void
 selection_floodfill(ov, x, y, diagonals)
 struct opvar *ov;
@@ -3911,43 +4060,54 @@ boolean diagonals;
         } else                                \
             panic(floodfill_stack_overrun);   \
     } while (0)
-#define SEL_FLOOD_CHKDIR(mx,my,sel)                  \
-    if (isok((mx), (my))                             \
-        && (*selection_flood_check_func)((mx), (my)) \
-        && !selection_getpoint((mx), (my), (sel)))   \
-        SEL_FLOOD((mx), (my))
+#define SEL_FLOOD_CHK(mx,my)                         \
+    (isok((mx), (my))                                \
+     && !selection_getpoint((mx), (my), tmp)         \
+     && (*selection_flood_check_func)((mx), (my)))
     static const char floodfill_stack_overrun[] = "floodfill stack overrun";
-    int idx = 0;
+    int idx = 0, lx, rx, sx, ny, i;
     xchar dx[SEL_FLOOD_STACK];
     xchar dy[SEL_FLOOD_STACK];
 
-    if (selection_flood_check_func == NULL) {
+    if (selection_flood_check_func == NULL || !isok(x, y)) {
         opvar_free(tmp);
         return;
     }
+    /* the starting spot is taken whether it matches or not */
+    selection_setpoint(x, y, ov, 1);
+    selection_setpoint(x, y, tmp, 1);
     SEL_FLOOD(x, y);
     do {
         idx--;
         x = dx[idx];
         y = dy[idx];
-        if (isok(x, y)) {
-            selection_setpoint(x, y, ov, 1);
-            selection_setpoint(x, y, tmp, 1);
-        }
-        SEL_FLOOD_CHKDIR((x + 1), y, tmp);
-        SEL_FLOOD_CHKDIR((x - 1), y, tmp);
-        SEL_FLOOD_CHKDIR(x, (y + 1), tmp);
-        SEL_FLOOD_CHKDIR(x, (y - 1), tmp);
-        if (diagonals) {
-            SEL_FLOOD_CHKDIR((x + 1), (y + 1), tmp);
-            SEL_FLOOD_CHKDIR((x - 1), (y - 1), tmp);
-            SEL_FLOOD_CHKDIR((x - 1), (y + 1), tmp);
-            SEL_FLOOD_CHKDIR((x + 1), (y - 1), tmp);
+        for (lx = x; SEL_FLOOD_CHK(lx - 1, y); lx--)
+            continue;
+        for (rx = x; SEL_FLOOD_CHK(rx + 1, y); rx++)
+            continue;
+        selection_setspan(ov->vardata.sel, lx, rx, y);
+        selection_setspan(tmp->vardata.sel, lx, rx, y);
+        for (i = 0; i < 2; i++) {
+            ny = i ? y + 1 : y - 1;
+            sx = diagonals ? lx - 1 : lx;
+            while (sx <= (diagonals ? rx + 1 : rx)) {
+                if (!SEL_FLOOD_CHK(sx, ny)) {
+                    sx++;
+                    continue;
+                }
+                selection_setpoint(sx, ny, ov, 1);
+                selection_setpoint(sx, ny, tmp, 1);
+                SEL_FLOOD(sx, ny);
+                /* skip the rest of this run; the pop will widen it */
+                while (SEL_FLOOD_CHK(sx + 1, ny))
+                    sx++;
+                sx++;
+            }
         }
     } while (idx > 0);
 #undef SEL_FLOOD
 #undef SEL_FLOOD_STACK
-#undef SEL_FLOOD_CHKDIR
+#undef SEL_FLOOD_CHK
     opvar_free(tmp);
 }
 
@@ -3966,7 +4126,6 @@ int xc, yc, a, b, filled;
     long dxt = 2 * b2 * x, dyt = -2 * a2 * y;
     long d2xt = 2 * b2, d2yt = 2 * a2;
     long width = 1;
-    long i;
 
     if (!ov)
         return;
@@ -4009,20 +4168,20 @@ int xc, yc, a, b, filled;
                 t += dxt;
                 width += 2;
             } else if (t - a2 * y > crit2) { /* e(x+1/2,y-1) > 0 */
-                for (i = 0; i < width; i++)
-                    selection_setpoint(xc - x + i, yc - y, ov, 1);
+                selection_setspan(ov->vardata.sel, xc - x,
+                                  (int) (xc - x + width - 1), yc - y);
                 if (y != 0)
-                    for (i = 0; i < width; i++)
-                        selection_setpoint(xc - x + i, yc + y, ov, 1);
+                    selection_setspan(ov->vardata.sel, xc - x,
+                                      (int) (xc - x + width - 1), yc + y);
                 y--;
                 dyt += d2yt;
                 t += dyt;
             } else {
-                for (i = 0; i < width; i++)
-                    selection_setpoint(xc - x + i, yc - y, ov, 1);
+                selection_setspan(ov->vardata.sel, xc - x,
+                                  (int) (xc - x + width - 1), yc - y);
                 if (y != 0)
-                    for (i = 0; i < width; i++)
-                        selection_setpoint(xc - x + i, yc + y, ov, 1);
+                    selection_setspan(ov->vardata.sel, xc - x,
+                                      (int) (xc - x + width - 1), yc + y);
                 x++;
                 dxt += d2xt;
                 t += dxt;
@@ -4217,13 +4376,17 @@ struct opvar *ov;
 select_iter_func func;
 genericptr_t arg;
 {
-    int x, y;
+    int x, y, w;
+    unsigned long bits;
 
-    /* yes, this is very naive, but it's not _that_ expensive. */
-    for (x = 0; x < COLNO; x++)
+    /* column-major order, as callers have always seen it */
+    for (x = 0; x < COLNO; x++) {
+        w = x / SEL_WORDBITS;
+        bits = 1UL << (x % SEL_WORDBITS);
         for (y = 0; y < ROWNO; y++)
-            if (selection_getpoint(x, y, ov))
+            if (ov->vardata.sel->row[y][w] & bits)
                 (*func)(x, y, arg);
+    }
 }
 
 void
@@ -5797,9 +5960,8 @@ sp_lev *lvl;
                     selection_setpoint(x2, y, pt, 1);
                 }
             } else {
-                for (x = x1; x <= x2; x++)
-                    for (y = y1; y <= y2; y++)
-                        selection_setpoint(x, y, pt, 1);
+                for (y = y1; y <= y2; y++)
+                    selection_setspan(pt->vardata.sel, x1, x2, y);
             }
             splev_stack_push(coder->stack, pt);
             opvar_free(tmp);
@@ -785,11 +785,13 @@ level_tele()
         lsav = u.uz;   /* save current level, see below */
         u.uz.dnum = 0; /* main dungeon */
         u.uz.dlevel = (newlev <= -10) ? -10 : 0; /* heaven or surface */
+        status_dirty(BL_DIRTY_LEVEL);
         done(DIED);
         /* can only get here via life-saving (or declining to die in
            explore|debug mode); the hero has now left the dungeon... */
         escape_by_flying = "find yourself back on the surface";
         u.uz = lsav; /* restore u.uz so escape code works */
+        status_dirty(BL_DIRTY_LEVEL);
     }
 
     /* calls done(ESCAPED) if newlevel==0 */
@@ -843,6 +843,7 @@ int mnum;
     /* baby monsters hatch from grown-up eggs */
     mnum = little_to_big(mnum);
     mvitals[mnum].mvflags |= MV_KNOWS_EGG;
+    objnam_changed();
     /* we might have just learned about other eggs being carried */
     update_inventory();
 }
@@ -1507,7 +1508,7 @@ do_storms()
  *      Start a timer of kind 'kind' that will expire at time
  *      monstermoves+'timeout'.  Call the function at 'func_index'
  *      in the timeout table using argument 'arg'.  Return TRUE if
- *      a timer was started.  This places the timer on a list ordered
+ *      a timer was started.  This places the timer on a queue ordered
  *      "sooner" to "later".  If an object, increment the object's
  *      timer count.
  *
@@ -1553,18 +1554,53 @@ do_storms()
  *      Check whether object has a timer of type timer_type.
  */
 
+/*
+ * The active timers are kept in a binary heap ordered by expiry time.
+ * Timers which expire on the same turn go off most recently inserted
+ * first; that is the order the sorted list used before the heap gave,
+ * and run_timers() has to keep it.  Each timer is also chained into a
+ * hash table by its argument so that per-object and per-spot lookups
+ * and cancellations don't have to walk the whole queue.
+ *
+ * Only the timer_element part of a node is saved, so the save file
+ * layout is the same as it was with the list.
+ */
+struct timer_node {
+    timer_element te;         /* must be first */
+    struct timer_node *hnext; /* next timer in the same hash bucket */
+    unsigned long seq;        /* insertion order, for ties */
+    int hidx;                 /* position in timer_heap[] */
+};
+
+#define TIMER_HASHSZ 257
+#define TNODE(t) ((struct timer_node *) (t))
+
 STATIC_DCL const char *FDECL(kind_name, (SHORT_P));
-STATIC_DCL void FDECL(print_queue, (winid, timer_element *));
+STATIC_DCL void FDECL(print_queue, (winid));
+STATIC_DCL int FDECL(timer_hashval, (ANY_P *));
+STATIC_DCL boolean FDECL(timer_before, (struct timer_node *,
+                                        struct timer_node *));
+STATIC_DCL void FDECL(heap_set, (int, struct timer_node *));
+STATIC_DCL void FDECL(heap_up, (int));
+STATIC_DCL void FDECL(heap_down, (int));
+STATIC_DCL void FDECL(hash_insert, (struct timer_node *));
+STATIC_DCL void FDECL(hash_remove, (struct timer_node *));
+STATIC_DCL int FDECL(timer_order, (const genericptr, const genericptr));
+STATIC_DCL struct timer_node **NDECL(sorted_timers);
+STATIC_DCL struct timer_node *FDECL(find_timer, (SHORT_P, ANY_P *));
 STATIC_DCL void FDECL(insert_timer, (timer_element *));
-STATIC_DCL timer_element *FDECL(remove_timer,
-                                (timer_element **, SHORT_P, ANY_P *));
+STATIC_DCL void FDECL(unlink_timer, (timer_element *));
+STATIC_DCL timer_element *FDECL(remove_timer, (SHORT_P, ANY_P *));
 STATIC_DCL void FDECL(write_timer, (int, timer_element *));
 STATIC_DCL boolean FDECL(mon_is_local, (struct monst *));
 STATIC_DCL boolean FDECL(timer_is_local, (timer_element *));
 STATIC_DCL int FDECL(maybe_write_timer, (int, int, BOOLEAN_P));
 
-/* ordered timer list */
-static timer_element *timer_base; /* "active" */
+/* timer queue */
+static struct timer_node **timer_heap = 0; /* "active" */
+static int timer_count = 0, timer_heapsz = 0;
+static struct timer_node *timer_hash[TIMER_HASHSZ];
+static unsigned long timer_seq = 0;
 static unsigned long timer_id = 1;
 
 /* If defined, then include names when printing out the timer queue */
@@ -1616,18 +1652,21 @@ short kind;
 }
 
 STATIC_OVL void
-print_queue(win, base)
+print_queue(win)
 winid win;
-timer_element *base;
 {
+    struct timer_node **sorted;
     timer_element *curr;
     char buf[BUFSZ];
+    int i;
 
-    if (!base) {
+    if (!timer_count) {
         putstr(win, 0, " <empty>");
     } else {
         putstr(win, 0, "timeout  id   kind   call");
-        for (curr = base; curr; curr = curr->next) {
+        sorted = sorted_timers();
+        for (i = 0; i < timer_count; i++) {
+            curr = &sorted[i]->te;
 #ifdef VERBOSE_TIMER
             Sprintf(buf, " %4ld   %4ld  %-6s %s(%s)", curr->timeout,
                     curr->tid, kind_name(curr->kind),
@@ -1640,6 +1679,7 @@ timer_element *base;
 #endif
             putstr(win, 0, buf);
         }
+        free((genericptr_t) sorted);
     }
 }
 
@@ -1661,7 +1701,7 @@ wiz_timeout_queue()
     putstr(win, 0, "");
     putstr(win, 0, "Active timeout queue:");
     putstr(win, 0, "");
-    print_queue(win, timer_base);
+    print_queue(win);
 
     /* Timed properies:
      * check every one; the majority can't obtain temporary timeouts in
@@ -1713,10 +1753,11 @@ void
 timer_sanity_check()
 {
     timer_element *curr;
+    int i;
 
     /* this should be much more complete */
-    for (curr = timer_base; curr; curr = curr->next)
-        if (curr->kind == TIMER_OBJECT) {
+    for (i = 0; i < timer_count; i++)
+        if ((curr = &timer_heap[i]->te)->kind == TIMER_OBJECT) {
             struct obj *obj = curr->arg.a_obj;
 
             if (obj->timed == 0) {
@@ -1737,18 +1778,20 @@ run_timers()
 
     /*
      * Always use the first element.  Elements may be added or deleted at
-     * any time.  The list is ordered, we are done when the first element
+     * any time.  The queue is ordered, we are done when the first element
      * is in the future.
      */
-    while (timer_base && timer_base->timeout <= monstermoves) {
-        curr = timer_base;
-        timer_base = curr->next;
+    PERF_START(PERF_TIMERS);
+    while (timer_count && timer_heap[0]->te.timeout <= monstermoves) {
+        curr = &timer_heap[0]->te;
+        unlink_timer(curr);
 
         if (curr->kind == TIMER_OBJECT)
             (curr->arg.a_obj)->timed--;
         (*timeout_funcs[curr->func_index].f)(&curr->arg, curr->timeout);
         free((genericptr_t) curr);
     }
+    PERF_STOP(PERF_TIMERS);
 }
 
 /*
@@ -1766,8 +1809,8 @@ anything *arg;
     if (func_index < 0 || func_index >= NUM_TIME_FUNCS)
         panic("start_timer");
 
-    gnu = (timer_element *) alloc(sizeof(timer_element));
-    (void) memset((genericptr_t)gnu, 0, sizeof(timer_element));
+    gnu = (timer_element *) alloc(sizeof(struct timer_node));
+    (void) memset((genericptr_t)gnu, 0, sizeof(struct timer_node));
     gnu->next = 0;
     gnu->tid = timer_id++;
     gnu->timeout = monstermoves + when;
@@ -1796,7 +1839,7 @@ anything *arg;
     timer_element *doomed;
     long timeout;
 
-    doomed = remove_timer(&timer_base, func_index, arg);
+    doomed = remove_timer(func_index, arg);
 
     if (doomed) {
         timeout = doomed->timeout;
@@ -1818,13 +1861,9 @@ peek_timer(type, arg)
 short type;
 anything *arg;
 {
-    timer_element *curr;
+    struct timer_node *curr = find_timer(type, arg);
 
-    for (curr = timer_base; curr; curr = curr->next) {
-        if (curr->func_index == type && curr->arg.a_void == arg->a_void)
-            return curr->timeout;
-    }
-    return 0L;
+    return curr ? curr->te.timeout : 0L;
 }
 
 /*
@@ -1835,14 +1874,20 @@ obj_move_timers(src, dest)
 struct obj *src, *dest;
 {
     int count;
-    timer_element *curr;
-
-    for (count = 0, curr = timer_base; curr; curr = curr->next)
-        if (curr->kind == TIMER_OBJECT && curr->arg.a_obj == src) {
-            curr->arg.a_obj = dest;
+    struct timer_node *curr, *next_timer;
+
+    count = 0;
+    for (curr = timer_hash[timer_hashval(obj_to_any(src))]; curr;
+         curr = next_timer) {
+        next_timer = curr->hnext; /* curr gets rehashed */
+        if (curr->te.kind == TIMER_OBJECT && curr->te.arg.a_obj == src) {
+            hash_remove(curr);
+            curr->te.arg.a_obj = dest;
+            hash_insert(curr);
             dest->timed++;
             count++;
         }
+    }
     if (count != src->timed)
         panic("obj_move_timers");
     src->timed = 0;
@@ -1855,14 +1900,22 @@ void
 obj_split_timers(src, dest)
 struct obj *src, *dest;
 {
-    timer_element *curr, *next_timer = 0;
-
-    for (curr = timer_base; curr; curr = next_timer) {
-        next_timer = curr->next; /* things may be inserted */
-        if (curr->kind == TIMER_OBJECT && curr->arg.a_obj == src) {
-            (void) start_timer(curr->timeout - monstermoves, TIMER_OBJECT,
-                               curr->func_index, obj_to_any(dest));
-        }
+    struct timer_node *curr, *first, *last = 0;
+
+    /* duplicate them in queue order; src's timers don't move meanwhile */
+    for (;;) {
+        first = 0;
+        for (curr = timer_hash[timer_hashval(obj_to_any(src))]; curr;
+             curr = curr->hnext)
+            if (curr->te.kind == TIMER_OBJECT && curr->te.arg.a_obj == src
+                && (!last || timer_before(last, curr))
+                && (!first || timer_before(curr, first)))
+                first = curr;
+        if (!first)
+            break;
+        (void) start_timer(first->te.timeout - monstermoves, TIMER_OBJECT,
+                           first->te.func_index, obj_to_any(dest));
+        last = first;
     }
 }
 
@@ -1874,23 +1927,26 @@ void
 obj_stop_timers(obj)
 struct obj *obj;
 {
-    timer_element *curr, *prev, *next_timer = 0;
+    struct timer_node *curr, *first;
+    timer_element *doomed;
 
-    for (prev = 0, curr = timer_base; curr; curr = next_timer) {
-        next_timer = curr->next;
-        if (curr->kind == TIMER_OBJECT && curr->arg.a_obj == obj) {
-            if (prev)
-                prev->next = curr->next;
-            else
-                timer_base = curr->next;
-            if (timeout_funcs[curr->func_index].cleanup)
-                (*timeout_funcs[curr->func_index].cleanup)(&curr->arg,
-                                                           curr->timeout);
-            free((genericptr_t) curr);
-        } else {
-            prev = curr;
+    /* cleanup routines are called in queue order */
+    do {
+        first = 0;
+        for (curr = timer_hash[timer_hashval(obj_to_any(obj))]; curr;
+             curr = curr->hnext)
+            if (curr->te.kind == TIMER_OBJECT && curr->te.arg.a_obj == obj
+                && (!first || timer_before(curr, first)))
+                first = curr;
+        if (first) {
+            doomed = &first->te;
+            unlink_timer(doomed);
+            if (timeout_funcs[doomed->func_index].cleanup)
+                (*timeout_funcs[doomed->func_index].cleanup)(&doomed->arg,
+                                                            doomed->timeout);
+            free((genericptr_t) doomed);
         }
-    }
+    } while (first);
     obj->timed = 0;
 }
 
@@ -1916,25 +1972,30 @@ spot_stop_timers(x, y, func_index)
 xchar x, y;
 short func_index;
 {
-    timer_element *curr, *prev, *next_timer = 0;
-    long where = (((long) x << 16) | ((long) y));
-
-    for (prev = 0, curr = timer_base; curr; curr = next_timer) {
-        next_timer = curr->next;
-        if (curr->kind == TIMER_LEVEL && curr->func_index == func_index
-            && curr->arg.a_long == where) {
-            if (prev)
-                prev->next = curr->next;
-            else
-                timer_base = curr->next;
-            if (timeout_funcs[curr->func_index].cleanup)
-                (*timeout_funcs[curr->func_index].cleanup)(&curr->arg,
-                                                           curr->timeout);
-            free((genericptr_t) curr);
-        } else {
-            prev = curr;
+    struct timer_node *curr, *first;
+    timer_element *doomed;
+    anything where;
+
+    where = zeroany;
+    where.a_long = (((long) x << 16) | ((long) y));
+    do {
+        first = 0;
+        for (curr = timer_hash[timer_hashval(&where)]; curr;
+             curr = curr->hnext)
+            if (curr->te.kind == TIMER_LEVEL
+                && curr->te.func_index == func_index
+                && curr->te.arg.a_long == where.a_long
+                && (!first || timer_before(curr, first)))
+                first = curr;
+        if (first) {
+            doomed = &first->te;
+            unlink_timer(doomed);
+            if (timeout_funcs[doomed->func_index].cleanup)
+                (*timeout_funcs[doomed->func_index].cleanup)(&doomed->arg,
+                                                            doomed->timeout);
+            free((genericptr_t) doomed);
         }
-    }
+    } while (first);
 }
 
 /*
@@ -1946,15 +2007,17 @@ spot_time_expires(x, y, func_index)
 xchar x, y;
 short func_index;
 {
-    timer_element *curr;
-    long where = (((long) x << 16) | ((long) y));
-
-    for (curr = timer_base; curr; curr = curr->next) {
-        if (curr->kind == TIMER_LEVEL && curr->func_index == func_index
-            && curr->arg.a_long == where)
-            return curr->timeout;
-    }
-    return 0L;
+    struct timer_node *curr, *first = 0;
+    anything where;
+
+    where = zeroany;
+    where.a_long = (((long) x << 16) | ((long) y));
+    for (curr = timer_hash[timer_hashval(&where)]; curr; curr = curr->hnext)
+        if (curr->te.kind == TIMER_LEVEL && curr->te.func_index == func_index
+            && curr->te.arg.a_long == where.a_long
+            && (!first || timer_before(curr, first)))
+            first = curr;
+    return first ? first->te.timeout : 0L;
 }
 
 long
@@ -1966,44 +2029,194 @@ short func_index;
     return (expires > 0L) ? expires - monstermoves : 0L;
 }
 
-/* Insert timer into the global queue */
+STATIC_OVL int
+timer_hashval(arg)
+anything *arg;
+{
+    return (int) ((unsigned long) arg->a_void % TIMER_HASHSZ);
+}
+
+/* does timer a go off before timer b? */
+STATIC_OVL boolean
+timer_before(a, b)
+struct timer_node *a, *b;
+{
+    if (a->te.timeout != b->te.timeout)
+        return (boolean) (a->te.timeout < b->te.timeout);
+    return (boolean) (a->seq > b->seq);
+}
+
 STATIC_OVL void
-insert_timer(gnu)
-timer_element *gnu;
+heap_set(i, node)
+int i;
+struct timer_node *node;
+{
+    timer_heap[i] = node;
+    node->hidx = i;
+}
+
+STATIC_OVL void
+heap_up(i)
+int i;
 {
-    timer_element *curr, *prev;
+    struct timer_node *node = timer_heap[i];
+    int parent;
+
+    while (i > 0) {
+        parent = (i - 1) / 2;
+        if (!timer_before(node, timer_heap[parent]))
+            break;
+        heap_set(i, timer_heap[parent]);
+        i = parent;
+    }
+    heap_set(i, node);
+}
 
-    for (prev = 0, curr = timer_base; curr; prev = curr, curr = curr->next)
-        if (curr->timeout >= gnu->timeout)
+STATIC_OVL void
+heap_down(i)
+int i;
+{
+    struct timer_node *node = timer_heap[i];
+    int child;
+
+    while ((child = 2 * i + 1) < timer_count) {
+        if (child + 1 < timer_count
+            && timer_before(timer_heap[child + 1], timer_heap[child]))
+            child++;
+        if (!timer_before(timer_heap[child], node))
             break;
+        heap_set(i, timer_heap[child]);
+        i = child;
+    }
+    heap_set(i, node);
+}
+
+STATIC_OVL void
+hash_insert(node)
+struct timer_node *node;
+{
+    struct timer_node **bucket = &timer_hash[timer_hashval(&node->te.arg)];
 
-    gnu->next = curr;
-    if (prev)
-        prev->next = gnu;
-    else
-        timer_base = gnu;
+    node->hnext = *bucket;
+    *bucket = node;
 }
 
-STATIC_OVL timer_element *
-remove_timer(base, func_index, arg)
-timer_element **base;
+STATIC_OVL void
+hash_remove(node)
+struct timer_node *node;
+{
+    struct timer_node **prev = &timer_hash[timer_hashval(&node->te.arg)];
+
+    while (*prev && *prev != node)
+        prev = &(*prev)->hnext;
+    if (!*prev)
+        panic("hash_remove: timer %lu not found", node->te.tid);
+    *prev = node->hnext;
+    node->hnext = 0;
+}
+
+/* qsort() comparison for sorted_timers() */
+STATIC_OVL int
+timer_order(vptr1, vptr2)
+const genericptr vptr1;
+const genericptr vptr2;
+{
+    struct timer_node *a = *(struct timer_node **) vptr1,
+                      *b = *(struct timer_node **) vptr2;
+
+    return timer_before(a, b) ? -1 : timer_before(b, a) ? 1 : 0;
+}
+
+/* snapshot of the queue in firing order; caller frees it */
+STATIC_OVL struct timer_node **
+sorted_timers()
+{
+    struct timer_node **sorted;
+
+    sorted = (struct timer_node **) alloc(
+                        (unsigned) (max(timer_count, 1) * sizeof *sorted));
+    if (timer_count) {
+        (void) memcpy((genericptr_t) sorted, (genericptr_t) timer_heap,
+                      timer_count * sizeof *sorted);
+        qsort((genericptr_t) sorted, (size_t) timer_count, sizeof *sorted,
+              timer_order);
+    }
+    return sorted;
+}
+
+/* the soonest timer with this (func_index, arg) pair */
+STATIC_OVL struct timer_node *
+find_timer(func_index, arg)
 short func_index;
 anything *arg;
 {
-    timer_element *prev, *curr;
+    struct timer_node *curr, *first = 0;
+
+    for (curr = timer_hash[timer_hashval(arg)]; curr; curr = curr->hnext)
+        if (curr->te.func_index == func_index
+            && curr->te.arg.a_void == arg->a_void
+            && (!first || timer_before(curr, first)))
+            first = curr;
+    return first;
+}
 
-    for (prev = 0, curr = *base; curr; prev = curr, curr = curr->next)
-        if (curr->func_index == func_index && curr->arg.a_void == arg->a_void)
-            break;
+/* Insert timer into the global queue */
+STATIC_OVL void
+insert_timer(gnu)
+timer_element *gnu;
+{
+    struct timer_node *node = TNODE(gnu);
+
+    if (timer_count == timer_heapsz) {
+        struct timer_node **newheap;
+
+        timer_heapsz = timer_heapsz ? 2 * timer_heapsz : 64;
+        newheap = (struct timer_node **) alloc(
+                                    (unsigned) (timer_heapsz * sizeof *newheap));
+        if (timer_count)
+            (void) memcpy((genericptr_t) newheap, (genericptr_t) timer_heap,
+                          timer_count * sizeof *newheap);
+        if (timer_heap)
+            free((genericptr_t) timer_heap);
+        timer_heap = newheap;
+    }
+    gnu->next = 0;
+    node->seq = ++timer_seq;
+    heap_set(timer_count++, node);
+    heap_up(node->hidx);
+    hash_insert(node);
+}
 
-    if (curr) {
-        if (prev)
-            prev->next = curr->next;
-        else
-            *base = curr->next;
+/* take a timer off the queue without freeing it */
+STATIC_OVL void
+unlink_timer(timer)
+timer_element *timer;
+{
+    struct timer_node *node = TNODE(timer), *moved;
+    int i = node->hidx;
+
+    hash_remove(node);
+    if (--timer_count > i) {
+        /* fill the hole with the last leaf and sift it either way */
+        moved = timer_heap[timer_count];
+        heap_set(i, moved);
+        heap_up(i);
+        heap_down(moved->hidx);
     }
+    timer_heap[timer_count] = 0;
+}
+
+STATIC_OVL timer_element *
+remove_timer(func_index, arg)
+short func_index;
+anything *arg;
+{
+    struct timer_node *curr = find_timer(func_index, arg);
 
-    return curr;
+    if (!curr)
+        return (timer_element *) 0;
+    unlink_timer(&curr->te);
+    return &curr->te;
 }
 
 STATIC_OVL void
@@ -2132,10 +2345,14 @@ maybe_write_timer(fd, range, write_it)
 int fd, range;
 boolean write_it;
 {
-    int count = 0;
+    int i, count = 0;
+    struct timer_node **sorted;
     timer_element *curr;
 
-    for (curr = timer_base; curr; curr = curr->next) {
+    /* written in firing order, as they were from the old sorted list */
+    sorted = write_it ? sorted_timers() : timer_heap;
+    for (i = 0; i < timer_count; i++) {
+        curr = &sorted[i]->te;
         if (range == RANGE_GLOBAL) {
             /* global timers */
 
@@ -2155,6 +2372,8 @@ boolean write_it;
             }
         }
     }
+    if (write_it)
+        free((genericptr_t) sorted);
 
     return count;
 }
@@ -2176,8 +2395,8 @@ void
 save_timers(fd, mode, range)
 int fd, mode, range;
 {
-    timer_element *curr, *prev, *next_timer = 0;
-    int count;
+    struct timer_node **all;
+    int i, count;
 
     if (perform_bwrite(mode)) {
         if (range == RANGE_GLOBAL)
@@ -2189,20 +2408,14 @@ int fd, mode, range;
     }
 
     if (release_data(mode)) {
-        for (prev = 0, curr = timer_base; curr; curr = next_timer) {
-            next_timer = curr->next; /* in case curr is removed */
-
-            if (!(!!(range == RANGE_LEVEL) ^ !!timer_is_local(curr))) {
-                if (prev)
-                    prev->next = curr->next;
-                else
-                    timer_base = curr->next;
-                free((genericptr_t) curr);
-                /* prev stays the same */
-            } else {
-                prev = curr;
+        /* removals reshuffle the heap, so work from a copy */
+        all = sorted_timers();
+        for (i = 0, count = timer_count; i < count; i++)
+            if (!(!!(range == RANGE_LEVEL) ^ !!timer_is_local(&all[i]->te))) {
+                unlink_timer(&all[i]->te);
+                free((genericptr_t) all[i]);
             }
-        }
+        free((genericptr_t) all);
     }
 }
 
@@ -2225,7 +2438,8 @@ long adjust;     /* how much to adjust timeout */
     /* restore elements */
     mread(fd, (genericptr_t) &count, sizeof count);
     while (count-- > 0) {
-        curr = (timer_element *) alloc(sizeof(timer_element));
+        curr = (timer_element *) alloc(sizeof(struct timer_node));
+        (void) memset((genericptr_t) curr, 0, sizeof(struct timer_node));
         mread(fd, (genericptr_t) curr, sizeof(timer_element));
         if (ghostly)
             curr->timeout += adjust;
@@ -2240,14 +2454,9 @@ const char *hdrfmt;
 char *hdrbuf;
 long *count, *size;
 {
-    timer_element *te;
-
-    Sprintf(hdrbuf, hdrfmt, (long) sizeof (timer_element));
-    *count = *size = 0L;
-    for (te = timer_base; te; te = te->next) {
-        ++*count;
-        *size += (long) sizeof *te;
-    }
+    Sprintf(hdrbuf, hdrfmt, (long) sizeof (struct timer_node));
+    *count = (long) timer_count;
+    *size = (long) timer_count * (long) sizeof (struct timer_node);
 }
 
 /* reset all timers that are marked for reseting */
@@ -2257,9 +2466,13 @@ boolean ghostly;
 {
     timer_element *curr;
     unsigned nid;
+    int i;
 
-    for (curr = timer_base; curr; curr = curr->next) {
+    for (i = 0; i < timer_count; i++) {
+        curr = &timer_heap[i]->te;
         if (curr->needs_fixup) {
+            /* arg is about to change from an id to a pointer */
+            hash_remove(timer_heap[i]);
             if (curr->kind == TIMER_OBJECT) {
                 if (ghostly) {
                     if (!lookup_id_mapping(curr->arg.a_uint, &nid))
@@ -2270,6 +2483,7 @@ boolean ghostly;
                 if (!curr->arg.a_obj)
                     panic("cant find o_id %d", nid);
                 curr->needs_fixup = 0;
+                hash_insert(timer_heap[i]);
             } else if (curr->kind == TIMER_MONSTER) {
                 panic("relink_timers: no monster timer implemented");
             } else
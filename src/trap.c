@@ -3388,6 +3388,8 @@ struct obj *obj;
         obj->otyp = SCR_BLANK_PAPER;
         obj->spe = 0;
         obj->dknown = 0;
+        if (carried(obj))
+            invent_changed();
     } else
         erode_obj(obj, (char *) 0, ERODE_CORRODE, EF_GREASE | EF_VERBOSE);
 }
@@ -3467,8 +3469,10 @@ boolean force;
         obj->otyp = SCR_BLANK_PAPER;
         obj->dknown = 0;
         obj->spe = 0;
-        if (carried(obj))
+        if (carried(obj)) {
+            invent_changed();
             update_inventory();
+        }
         return ER_DAMAGED;
     } else if (obj->oclass == SPBOOK_CLASS) {
         if (obj->otyp == SPE_BOOK_OF_THE_DEAD) {
@@ -3487,8 +3491,10 @@ boolean force;
 
         obj->otyp = SPE_BLANK_PAPER;
         obj->dknown = 0;
-        if (carried(obj))
+        if (carried(obj)) {
+            invent_changed();
             update_inventory();
+        }
         return ER_DAMAGED;
     } else if (obj->oclass == POTION_CLASS) {
         if (obj->otyp == POT_ACID) {
@@ -3535,6 +3541,8 @@ boolean force;
             obj->dknown = 0;
             obj->blessed = obj->cursed = 0;
             obj->odiluted = 0;
+            if (carried(obj))
+                invent_changed();
             if (carried(obj))
                 update_inventory();
             return ER_DAMAGED;
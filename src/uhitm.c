@@ -5,6 +5,7 @@
 
 #include "hack.h"
 
+STATIC_DCL boolean FDECL(attack_core, (struct monst *));
 STATIC_DCL boolean FDECL(known_hitum, (struct monst *, struct obj *, int *,
                                        int, int, struct attack *, int));
 STATIC_DCL boolean FDECL(theft_petrifies, (struct obj *));
@@ -311,6 +312,18 @@ int *attk_count, *role_roll_penalty;
 boolean
 attack(mtmp)
 register struct monst *mtmp;
+{
+    int oldrng = rng_select(RNG_COMBAT);
+    boolean res;
+
+    res = attack_core(mtmp);
+    (void) rng_select(oldrng);
+    return res;
+}
+
+STATIC_OVL boolean
+attack_core(mtmp)
+register struct monst *mtmp;
 {
     register struct permonst *mdat = mtmp->data;
 
@@ -947,6 +960,8 @@ int dieroll;
                             obj->spe = 0;
                             obj->known = obj->dknown = obj->bknown = 0;
                             obj->owt = weight(obj);
+                            if (carried(obj))
+                                invent_changed();
                             if (thrown)
                                 place_object(obj, mon->mx, mon->my);
                         } else {
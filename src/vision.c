@@ -90,12 +90,25 @@ static char cs_rmin1[ROWNO], cs_rmax1[ROWNO];
 static char viz_clear[ROWNO][COLNO]; /* vision clear/blocked map */
 static char *viz_clear_rows[ROWNO];
 
+/*
+ * Recent changes to viz_clear[], so that light.c can tell whether a
+ * cached light source map is still good.  Each change gets the next
+ * generation number; only the last VIZ_CHANGELOG changes are kept.
+ */
+#define VIZ_CHANGELOG 64
+static struct {
+    xchar x, y;
+} viz_changes[VIZ_CHANGELOG];
+static unsigned long viz_clear_gen = 1;  /* next change's generation */
+static unsigned long viz_reset_gen = 1;  /* everything changed here */
+
 static char left_ptrs[ROWNO][COLNO]; /* LOS algorithm helpers */
 static char right_ptrs[ROWNO][COLNO];
 
 /* Forward declarations. */
 STATIC_DCL void FDECL(fill_point, (int, int));
 STATIC_DCL void FDECL(dig_point, (int, int));
+STATIC_DCL void FDECL(note_clear_change, (int, int));
 STATIC_DCL void NDECL(view_init);
 STATIC_DCL void FDECL(view_from, (int, int, char **, char *, char *, int,
                                   void (*)(int, int, genericptr_t),
@@ -157,7 +170,6 @@ does_block(x, y, lev)
 int x, y;
 register struct rm *lev;
 {
-    struct obj *obj;
     struct monst *mon;
 
     /* Features that block . . */
@@ -171,9 +183,8 @@ register struct rm *lev;
         return 1;
 
     /* Boulders block light. */
-    for (obj = level.objects[x][y]; obj; obj = obj->nexthere)
-        if (obj->otyp == BOULDER)
-            return 1;
+    if (pile_at(x, y)->boulders)
+        return 1;
 
     /* Mimics mimicing a door or boulder or ... block light. */
     if ((mon = m_at(x, y)) && (!mon->minvis || See_invisible)
@@ -242,6 +253,7 @@ vision_reset()
         }
     }
 
+    viz_reset_gen = ++viz_clear_gen; /* invalidate cached light maps */
     iflags.vision_inited = 1; /* vision is ready */
     vision_full_recalc = 1;   /* we want to run vision_recalc() */
 }
@@ -522,6 +534,7 @@ int control;
     vision_full_recalc = 0; /* reset flag */
     if (in_mklev || !iflags.vision_inited)
         return;
+    PERF_START(PERF_VISION);
 
     /*
      * Either the light sources have been taken care of, or we must
@@ -833,6 +846,7 @@ skip:
     viz_rmax = next_rmax;
 
     recalc_mapseen();
+    PERF_STOP(PERF_VISION);
 }
 
 /*
@@ -844,10 +858,10 @@ void
 block_point(x, y)
 int x, y;
 {
+    if (viz_clear[y][x])
+        note_clear_change(x, y);
     fill_point(y, x);
 
-    /* recalc light sources here? */
-
     /*
      * We have to do a full vision recalculation if we "could see" the
      * location.  Why? Suppose some monster opened a way so that the
@@ -868,14 +882,63 @@ void
 unblock_point(x, y)
 int x, y;
 {
+    if (!viz_clear[y][x])
+        note_clear_change(x, y);
     dig_point(y, x);
 
-    /* recalc light sources here? */
-
     if (viz_array[y][x])
         vision_full_recalc = 1;
 }
 
+/* record that viz_clear[y][x] is about to flip */
+STATIC_OVL void
+note_clear_change(x, y)
+int x, y;
+{
+    int i = (int) (viz_clear_gen % VIZ_CHANGELOG);
+
+    viz_changes[i].x = (xchar) x;
+    viz_changes[i].y = (xchar) y;
+    viz_clear_gen++;
+}
+
+/*
+ * vision_clear_gen()
+ *
+ * Generation of the clear/blocked map; save this along with anything
+ * computed from clear_path() and pass it to vision_clear_changed().
+ */
+unsigned long
+vision_clear_gen()
+{
+    return viz_clear_gen;
+}
+
+/*
+ * vision_clear_changed()
+ *
+ * Has any location in the box [lx..hx] x [ly..hy] become blocked or
+ * unblocked since generation 'since'?  Answers TRUE when it can't tell.
+ */
+boolean
+vision_clear_changed(since, lx, ly, hx, hy)
+unsigned long since;
+int lx, ly, hx, hy;
+{
+    unsigned long g;
+    int i;
+
+    if (since < viz_reset_gen || viz_clear_gen - since > VIZ_CHANGELOG)
+        return TRUE;
+    for (g = since; g < viz_clear_gen; g++) {
+        i = (int) (g % VIZ_CHANGELOG);
+        if (viz_changes[i].x >= lx && viz_changes[i].x <= hx
+            && viz_changes[i].y >= ly && viz_changes[i].y <= hy)
+            return TRUE;
+    }
+    return FALSE;
+}
+
 /*==========================================================================*\
  |                                                                          |
  |      Everything below this line uses (y,x) instead of (x,y) --- the      |
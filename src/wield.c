@@ -755,6 +755,7 @@ register int amount;
         Your("%s %s much sharper now.", simpleonames(uwep),
              multiple ? "fuse, and become" : "is");
         uwep->otyp = CRYSKNIFE;
+        invent_changed();
         uwep->oerodeproof = 0;
         if (multiple) {
             uwep->quan = 1L;
@@ -777,6 +778,7 @@ register int amount;
              multiple ? "fuse, and become" : "is");
         costly_alteration(uwep, COST_DEGRD); /* DECHNT? other? */
         uwep->otyp = WORM_TOOTH;
+        invent_changed();
         uwep->oerodeproof = 0;
         if (multiple) {
             uwep->quan = 1L;
@@ -53,6 +53,14 @@ extern void *FDECL(chainout_procs_chain, (int, int, void *, void *, void *));
 extern struct chain_procs trace_procs;
 extern void FDECL(trace_procs_init, (int));
 extern void *FDECL(trace_procs_chain, (int, int, void *, void *, void *));
+
+extern struct chain_procs record_procs;
+extern void FDECL(record_procs_init, (int));
+extern void *FDECL(record_procs_chain, (int, int, void *, void *, void *));
+
+extern struct chain_procs replay_procs;
+extern void FDECL(replay_procs_init, (int));
+extern void *FDECL(replay_procs_chain, (int, int, void *, void *, void *));
 #endif
 
 STATIC_DCL void FDECL(def_raw_print, (const char *s));
@@ -127,6 +135,10 @@ static struct win_choices {
 
     { (struct window_procs *) &trace_procs, trace_procs_init,
       trace_procs_chain },
+    { (struct window_procs *) &record_procs, record_procs_init,
+      record_procs_chain },
+    { (struct window_procs *) &replay_procs, replay_procs_init,
+      replay_procs_chain },
 #endif
     { 0, 0 CHAINR(0) } /* must be last */
 };
@@ -338,9 +350,10 @@ commit_windowchain()
     }
 
     /* Restore the saved wincap* values.  We do it here to give the
-     * ini_routine()s a chance to change or check them. */
+     * ini_routine()s a chance to change or check them.  Processors
+     * only see lines passed through add_menu(). */
     chain->wincp->procs->wincap = wincap;
-    chain->wincp->procs->wincap2 = wincap2;
+    chain->wincp->procs->wincap2 = wincap2 & ~WC2_MENU_ITEMS;
 
     /* Call the init procs.  Do not re-init the terminal real win. */
     p = chain;
@@ -379,6 +392,137 @@ const char *mesg;
     return 0;
 }
 
+/*
+ * Menus too long to format up front.  add_menu_items() adds count
+ * lines to a menu, each produced by (*fill)(arg, index, &mf).  A port
+ * with WC2_MENU_ITEMS only asks for the text of the lines it actually
+ * shows, through get_menu_item(), and calls clear_menu_items() when the
+ * menu is restarted or destroyed; the caller's arg must stay valid
+ * until then.  For other ports, and while writing the dumplog, the
+ * lines are simply passed to add_menu() now.  Lines added this way
+ * follow any added with add_menu(), and a menu gets at most one batch.
+ */
+struct menu_source {
+    struct menu_source *next;
+    winid window;
+    int count;
+    void FDECL((*fill), (genericptr_t, int, menu_fill *));
+    genericptr_t arg;
+};
+
+static struct menu_source *menu_sources = 0;
+
+STATIC_DCL struct menu_source *FDECL(find_menu_source, (winid));
+STATIC_DCL void FDECL(fill_menu_item, (struct menu_source *, int,
+                                       menu_fill *));
+
+STATIC_OVL struct menu_source *
+find_menu_source(window)
+winid window;
+{
+    struct menu_source *ms;
+
+    for (ms = menu_sources; ms; ms = ms->next)
+        if (ms->window == window)
+            return ms;
+    return (struct menu_source *) 0;
+}
+
+STATIC_OVL void
+fill_menu_item(ms, idx, mf)
+struct menu_source *ms;
+int idx;
+menu_fill *mf;
+{
+    mf->glyph = NO_GLYPH;
+    mf->identifier = zeroany;
+    mf->accelerator = mf->groupacc = 0;
+    mf->attr = ATR_NONE;
+    mf->preselected = MENU_UNSELECTED;
+    if (mf->str)
+        mf->str[0] = '\0';
+    if (ms)
+        (*ms->fill)(ms->arg, idx, mf);
+}
+
+void
+add_menu_items(window, count, fill, arg)
+winid window;
+int count;
+void FDECL((*fill), (genericptr_t, int, menu_fill *));
+genericptr_t arg;
+{
+    struct menu_source *ms;
+
+    if (count <= 0)
+        return;
+    clear_menu_items(window);
+    ms = (struct menu_source *) alloc(sizeof (struct menu_source));
+    ms->window = window;
+    ms->count = count;
+    ms->fill = fill;
+    ms->arg = arg;
+
+    if ((windowprocs.wincap2 & WC2_MENU_ITEMS) != 0L && !iflags.in_dumplog) {
+        ms->next = menu_sources;
+        menu_sources = ms;
+    } else {
+        char buf[BUFSZ];
+        menu_fill mf;
+        int i;
+
+        mf.str = buf;
+        for (i = 0; i < count; i++) {
+            fill_menu_item(ms, i, &mf);
+            add_menu(window, mf.glyph, &mf.identifier, mf.accelerator,
+                     mf.groupacc, mf.attr, buf, mf.preselected);
+        }
+        free((genericptr_t) ms);
+    }
+}
+
+/* for window ports: number of lines waiting to be fetched */
+int
+menu_items_count(window)
+winid window;
+{
+    struct menu_source *ms = find_menu_source(window);
+
+    return ms ? ms->count : 0;
+}
+
+/* for window ports: fetch line idx; mf->str may be null if the text
+   isn't wanted yet */
+void
+get_menu_item(window, idx, mf)
+winid window;
+int idx;
+menu_fill *mf;
+{
+    struct menu_source *ms = find_menu_source(window);
+
+    if (!ms || idx < 0 || idx >= ms->count) {
+        impossible("get_menu_item: no line %d for window %d", idx, window);
+        ms = (struct menu_source *) 0; /* just a blank line */
+    }
+    fill_menu_item(ms, idx, mf);
+}
+
+/* for window ports: the window's lines won't be fetched any more */
+void
+clear_menu_items(window)
+winid window;
+{
+    struct menu_source *ms, **prev;
+
+    for (prev = &menu_sources; (ms = *prev) != 0; prev = &ms->next)
+        if (ms->window == window) {
+            *prev = ms->next;
+            free((genericptr_t) ms);
+            break;
+        }
+}
+
 /*ARGSUSED*/
 void
 genl_preference_update(pref)
@@ -1058,6 +1058,8 @@ register struct obj *obj;
             }
             break;
         }
+        if (carried(obj))
+            invent_changed();
     }
     unbless(obj);
     uncurse(obj);
@@ -1458,7 +1460,7 @@ int id;
 
         /* now change it into something laid by the hero */
         while (tryct--) {
-            mnum = can_be_hatched(random_monster());
+            mnum = can_be_hatched(rn2(NUMMONS));
             if (mnum != NON_PM && !dead_species(mnum, TRUE)) {
                 otmp->spe = 1;            /* laid by hero */
                 set_corpsenm(otmp, mnum); /* also sets hatch timer */
@@ -4579,7 +4581,7 @@ fracture_rock(obj)
 register struct obj *obj; /* no texts here! */
 {
     xchar x, y;
-    boolean by_you = !context.mon_moving;
+    boolean by_you = !context.mon_moving, on_floor;
 
     if (by_you && get_obj_location(obj, &x, &y, 0) && costly_spot(x, y)) {
         struct monst *shkp = 0;
@@ -4595,17 +4597,23 @@ register struct obj *obj; /* no texts here! */
     if (by_you && obj->otyp == BOULDER)
         sokoban_guilt();
 
+    /* take it off the floor while it's still a boulder so that the
+       spot's pile summary stays accurate */
+    on_floor = (obj->where == OBJ_FLOOR);
+    if (on_floor)
+        obj_extract_self(obj);
     obj->otyp = ROCK;
     obj->oclass = GEM_CLASS;
+    if (carried(obj))
+        invent_changed();
     obj->quan = (long) rn1(60, 7);
     obj->owt = weight(obj);
     obj->dknown = obj->bknown = obj->rknown = 0;
     obj->known = objects[obj->otyp].oc_uses_known ? 0 : 1;
     dealloc_oextra(obj);
 
-    if (obj->where == OBJ_FLOOR) {
-        obj_extract_self(obj); /* move rocks back on top */
-        place_object(obj, obj->ox, obj->oy);
+    if (on_floor) {
+        place_object(obj, obj->ox, obj->oy); /* rocks go back on top */
         if (!does_block(obj->ox, obj->oy, &levl[obj->ox][obj->oy]))
             unblock_point(obj->ox, obj->oy);
         if (cansee(obj->ox, obj->oy))
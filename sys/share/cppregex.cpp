@@ -55,6 +55,18 @@ extern "C" {
     }
   }
 
+  boolean regex_compile_set(const char *const *s, int n,
+                            struct nhregex *re) {
+    char *pat;
+    boolean res;
+
+    if (!re || n < 1 || !(pat = regex_set_pattern(s, n)))
+      return FALSE;
+    res = regex_compile(pat, re);
+    free(pat);
+    return res;
+  }
+
   void regex_free(struct nhregex *re) {
     delete re;
   }
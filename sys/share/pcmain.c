@@ -343,6 +343,15 @@ _CrtSetReportFile(_CRT_ASSERT, _CRTDBG_FILE_STDERR);*/
             argv++;
 	}
 
+        switch (argcheck(argc, argv, ARG_SEED)) {
+        case 1: /* argcheck() removed it from argv */
+            argc--;
+            break;
+        case 2:
+            nethack_exit(EXIT_FAILURE);
+            /*NOTREACHED*/
+        }
+
         if (argc > 1 && !strncmp(argv[1], "-d", 2) && argv[1][2] != 'e') {
             /* avoid matching "-dec" for DECgraphics; since the man page
              * says -d directory, hope nobody's using -desomething_else
@@ -61,6 +61,16 @@ struct nhregex *re;
     return pmatchi(re->pat, s);
 }
 
+/* glob patterns have no alternation; match them one at a time */
+boolean
+regex_compile_set(s, n, re)
+const char *const *s UNUSED;
+int n UNUSED;
+struct nhregex *re UNUSED;
+{
+    return FALSE;
+}
+
 void
 regex_free(re)
 struct nhregex *re;
@@ -40,6 +40,14 @@
  * into re. Only valid if the most recent call to regex_compile on re
  * succeeded.
  *
+ * boolean regex_compile_set(const char *const *s, int n,
+ *                           struct nhregex *re)
+ * Used to compile a single regex into re that matches wherever any of
+ * s[0] through s[n-1] would. Returns FALSE if that can't be done (or the
+ * implementation doesn't support it), in which case the caller has to
+ * match the expressions one at a time. regex_set_pattern() in options.c
+ * builds the combined expression for ERE implementations.
+ *
  * void regex_free(struct nhregex *re)
  * Deallocate a regex object.
  */
@@ -49,12 +57,17 @@ const char regex_id[] = "posixregex";
 struct nhregex {
     regex_t re;
     int err;
+    boolean compiled; /* regcomp() has been called on re */
 };
 
 struct nhregex *
 regex_init()
 {
-    return (struct nhregex *) alloc(sizeof(struct nhregex));
+    struct nhregex *re = (struct nhregex *) alloc(sizeof(struct nhregex));
+
+    re->err = 0;
+    re->compiled = FALSE;
+    return re;
 }
 
 boolean
@@ -62,6 +75,9 @@ regex_compile(const char *s, struct nhregex *re)
 {
     if (!re)
         return FALSE;
+    if (re->compiled)
+        regfree(&re->re);
+    re->compiled = TRUE;
     if ((re->err = regcomp(&re->re, s, REG_EXTENDED | REG_NOSUB)))
         return FALSE;
     return TRUE;
@@ -98,9 +114,23 @@ regex_match(const char *s, struct nhregex *re)
     return TRUE;
 }
 
+boolean
+regex_compile_set(const char *const *s, int n, struct nhregex *re)
+{
+    char *pat;
+    boolean res;
+
+    if (!re || n < 1 || !(pat = regex_set_pattern(s, n)))
+        return FALSE;
+    res = regex_compile(pat, re);
+    free((genericptr_t) pat);
+    return res;
+}
+
 void
 regex_free(struct nhregex *re)
 {
-    regfree(&re->re);
+    if (re->compiled)
+        regfree(&re->re);
     free(re);
 }
@@ -324,6 +324,60 @@ void introff() /* disable kbd interrupts if required*/
 #endif
 }
 
+/*
+ * Keystrokes are read a burst at a time: once the one being waited for
+ * has arrived, whatever else the terminal already has is drained without
+ * blocking.  unix_typeahead() says how many are left over, so the game
+ * can tell pasted or scripted input from a player who's still deciding.
+ */
+#if defined(POSIX_TYPES) && !defined(LINUX)
+#include <sys/ioctl.h>
+#endif
+
+static unsigned char keybuf[BUFSZ];
+static int kb_head = 0, kb_tail = 0;
+
+int
+unix_tgetch()
+{
+    unsigned char c;
+
+    if (kb_head == kb_tail) {
+        if (read(fileno(stdin), (genericptr_t) &c, 1) != 1)
+            return EOF;
+        kb_head = kb_tail = 0;
+        keybuf[kb_tail++] = c;
+        (void) unix_typeahead();
+    }
+    return (int) keybuf[kb_head++];
+}
+
+/* number of keystrokes which can be read without waiting */
+int
+unix_typeahead()
+{
+#ifdef FIONREAD
+    int avail = 0, room, n;
+
+    if (kb_head > 0) {
+        (void) memmove((genericptr_t) keybuf,
+                       (genericptr_t) &keybuf[kb_head],
+                       (size_t) (kb_tail - kb_head));
+        kb_tail -= kb_head;
+        kb_head = 0;
+    }
+    room = (int) sizeof keybuf - kb_tail;
+    if (room > 0 && ioctl(fileno(stdin), FIONREAD, &avail) == 0
+        && avail > 0) {
+        n = (int) read(fileno(stdin), (genericptr_t) &keybuf[kb_tail],
+                       (size_t) min(avail, room));
+        if (n > 0)
+            kb_tail += n;
+    }
+#endif /* FIONREAD */
+    return kb_tail - kb_head;
+}
+
 #ifdef _M_UNIX /* SCO UNIX (3.2.4), from Andreas Arens */
 #include <sys/console.h>
 
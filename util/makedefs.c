@@ -22,6 +22,7 @@
 #include "context.h"
 #include "flag.h"
 #include "dlb.h"
+#include "nametab.h"
 
 /* version information */
 #ifdef SHORT_FILENAMES
@@ -186,6 +187,12 @@ static boolean FDECL(h_filter, (char *));
 static boolean FDECL(ranged_attk, (struct permonst *));
 static int FDECL(mstrength, (struct permonst *));
 static void NDECL(build_savebones_compat_string);
+static unsigned long FDECL(namehash, (const char *, int));
+static void NDECL(nt_reset);
+static void FDECL(nt_add, (const char *, BOOLEAN_P, int));
+static void FDECL(nt_add_objvariants, (const char *, BOOLEAN_P, int));
+static void FDECL(nt_emit, (const char *));
+static void NDECL(do_nametabs);
 static void NDECL(windowing_sanity);
 
 static boolean FDECL(qt_comment, (char *));
@@ -2281,6 +2288,7 @@ do_monstr()
     }
     Fprintf(ofp, "%s", Dont_Edit_Code);
     Fprintf(ofp, "#include \"config.h\"\n");
+    Fprintf(ofp, "#include \"nametab.h\"\n");
     Fprintf(ofp, "\nconst int monstr[] = {\n");
     for (ptr = &mons[0], j = 0; ptr->mlet; ptr++) {
         SpinCursor(3);
@@ -2291,6 +2299,8 @@ do_monstr()
     /* might want to insert a final 0 entry here instead of just newline */
     Fprintf(ofp, "%s};\n", (j & 15) ? "\n" : "");
 
+    do_nametabs();
+
     Fprintf(ofp, "\nvoid NDECL(monstr_init);\n");
     Fprintf(ofp, "\nvoid\n");
     Fprintf(ofp, "monstr_init()\n");
@@ -2303,6 +2313,327 @@ do_monstr()
     return;
 }
 
+/*
+ * Perfect hash tables for name lookups, written into monstr.c.
+ * See nametab.h for the table layout and key normalization.
+ */
+#define MAXNTKEYS 2500
+#define MAXNTVALS 8
+
+struct nt_key {
+    char key[BUFSZ];
+    short vals[MAXNTVALS];
+    int nvals;
+    int bucket;
+};
+
+static struct nt_key *ntkeys = 0;
+static int nntkeys;
+
+/* monster name variants which the lowercased mname doesn't cover;
+   earlier entries take precedence over monster names */
+static const struct {
+    const char *alt, *mname;
+} mon_altnames[] = {
+    /* Alternate spellings */
+    { "grey dragon", "gray dragon" },
+    { "baby grey dragon", "baby gray dragon" },
+    { "grey unicorn", "gray unicorn" },
+    { "grey ooze", "gray ooze" },
+    { "gray-elf", "Grey-elf" },
+    { "mindflayer", "mind flayer" },
+    { "master mindflayer", "master mind flayer" },
+    /* More alternates; priest and priestess are separate monster
+       types but that isn't the case for {aligned,high} priests */
+    { "aligned priestess", "aligned priest" },
+    { "high priestess", "high priest" },
+    /* Inappropriate singularization by -ves check in name_to_mon() */
+    { "master of thief", "Master of Thieves" },
+    /* Potential misspellings where we want to avoid falling back
+       to the rank title prefix (input has been singularized) */
+    { "master thief", "Master of Thieves" },
+    { "master of assassin", "Master Assassin" },
+    /* Outdated names */
+    { "invisible stalker", "stalker" },
+    { "high-elf", "Elvenking" }, /* PM_HIGH_ELF is obsolete */
+    { "halfling", "hobbit" },    /* potential guess for polyself */
+    /* Hyphenated names */
+    { "ki rin", "ki-rin" },
+    { "uruk hai", "Uruk-hai" },
+    { "orc captain", "orc-captain" },
+    { "woodland elf", "Woodland-elf" },
+    { "green elf", "Green-elf" },
+    { "grey elf", "Grey-elf" },
+    { "gray elf", "Grey-elf" },
+    { "elf lord", "elf-lord" },
+    { "olog hai", "Olog-hai" },
+    { "arch lich", "arch-lich" },
+    /* Some irregular plurals */
+    { "incubi", "incubus" },
+    { "succubi", "succubus" },
+    { "violet fungi", "violet fungus" },
+    { "homunculi", "homunculus" },
+    { "baluchitheria", "baluchitherium" },
+    { "lurkers above", "lurker above" },
+    { "cavemen", "caveman" },
+    { "cavewomen", "cavewoman" },
+    { "djinn", "djinni" },
+    { "mumakil", "mumak" },
+    { "erinyes", "erinys" },
+};
+
+static unsigned long
+namehash(key, seed)
+const char *key;
+int seed;
+{
+    unsigned long h = NAMEHASH_BASIS ^ NAMEHASH_SEED(seed);
+
+    while (*key)
+        h = NAMEHASH_STEP(h, *key++);
+    return h;
+}
+
+static void
+nt_reset()
+{
+    if (!ntkeys
+        && !(ntkeys = (struct nt_key *) malloc(MAXNTKEYS
+                                                * sizeof (struct nt_key)))) {
+        Fprintf(stderr, "makedefs: out of memory for name tables\n");
+        exit(EXIT_FAILURE);
+    }
+    nntkeys = 0;
+}
+
+/* add a key (normalized here) for value 'val' */
+static void
+nt_add(raw, squeeze, val)
+const char *raw;
+boolean squeeze; /* drop spaces and hyphens too */
+int val;
+{
+    char key[BUFSZ], *k = key;
+    struct nt_key *nk;
+    int i;
+
+    for (; *raw && k < &key[BUFSZ - 1]; raw++) {
+        if (squeeze && (*raw == ' ' || *raw == '-'))
+            continue;
+        *k++ = (*raw >= 'A' && *raw <= 'Z') ? *raw - 'A' + 'a' : *raw;
+    }
+    *k = '\0';
+    if (!*key)
+        return;
+
+    for (i = 0; i < nntkeys; i++)
+        if (!strcmp(ntkeys[i].key, key))
+            break;
+    nk = &ntkeys[i];
+    if (i == nntkeys) {
+        if (nntkeys >= MAXNTKEYS) {
+            Fprintf(stderr, "makedefs: too many name table keys\n");
+            exit(EXIT_FAILURE);
+        }
+        Strcpy(nk->key, key);
+        nk->nvals = 0;
+        nntkeys++;
+    }
+    for (i = 0; i < nk->nvals; i++)
+        if (nk->vals[i] == val)
+            return;
+    if (nk->nvals < MAXNTVALS)
+        nk->vals[nk->nvals++] = (short) val;
+    else
+        Fprintf(stderr, "makedefs: too many values for name key \"%s\"\n",
+                key);
+}
+
+/* add an object name or description along with the alternate forms
+   that wishymatch() in objnam.c accepts for it */
+static void
+nt_add_objvariants(str, invert, val)
+const char *str;
+boolean invert; /* also "bar foo" for "foo of bar" (names only) */
+int val;
+{
+    char buf[BUFSZ];
+    const char *p;
+
+    nt_add(str, TRUE, val);
+    if (invert && (p = strstr(str, " of ")) != 0) {
+        Strcpy(buf, p + 4);
+        Strcat(buf, " ");
+        (void) strncat(buf, str, (size_t) (p - str));
+        nt_add(buf, TRUE, val);
+    }
+    if (!strncmp(str, "dwarvish ", 9)) {
+        Sprintf(buf, "dwarven %s", str + 9);
+        nt_add(buf, TRUE, val);
+    } else if (!strncmp(str, "elven ", 6)) {
+        Sprintf(buf, "elvish %s", str + 6);
+        nt_add(buf, TRUE, val);
+        Sprintf(buf, "elfin %s", str + 6);
+        nt_add(buf, TRUE, val);
+    } else if (!strncmp(str, "detect ", 7)) {
+        /* "<foo> detection" and, for "detect monsters", the singular */
+        Sprintf(buf, "%s detection", str + 7);
+        nt_add(buf, TRUE, val);
+        if (!strcmp(str + 7, "monsters"))
+            nt_add("monster detection", TRUE, val);
+    } else if ((p = strstr(str, " detection")) != 0 && !p[10]) {
+        /* "detect <foo>" and "detect <foo>s" */
+        Sprintf(buf, "detect %.*s", (int) (p - str), str);
+        nt_add(buf, TRUE, val);
+        Strcat(buf, "s");
+        nt_add(buf, TRUE, val);
+    } else if ((p = strstr(str, "ability")) != 0 && !p[7]) {
+        Sprintf(buf, "%.*sabilities", (int) (p - str), str);
+        nt_add(buf, TRUE, val);
+    } else if (!strcmp(str, "aluminum")) {
+        nt_add("aluminium", TRUE, val);
+    }
+}
+
+/* build the hash-and-displace tables for the current keys and write
+   them out as <name>_ents[], <name>_disp[], <name>_vals[] and the
+   struct nametab <name>_nametab */
+static void
+nt_emit(name)
+const char *name;
+{
+    int nents, ndisp, i, j, k, b, d, nv, bs;
+    int *slotkey, *bstart, *members, *slots;
+    short *disp;
+    boolean ok;
+
+    ndisp = nntkeys / 4 + 1;
+    nents = nntkeys + nntkeys / 4 + 1;
+    slotkey = (int *) malloc(nents * sizeof (int));
+    members = (int *) malloc(nntkeys * sizeof (int));
+    slots = (int *) malloc(nntkeys * sizeof (int));
+    bstart = (int *) malloc((ndisp + 1) * sizeof (int));
+    disp = (short *) malloc(ndisp * sizeof (short));
+    if (!slotkey || !members || !slots || !bstart || !disp) {
+        Fprintf(stderr, "makedefs: out of memory for name table %s\n", name);
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < nents; i++)
+        slotkey[i] = -1;
+    for (i = 0; i < nntkeys; i++)
+        ntkeys[i].bucket = (int) (namehash(ntkeys[i].key, 0)
+                                  % (unsigned long) ndisp);
+    /* group key indices by bucket: members[bstart[b] .. bstart[b+1]-1] */
+    for (b = 0, k = 0; b < ndisp; b++) {
+        bstart[b] = k;
+        for (i = 0; i < nntkeys; i++)
+            if (ntkeys[i].bucket == b)
+                members[k++] = i;
+    }
+    bstart[ndisp] = k;
+
+    /* place the biggest buckets first, while there is the most room */
+    for (bs = MAXNTKEYS; bs > 0; bs--)
+        for (b = 0; b < ndisp; b++) {
+            if (bstart[b + 1] - bstart[b] != bs)
+                continue;
+            for (d = 1, ok = FALSE; d < 32767 && !ok; d++) {
+                ok = TRUE;
+                for (i = bstart[b]; i < bstart[b + 1] && ok; i++) {
+                    slots[i] = (int) (namehash(ntkeys[members[i]].key, d)
+                                      % (unsigned long) nents);
+                    if (slotkey[slots[i]] >= 0)
+                        ok = FALSE;
+                    for (j = bstart[b]; j < i && ok; j++)
+                        if (slots[j] == slots[i])
+                            ok = FALSE;
+                }
+            }
+            if (!ok) {
+                Fprintf(stderr, "makedefs: can't place name table %s\n",
+                        name);
+                exit(EXIT_FAILURE);
+            }
+            disp[b] = (short) (d - 1);
+            for (i = bstart[b]; i < bstart[b + 1]; i++)
+                slotkey[slots[i]] = members[i];
+        }
+
+    Fprintf(ofp, "\nstatic const short %s_vals[] = {\n", name);
+    for (i = 0, nv = 0; i < nntkeys; i++)
+        for (j = 0; j < ntkeys[i].nvals; j++)
+            Fprintf(ofp, "%4d,%c", ntkeys[i].vals[j],
+                    (++nv % 12) ? ' ' : '\n');
+    Fprintf(ofp, "%s};\n", (nv % 12) ? "\n" : "");
+
+    Fprintf(ofp, "\nstatic const short %s_disp[] = {\n", name);
+    for (b = 0; b < ndisp; b++)
+        Fprintf(ofp, "%5d,%c", disp[b], ((b + 1) % 10) ? ' ' : '\n');
+    Fprintf(ofp, "%s};\n", (ndisp % 10) ? "\n" : "");
+
+    Fprintf(ofp, "\nstatic const struct nametab_ent %s_ents[] = {\n", name);
+    for (i = 0; i < nents; i++) {
+        if ((k = slotkey[i]) < 0) {
+            Fprintf(ofp, "    { (const char *) 0, 0, 0 },\n");
+            continue;
+        }
+        for (j = 0, nv = 0; j < k; j++)
+            nv += ntkeys[j].nvals;
+        Fprintf(ofp, "    { \"%s\", %d, %d },\n", ntkeys[k].key, nv,
+                ntkeys[k].nvals);
+    }
+    Fprintf(ofp, "};\n");
+
+    Fprintf(ofp, "\nconst struct nametab %s_nametab = {\n", name);
+    Fprintf(ofp, "    %s_ents, %d, %s_disp, %d, %s_vals\n", name, nents, name,
+            ndisp, name);
+    Fprintf(ofp, "};\n");
+
+    free((genericptr_t) slotkey);
+    free((genericptr_t) members);
+    free((genericptr_t) slots);
+    free((genericptr_t) bstart);
+    free((genericptr_t) disp);
+}
+
+static void
+do_nametabs()
+{
+    int i, j;
+
+    /* monster names */
+    nt_reset();
+    for (i = 0; i < SIZE(mon_altnames); i++) {
+        for (j = 0; mons[j].mlet; j++)
+            if (!strcmp(mons[j].mname, mon_altnames[i].mname))
+                break;
+        if (!mons[j].mlet) {
+            Fprintf(stderr, "makedefs: unknown monster \"%s\"\n",
+                    mon_altnames[i].mname);
+            exit(EXIT_FAILURE);
+        }
+        nt_add(mon_altnames[i].alt, FALSE, j);
+    }
+    for (j = 0; mons[j].mlet; j++)
+        nt_add(mons[j].mname, FALSE, j);
+    nt_emit("mon");
+
+    /* object names; descriptions are indexed by their obj_descr[] slot
+       since o_init shuffles which object wears which description */
+    nt_reset();
+    for (i = 0; !i || objects[i].oc_class != ILLOBJ_CLASS; i++)
+        if (obj_descr[i].oc_name)
+            nt_add_objvariants(obj_descr[i].oc_name, TRUE, i);
+    nt_emit("objname");
+
+    nt_reset();
+    for (i = 0; !i || objects[i].oc_class != ILLOBJ_CLASS; i++)
+        if (obj_descr[i].oc_descr)
+            nt_add_objvariants(obj_descr[i].oc_descr, FALSE, i);
+    nt_emit("objdesc");
+}
+
 void
 do_permonst()
 {
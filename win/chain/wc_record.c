@@ -0,0 +1,1498 @@
+/* NetHack 3.6	wc_record.c	$NHDT-Date$  $NHDT-Branch$:$NHDT-Revision$ */
+/* Copyright (c) 2018 by NetHack DevTeam                          */
+/* NetHack may be freely redistributed.  See license for details. */
+
+/*
+ * +record and +replay: capture a session's input and play it back.
+ *
+ * +record passes every call through to the next link, and writes the
+ * answer to each call which returns player input (nhgetch, nh_poskey,
+ * yn_function, getlin, get_ext_cmd, select_menu, message_menu, and the
+ * askname and player_selection results) to a binary log, together with
+ * the random number seeds.  The log is ${NH_RECORD}, or HACKDIR/wcrec.PID.
+ *
+ * +replay reads such a log from ${NH_REPLAY}, reseeds the random number
+ * streams from it, and answers the core's input calls from it.  Nothing
+ * is passed on to the window port, so the game runs headless and without
+ * delays; raw_print output still goes to stdout.  When the log runs out
+ * the game ends without saving.  A replay needs the same options and
+ * starting state as the recording; a restored game also needs the save
+ * file it started from.  Each record carries the turn counter, and a
+ * replay which no longer matches it says so on stderr.
+ *
+ * Menu choices are stored as the position of the chosen item among the
+ * menu's add_menu() calls, since identifiers are often pointers.
+ * Extended commands are stored by name so that logs survive changes to
+ * the command table.  Each record also carries the window port's typeahead
+ * count, so that a replay coalesces repeated commands just as the recorded
+ * game did and reads the same keys on the same turns.
+ *
+ * Log format: the header "NHWCR2\n" and the seed string (as accepted by
+ * -seed), then records of one tag byte, the turn, the typeahead count, and
+ * the tag's fields.
+ * Integers are 4 bytes, least significant first; strings are a length
+ * followed by that many bytes.
+ */
+
+#include "hack.h"
+#include "func_tab.h"
+
+#include <errno.h>
+
+#define WCR_MAGIC "NHWCR2\n"
+
+#define WCR_KEY 'k'     /* nhgetch: key */
+#define WCR_POSKEY 'p'  /* nh_poskey: key, x, y, mod */
+#define WCR_YN 'y'      /* yn_function: answer */
+#define WCR_LINE 'l'    /* getlin: string */
+#define WCR_EXTCMD 'x'  /* get_ext_cmd: command name, "" for none */
+#define WCR_MENU 'm'    /* select_menu: n, then n (item, count) pairs */
+#define WCR_MSGMENU 'g' /* message_menu: answer */
+#define WCR_NAME 'a'    /* askname: plname */
+#define WCR_ROLE 'r'    /* player_selection: role, race, gender, align */
+
+/* identifiers of the items added to each menu window */
+struct wcr_menu {
+    struct wcr_menu *next;
+    winid win;
+    int n, max;
+    anything *ids;
+};
+
+struct wcr_data {
+    struct chain_procs *nprocs;
+    void *ndata;
+
+    int linknum;
+    struct wcr_menu *menus;
+};
+
+static FILE *wcr_recf = 0, *wcr_playf = 0;
+static long wcr_nrecs = 0L;     /* records read by +replay */
+static long wcr_badturn = -1L;  /* first record whose turn didn't match */
+static winid wcr_lastwin = 0;   /* window ids handed out by +replay */
+
+static void FDECL(wcr_seeds, (char *));
+static struct wcr_menu *FDECL(wcr_findmenu, (struct wcr_data *, winid,
+                                             BOOLEAN_P));
+static void FDECL(wcr_addmenu, (struct wcr_data *, winid, const anything *));
+static void FDECL(wcr_dropmenu, (struct wcr_data *, winid));
+static void FDECL(wcr_putint, (long));
+static void FDECL(wcr_putstr, (const char *));
+static void FDECL(wcr_begin, (int));
+static void NDECL(wcr_end);
+static long NDECL(wcr_getint);
+static void FDECL(wcr_getstr, (char *, int));
+static void FDECL(wcr_expect, (int));
+static void FDECL(wcr_finish, (const char *)) NORETURN;
+
+/* the current stream seeds, in -seed form */
+static void
+wcr_seeds(buf)
+char *buf;
+{
+    int i;
+
+    *buf = '\0';
+    for (i = 0; i < NUM_RNG_STREAMS; i++)
+        Sprintf(eos(buf), "%s%s:%lu", i ? "," : "", rng_name(i),
+                rng_seed(i));
+}
+
+static struct wcr_menu *
+wcr_findmenu(tdp, win, create)
+struct wcr_data *tdp;
+winid win;
+boolean create;
+{
+    struct wcr_menu *m;
+
+    for (m = tdp->menus; m; m = m->next)
+        if (m->win == win)
+            return m;
+    if (!create)
+        return (struct wcr_menu *) 0;
+    m = (struct wcr_menu *) alloc(sizeof *m);
+    m->win = win;
+    m->n = m->max = 0;
+    m->ids = (anything *) 0;
+    m->next = tdp->menus;
+    tdp->menus = m;
+    return m;
+}
+
+static void
+wcr_addmenu(tdp, win, id)
+struct wcr_data *tdp;
+winid win;
+const anything *id;
+{
+    struct wcr_menu *m = wcr_findmenu(tdp, win, TRUE);
+
+    if (m->n == m->max) {
+        anything *newids;
+
+        m->max = m->max ? m->max * 2 : 32;
+        newids = (anything *) alloc(m->max * sizeof *newids);
+        if (m->n)
+            (void) memcpy((genericptr_t) newids, (genericptr_t) m->ids,
+                          m->n * sizeof *newids);
+        if (m->ids)
+            free((genericptr_t) m->ids);
+        m->ids = newids;
+    }
+    m->ids[m->n++] = *id;
+}
+
+static void
+wcr_dropmenu(tdp, win)
+struct wcr_data *tdp;
+winid win;
+{
+    struct wcr_menu *m, **mp;
+
+    for (mp = &tdp->menus; (m = *mp) != 0; mp = &m->next)
+        if (m->win == win) {
+            *mp = m->next;
+            if (m->ids)
+                free((genericptr_t) m->ids);
+            free((genericptr_t) m);
+            return;
+        }
+}
+
+static void
+wcr_putint(v)
+long v;
+{
+    unsigned long u = (unsigned long) v;
+
+    (void) putc((int) (u & 0xff), wcr_recf);
+    (void) putc((int) ((u >> 8) & 0xff), wcr_recf);
+    (void) putc((int) ((u >> 16) & 0xff), wcr_recf);
+    (void) putc((int) ((u >> 24) & 0xff), wcr_recf);
+}
+
+static void
+wcr_putstr(s)
+const char *s;
+{
+    int len = s ? (int) strlen(s) : 0;
+
+    wcr_putint((long) len);
+    if (len)
+        (void) fwrite((genericptr_t) s, 1, (size_t) len, wcr_recf);
+}
+
+static void
+wcr_begin(tag)
+int tag;
+{
+    (void) putc(tag, wcr_recf);
+    wcr_putint(moves);
+    wcr_putint((long) iflags.typeahead);
+}
+
+/* records are flushed as they're completed so that a log survives a
+   crash or hangup */
+static void
+wcr_end()
+{
+    (void) fflush(wcr_recf);
+}
+
+static long
+wcr_getint()
+{
+    unsigned long u = 0UL;
+    int i, c;
+
+    for (i = 0; i < 4; i++) {
+        if ((c = getc(wcr_playf)) == EOF)
+            wcr_finish("log is truncated");
+        u |= (unsigned long) (c & 0xff) << (8 * i);
+    }
+    /* sign-extend */
+    if (u & 0x80000000UL)
+        return -(long) ((~u & 0x7fffffffUL) + 1UL);
+    return (long) u;
+}
+
+static void
+wcr_getstr(buf, bufsz)
+char *buf;
+int bufsz;
+{
+    long len = wcr_getint();
+    int c;
+
+    if (len < 0L)
+        wcr_finish("bad string in log");
+    while (len-- > 0L) {
+        if ((c = getc(wcr_playf)) == EOF)
+            wcr_finish("log is truncated");
+        if (bufsz > 1) {
+            *buf++ = (char) c;
+            --bufsz;
+        }
+    }
+    *buf = '\0';
+}
+
+/* read the next record's tag, turn, and typeahead count; the record must
+   be of type tag */
+static void
+wcr_expect(tag)
+int tag;
+{
+    char buf[BUFSZ];
+    int c;
+    long turn;
+
+    if ((c = getc(wcr_playf)) == EOF)
+        wcr_finish((char *) 0);
+    if (c != tag) {
+        Sprintf(buf, "record %ld is '%c', but the game wants '%c'",
+                wcr_nrecs + 1L, c, tag);
+        wcr_finish(buf);
+    }
+    turn = wcr_getint();
+    iflags.typeahead = (int) wcr_getint();
+    ++wcr_nrecs;
+    if (turn != moves && wcr_badturn < 0L) {
+        wcr_badturn = wcr_nrecs;
+        (void) fprintf(stderr,
+                "replay: record %ld was made on turn %ld, now turn %ld\n",
+                       wcr_nrecs, turn, moves);
+    }
+}
+
+/* end of the log (msg null) or a fatal mismatch; stop the game */
+static void
+wcr_finish(msg)
+const char *msg;
+{
+    if (msg)
+        (void) fprintf(stderr, "replay: %s\n", msg);
+    (void) fprintf(stderr, "replay: %ld records, ended on turn %ld%s\n",
+                   wcr_nrecs, moves,
+                   (wcr_badturn >= 0L) ? " (diverged)" : "");
+    if (wcr_playf)
+        (void) fclose(wcr_playf), wcr_playf = 0;
+#ifdef PERFSTATS
+    perfstats_dump();
+#endif
+    clearlocks();
+    nh_terminate(msg ? EXIT_FAILURE : EXIT_SUCCESS);
+    /*NOTREACHED*/
+}
+
+/***
+ *** +record
+ ***/
+
+void *
+record_procs_chain(cmd, n, me, nextprocs, nextdata)
+int cmd;
+int n;
+void *me;
+void *nextprocs;
+void *nextdata;
+{
+    switch (cmd) {
+    case WINCHAIN_ALLOC: {
+        struct wcr_data *tdp = calloc(1, sizeof(struct wcr_data));
+        tdp->linknum = n;
+        return tdp;
+    }
+    case WINCHAIN_INIT: {
+        struct wcr_data *tdp = me;
+        tdp->nprocs = nextprocs;
+        tdp->ndata = nextdata;
+        return tdp;
+    }
+    default:
+        raw_printf("record_procs_chain: bad cmd\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void
+record_procs_init(dir)
+int dir;
+{
+    char fname[BUFSZ], seeds[BUFSZ];
+    const char *envname;
+
+    if (dir != WININIT)
+        return;
+
+    envname = nh_getenv("NH_RECORD");
+    if (envname && *envname)
+        copynchars(fname, envname, BUFSZ - 1);
+    else
+        Sprintf(fname, "%s/wcrec.%d", HACKDIR, getpid());
+    wcr_recf = fopen(fname, "wb");
+    if (wcr_recf == NULL) {
+        fprintf(stderr, "Can't open record file %s: %s\n", fname,
+                strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    /* restart the streams here so that +replay can do the same */
+    wcr_seeds(seeds);
+    (void) parse_rng_seeds(seeds);
+    setrandom();
+
+    (void) fputs(WCR_MAGIC, wcr_recf);
+    wcr_putstr(seeds);
+    wcr_end();
+}
+
+void
+record_init_nhwindows(vp, argcp, argv)
+void *vp;
+int *argcp;
+char **argv;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_init_nhwindows)(tdp->ndata, argcp, argv);
+}
+
+void
+record_player_selection(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_player_selection)(tdp->ndata);
+    wcr_begin(WCR_ROLE);
+    wcr_putint((long) flags.initrole);
+    wcr_putint((long) flags.initrace);
+    wcr_putint((long) flags.initgend);
+    wcr_putint((long) flags.initalign);
+    wcr_end();
+}
+
+void
+record_askname(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_askname)(tdp->ndata);
+    wcr_begin(WCR_NAME);
+    wcr_putstr(plname);
+    wcr_end();
+}
+
+void
+record_get_nh_event(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_get_nh_event)(tdp->ndata);
+}
+
+void
+record_exit_nhwindows(vp, str)
+void *vp;
+const char *str;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_exit_nhwindows)(tdp->ndata, str);
+}
+
+void
+record_suspend_nhwindows(vp, str)
+void *vp;
+const char *str;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_suspend_nhwindows)(tdp->ndata, str);
+}
+
+void
+record_resume_nhwindows(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_resume_nhwindows)(tdp->ndata);
+}
+
+winid
+record_create_nhwindow(vp, type)
+void *vp;
+int type;
+{
+    struct wcr_data *tdp = vp;
+
+    return (*tdp->nprocs->win_create_nhwindow)(tdp->ndata, type);
+}
+
+void
+record_clear_nhwindow(vp, window)
+void *vp;
+winid window;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_clear_nhwindow)(tdp->ndata, window);
+}
+
+void
+record_display_nhwindow(vp, window, blocking)
+void *vp;
+winid window;
+BOOLEAN_P blocking;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_display_nhwindow)(tdp->ndata, window, blocking);
+}
+
+void
+record_destroy_nhwindow(vp, window)
+void *vp;
+winid window;
+{
+    struct wcr_data *tdp = vp;
+
+    wcr_dropmenu(tdp, window);
+    (*tdp->nprocs->win_destroy_nhwindow)(tdp->ndata, window);
+}
+
+void
+record_curs(vp, window, x, y)
+void *vp;
+winid window;
+int x;
+int y;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_curs)(tdp->ndata, window, x, y);
+}
+
+void
+record_putstr(vp, window, attr, str)
+void *vp;
+winid window;
+int attr;
+const char *str;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_putstr)(tdp->ndata, window, attr, str);
+}
+
+void
+record_putmixed(vp, window, attr, str)
+void *vp;
+winid window;
+int attr;
+const char *str;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_putmixed)(tdp->ndata, window, attr, str);
+}
+
+void
+record_display_file(vp, fname, complain)
+void *vp;
+const char *fname;
+boolean complain;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_display_file)(tdp->ndata, fname, complain);
+}
+
+void
+record_start_menu(vp, window)
+void *vp;
+winid window;
+{
+    struct wcr_data *tdp = vp;
+
+    wcr_findmenu(tdp, window, TRUE)->n = 0;
+    (*tdp->nprocs->win_start_menu)(tdp->ndata, window);
+}
+
+void
+record_add_menu(vp, window, glyph, identifier, ch, gch, attr, str,
+                preselected)
+void *vp;
+winid window;
+int glyph;
+const anything *identifier;
+char ch;
+char gch;
+int attr;
+const char *str;
+boolean preselected;
+{
+    struct wcr_data *tdp = vp;
+
+    wcr_addmenu(tdp, window, identifier);
+    (*tdp->nprocs->win_add_menu)(tdp->ndata, window, glyph, identifier, ch,
+                                 gch, attr, str, preselected);
+}
+
+void
+record_end_menu(vp, window, prompt)
+void *vp;
+winid window;
+const char *prompt;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_end_menu)(tdp->ndata, window, prompt);
+}
+
+int
+record_select_menu(vp, window, how, menu_list)
+void *vp;
+winid window;
+int how;
+menu_item **menu_list;
+{
+    struct wcr_data *tdp = vp;
+    struct wcr_menu *m;
+    int rv, i, j;
+
+    rv = (*tdp->nprocs->win_select_menu)(tdp->ndata, window, how,
+                                         menu_list);
+    m = wcr_findmenu(tdp, window, FALSE);
+    wcr_begin(WCR_MENU);
+    wcr_putint((long) rv);
+    for (i = 0; i < rv; i++) {
+        for (j = 0; m && j < m->n; j++)
+            if (!memcmp((genericptr_t) &m->ids[j],
+                        (genericptr_t) &(*menu_list)[i].item,
+                        sizeof (anything)))
+                break;
+        wcr_putint((long) ((m && j < m->n) ? j : -1));
+        wcr_putint((*menu_list)[i].count);
+    }
+    wcr_end();
+    return rv;
+}
+
+char
+record_message_menu(vp, let, how, mesg)
+void *vp;
+char let;
+int how;
+const char *mesg;
+{
+    struct wcr_data *tdp = vp;
+    char rv;
+
+    rv = (*tdp->nprocs->win_message_menu)(tdp->ndata, let, how, mesg);
+    wcr_begin(WCR_MSGMENU);
+    wcr_putint((long) rv);
+    wcr_end();
+    return rv;
+}
+
+void
+record_update_inventory(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_update_inventory)(tdp->ndata);
+}
+
+void
+record_mark_synch(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_mark_synch)(tdp->ndata);
+}
+
+void
+record_wait_synch(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_wait_synch)(tdp->ndata);
+}
+
+#ifdef CLIPPING
+void
+record_cliparound(vp, x, y)
+void *vp;
+int x;
+int y;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_cliparound)(tdp->ndata, x, y);
+}
+#endif
+
+#ifdef POSITIONBAR
+void
+record_update_positionbar(vp, posbar)
+void *vp;
+char *posbar;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_update_positionbar)(tdp->ndata, posbar);
+}
+#endif
+
+void
+record_print_glyph(vp, window, x, y, glyph, bkglyph)
+void *vp;
+winid window;
+xchar x, y;
+int glyph, bkglyph;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_print_glyph)(tdp->ndata, window, x, y, glyph,
+                                    bkglyph);
+}
+
+void
+record_raw_print(vp, str)
+void *vp;
+const char *str;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_raw_print)(tdp->ndata, str);
+}
+
+void
+record_raw_print_bold(vp, str)
+void *vp;
+const char *str;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_raw_print_bold)(tdp->ndata, str);
+}
+
+int
+record_nhgetch(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+    int rv;
+
+    rv = (*tdp->nprocs->win_nhgetch)(tdp->ndata);
+    wcr_begin(WCR_KEY);
+    wcr_putint((long) rv);
+    wcr_end();
+    return rv;
+}
+
+int
+record_nh_poskey(vp, x, y, mod)
+void *vp;
+int *x;
+int *y;
+int *mod;
+{
+    struct wcr_data *tdp = vp;
+    int rv;
+
+    rv = (*tdp->nprocs->win_nh_poskey)(tdp->ndata, x, y, mod);
+    wcr_begin(WCR_POSKEY);
+    wcr_putint((long) rv);
+    wcr_putint((long) *x);
+    wcr_putint((long) *y);
+    wcr_putint((long) *mod);
+    wcr_end();
+    return rv;
+}
+
+void
+record_nhbell(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_nhbell)(tdp->ndata);
+}
+
+int
+record_doprev_message(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    return (*tdp->nprocs->win_doprev_message)(tdp->ndata);
+}
+
+char
+record_yn_function(vp, query, resp, def)
+void *vp;
+const char *query, *resp;
+char def;
+{
+    struct wcr_data *tdp = vp;
+    char rv;
+
+    rv = (*tdp->nprocs->win_yn_function)(tdp->ndata, query, resp, def);
+    wcr_begin(WCR_YN);
+    wcr_putint((long) rv);
+    wcr_end();
+    return rv;
+}
+
+void
+record_getlin(vp, query, bufp)
+void *vp;
+const char *query;
+char *bufp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_getlin)(tdp->ndata, query, bufp);
+    wcr_begin(WCR_LINE);
+    wcr_putstr(bufp);
+    wcr_end();
+}
+
+int
+record_get_ext_cmd(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+    int rv;
+
+    rv = (*tdp->nprocs->win_get_ext_cmd)(tdp->ndata);
+    wcr_begin(WCR_EXTCMD);
+    wcr_putstr((rv >= 0) ? extcmdlist[rv].ef_txt : "");
+    wcr_end();
+    return rv;
+}
+
+void
+record_number_pad(vp, state)
+void *vp;
+int state;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_number_pad)(tdp->ndata, state);
+}
+
+void
+record_delay_output(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_delay_output)(tdp->ndata);
+}
+
+#ifdef CHANGE_COLOR
+void
+record_change_color(vp, color, value, reverse)
+void *vp;
+int color;
+long value;
+int reverse;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_change_color)(tdp->ndata, color, value, reverse);
+}
+
+#ifdef MAC
+void
+record_change_background(vp, bw)
+void *vp;
+int bw;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_change_background)(tdp->ndata, bw);
+}
+
+short
+record_set_font_name(vp, window, font)
+void *vp;
+winid window;
+char *font;
+{
+    struct wcr_data *tdp = vp;
+
+    return (*tdp->nprocs->win_set_font_name)(tdp->ndata, window, font);
+}
+#endif
+
+char *
+record_get_color_string(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    return (*tdp->nprocs->win_get_color_string)(tdp->ndata);
+}
+
+#endif
+
+/* other defs that really should go away (they're tty specific) */
+void
+record_start_screen(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_start_screen)(tdp->ndata);
+}
+
+void
+record_end_screen(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_end_screen)(tdp->ndata);
+}
+
+void
+record_outrip(vp, tmpwin, how, when)
+void *vp;
+winid tmpwin;
+int how;
+time_t when;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_outrip)(tdp->ndata, tmpwin, how, when);
+}
+
+void
+record_preference_update(vp, pref)
+void *vp;
+const char *pref;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_preference_update)(tdp->ndata, pref);
+}
+
+char *
+record_getmsghistory(vp, init)
+void *vp;
+boolean init;
+{
+    struct wcr_data *tdp = vp;
+
+    return (*tdp->nprocs->win_getmsghistory)(tdp->ndata, init);
+}
+
+void
+record_putmsghistory(vp, msg, is_restoring)
+void *vp;
+const char *msg;
+boolean is_restoring;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_putmsghistory)(tdp->ndata, msg, is_restoring);
+}
+
+void
+record_status_init(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_status_init)(tdp->ndata);
+}
+
+void
+record_status_finish(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_status_finish)(tdp->ndata);
+}
+
+void
+record_status_enablefield(vp, fieldidx, nm, fmt, enable)
+void *vp;
+int fieldidx;
+const char *nm;
+const char *fmt;
+boolean enable;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_status_enablefield)(tdp->ndata, fieldidx, nm, fmt,
+                                           enable);
+}
+
+void
+record_status_update(vp, idx, ptr, chg, percent, color, colormasks)
+void *vp;
+int idx, chg, percent, color;
+genericptr_t ptr;
+unsigned long *colormasks;
+{
+    struct wcr_data *tdp = vp;
+
+    (*tdp->nprocs->win_status_update)(tdp->ndata, idx, ptr, chg, percent,
+                                      color, colormasks);
+}
+
+boolean
+record_can_suspend(vp)
+void *vp;
+{
+    struct wcr_data *tdp = vp;
+
+    return (*tdp->nprocs->win_can_suspend)(tdp->ndata);
+}
+
+struct chain_procs record_procs = {
+    "+record", 0, /* wincap */
+    0,            /* wincap2 */
+    record_init_nhwindows,
+    record_player_selection, record_askname, record_get_nh_event,
+    record_exit_nhwindows, record_suspend_nhwindows, record_resume_nhwindows,
+    record_create_nhwindow, record_clear_nhwindow, record_display_nhwindow,
+    record_destroy_nhwindow, record_curs, record_putstr, record_putmixed,
+    record_display_file, record_start_menu, record_add_menu, record_end_menu,
+    record_select_menu, record_message_menu, record_update_inventory,
+    record_mark_synch, record_wait_synch,
+#ifdef CLIPPING
+    record_cliparound,
+#endif
+#ifdef POSITIONBAR
+    record_update_positionbar,
+#endif
+    record_print_glyph, record_raw_print, record_raw_print_bold,
+    record_nhgetch, record_nh_poskey, record_nhbell, record_doprev_message,
+    record_yn_function, record_getlin, record_get_ext_cmd, record_number_pad,
+    record_delay_output,
+#ifdef CHANGE_COLOR
+    record_change_color,
+#ifdef MAC
+    record_change_background, record_set_font_name,
+#endif
+    record_get_color_string,
+#endif
+
+    record_start_screen, record_end_screen,
+
+    record_outrip, record_preference_update, record_getmsghistory,
+    record_putmsghistory,
+    record_status_init, record_status_finish, record_status_enablefield,
+    record_status_update,
+    record_can_suspend,
+};
+
+/***
+ *** +replay
+ ***/
+
+void *
+replay_procs_chain(cmd, n, me, nextprocs, nextdata)
+int cmd;
+int n;
+void *me;
+void *nextprocs;
+void *nextdata;
+{
+    switch (cmd) {
+    case WINCHAIN_ALLOC: {
+        struct wcr_data *tdp = calloc(1, sizeof(struct wcr_data));
+        tdp->linknum = n;
+        return tdp;
+    }
+    case WINCHAIN_INIT: {
+        /* the next link is kept but never called */
+        struct wcr_data *tdp = me;
+        tdp->nprocs = nextprocs;
+        tdp->ndata = nextdata;
+        return tdp;
+    }
+    default:
+        raw_printf("replay_procs_chain: bad cmd\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void
+replay_procs_init(dir)
+int dir;
+{
+    char magic[sizeof WCR_MAGIC], seeds[BUFSZ];
+    const char *fname;
+
+    if (dir != WININIT)
+        return;
+
+    fname = nh_getenv("NH_REPLAY");
+    if (!fname || !*fname) {
+        fprintf(stderr, "+replay needs NH_REPLAY set to a record file\n");
+        exit(EXIT_FAILURE);
+    }
+    wcr_playf = fopen(fname, "rb");
+    if (wcr_playf == NULL) {
+        fprintf(stderr, "Can't open record file %s: %s\n", fname,
+                strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    if (fread((genericptr_t) magic, 1, sizeof magic - 1, wcr_playf)
+            != sizeof magic - 1
+        || strncmp(magic, WCR_MAGIC, sizeof magic - 1)) {
+        fprintf(stderr, "%s is not a record file\n", fname);
+        exit(EXIT_FAILURE);
+    }
+    wcr_getstr(seeds, BUFSZ);
+    if (!parse_rng_seeds(seeds)) {
+        fprintf(stderr, "%s: bad seeds '%s'\n", fname, seeds);
+        exit(EXIT_FAILURE);
+    }
+    setrandom();
+}
+
+/* for the entries which take no arguments and have nothing to do */
+void
+replay_nop(vp)
+void *vp UNUSED;
+{
+}
+
+void
+replay_init_nhwindows(vp, argcp, argv)
+void *vp UNUSED;
+int *argcp UNUSED;
+char **argv UNUSED;
+{
+    iflags.window_inited = TRUE;
+}
+
+void
+replay_player_selection(vp)
+void *vp UNUSED;
+{
+    wcr_expect(WCR_ROLE);
+    flags.initrole = (int) wcr_getint();
+    flags.initrace = (int) wcr_getint();
+    flags.initgend = (int) wcr_getint();
+    flags.initalign = (int) wcr_getint();
+}
+
+void
+replay_askname(vp)
+void *vp UNUSED;
+{
+    wcr_expect(WCR_NAME);
+    wcr_getstr(plname, PL_NSIZ);
+}
+
+void
+replay_exit_nhwindows(vp, str)
+void *vp UNUSED;
+const char *str;
+{
+    if (str && *str)
+        (void) puts(str);
+    iflags.window_inited = FALSE;
+}
+
+void
+replay_suspend_nhwindows(vp, str)
+void *vp UNUSED;
+const char *str UNUSED;
+{
+}
+
+winid
+replay_create_nhwindow(vp, type)
+void *vp UNUSED;
+int type UNUSED;
+{
+    return ++wcr_lastwin;
+}
+
+void
+replay_clear_nhwindow(vp, window)
+void *vp UNUSED;
+winid window UNUSED;
+{
+}
+
+void
+replay_display_nhwindow(vp, window, blocking)
+void *vp UNUSED;
+winid window UNUSED;
+BOOLEAN_P blocking UNUSED;
+{
+}
+
+void
+replay_destroy_nhwindow(vp, window)
+void *vp;
+winid window;
+{
+    wcr_dropmenu((struct wcr_data *) vp, window);
+}
+
+void
+replay_curs(vp, window, x, y)
+void *vp UNUSED;
+winid window UNUSED;
+int x UNUSED;
+int y UNUSED;
+{
+}
+
+void
+replay_putstr(vp, window, attr, str)
+void *vp UNUSED;
+winid window UNUSED;
+int attr UNUSED;
+const char *str UNUSED;
+{
+}
+
+void
+replay_display_file(vp, fname, complain)
+void *vp UNUSED;
+const char *fname UNUSED;
+boolean complain UNUSED;
+{
+}
+
+void
+replay_start_menu(vp, window)
+void *vp;
+winid window;
+{
+    wcr_findmenu((struct wcr_data *) vp, window, TRUE)->n = 0;
+}
+
+void
+replay_add_menu(vp, window, glyph, identifier, ch, gch, attr, str,
+                preselected)
+void *vp;
+winid window;
+int glyph UNUSED;
+const anything *identifier;
+char ch UNUSED;
+char gch UNUSED;
+int attr UNUSED;
+const char *str UNUSED;
+boolean preselected UNUSED;
+{
+    wcr_addmenu((struct wcr_data *) vp, window, identifier);
+}
+
+void
+replay_end_menu(vp, window, prompt)
+void *vp UNUSED;
+winid window UNUSED;
+const char *prompt UNUSED;
+{
+}
+
+int
+replay_select_menu(vp, window, how, menu_list)
+void *vp;
+winid window;
+int how UNUSED;
+menu_item **menu_list;
+{
+    struct wcr_menu *m = wcr_findmenu((struct wcr_data *) vp, window, FALSE);
+    int rv, i;
+    long idx;
+
+    wcr_expect(WCR_MENU);
+    rv = (int) wcr_getint();
+    *menu_list = (menu_item *) 0;
+    if (rv <= 0)
+        return rv;
+    *menu_list = (menu_item *) alloc(rv * sizeof (menu_item));
+    for (i = 0; i < rv; i++) {
+        idx = wcr_getint();
+        if (!m || idx < 0L || idx >= (long) m->n)
+            wcr_finish("menu choice isn't in the current menu");
+        (*menu_list)[i].item = m->ids[idx];
+        (*menu_list)[i].count = wcr_getint();
+    }
+    return rv;
+}
+
+char
+replay_message_menu(vp, let, how, mesg)
+void *vp UNUSED;
+char let UNUSED;
+int how UNUSED;
+const char *mesg UNUSED;
+{
+    wcr_expect(WCR_MSGMENU);
+    return (char) wcr_getint();
+}
+
+#ifdef CLIPPING
+void
+replay_cliparound(vp, x, y)
+void *vp UNUSED;
+int x UNUSED;
+int y UNUSED;
+{
+}
+#endif
+
+#ifdef POSITIONBAR
+void
+replay_update_positionbar(vp, posbar)
+void *vp UNUSED;
+char *posbar UNUSED;
+{
+}
+#endif
+
+void
+replay_print_glyph(vp, window, x, y, glyph, bkglyph)
+void *vp UNUSED;
+winid window UNUSED;
+xchar x UNUSED, y UNUSED;
+int glyph UNUSED, bkglyph UNUSED;
+{
+}
+
+void
+replay_raw_print(vp, str)
+void *vp UNUSED;
+const char *str;
+{
+    if (str)
+        (void) puts(str);
+}
+
+int
+replay_nhgetch(vp)
+void *vp UNUSED;
+{
+    wcr_expect(WCR_KEY);
+    return (int) wcr_getint();
+}
+
+int
+replay_nh_poskey(vp, x, y, mod)
+void *vp UNUSED;
+int *x;
+int *y;
+int *mod;
+{
+    int rv;
+
+    wcr_expect(WCR_POSKEY);
+    rv = (int) wcr_getint();
+    *x = (int) wcr_getint();
+    *y = (int) wcr_getint();
+    *mod = (int) wcr_getint();
+    return rv;
+}
+
+int
+replay_doprev_message(vp)
+void *vp UNUSED;
+{
+    return 0;
+}
+
+char
+replay_yn_function(vp, query, resp, def)
+void *vp UNUSED;
+const char *query UNUSED, *resp UNUSED;
+char def UNUSED;
+{
+    wcr_expect(WCR_YN);
+    return (char) wcr_getint();
+}
+
+void
+replay_getlin(vp, query, bufp)
+void *vp UNUSED;
+const char *query UNUSED;
+char *bufp;
+{
+    wcr_expect(WCR_LINE);
+    wcr_getstr(bufp, BUFSZ);
+}
+
+int
+replay_get_ext_cmd(vp)
+void *vp UNUSED;
+{
+    char buf[BUFSZ];
+    int i;
+
+    wcr_expect(WCR_EXTCMD);
+    wcr_getstr(buf, BUFSZ);
+    if (!*buf)
+        return -1;
+    for (i = 0; extcmdlist[i].ef_txt; i++)
+        if (!strcmp(extcmdlist[i].ef_txt, buf))
+            return i;
+    wcr_finish("recorded extended command doesn't exist");
+    /*NOTREACHED*/
+    return -1;
+}
+
+void
+replay_number_pad(vp, state)
+void *vp UNUSED;
+int state UNUSED;
+{
+}
+
+#ifdef CHANGE_COLOR
+void
+replay_change_color(vp, color, value, reverse)
+void *vp UNUSED;
+int color UNUSED;
+long value UNUSED;
+int reverse UNUSED;
+{
+}
+
+#ifdef MAC
+void
+replay_change_background(vp, bw)
+void *vp UNUSED;
+int bw UNUSED;
+{
+}
+
+short
+replay_set_font_name(vp, window, font)
+void *vp UNUSED;
+winid window UNUSED;
+char *font UNUSED;
+{
+    return 0;
+}
+#endif
+
+char *
+replay_get_color_string(vp)
+void *vp UNUSED;
+{
+    return "";
+}
+
+#endif
+
+void
+replay_outrip(vp, tmpwin, how, when)
+void *vp UNUSED;
+winid tmpwin UNUSED;
+int how UNUSED;
+time_t when UNUSED;
+{
+}
+
+void
+replay_preference_update(vp, pref)
+void *vp UNUSED;
+const char *pref UNUSED;
+{
+}
+
+char *
+replay_getmsghistory(vp, init)
+void *vp UNUSED;
+boolean init UNUSED;
+{
+    return (char *) 0;
+}
+
+void
+replay_putmsghistory(vp, msg, is_restoring)
+void *vp UNUSED;
+const char *msg UNUSED;
+boolean is_restoring UNUSED;
+{
+}
+
+void
+replay_status_enablefield(vp, fieldidx, nm, fmt, enable)
+void *vp UNUSED;
+int fieldidx UNUSED;
+const char *nm UNUSED;
+const char *fmt UNUSED;
+boolean enable UNUSED;
+{
+}
+
+void
+replay_status_update(vp, idx, ptr, chg, percent, color, colormasks)
+void *vp UNUSED;
+int idx UNUSED, chg UNUSED, percent UNUSED, color UNUSED;
+genericptr_t ptr UNUSED;
+unsigned long *colormasks UNUSED;
+{
+}
+
+boolean
+replay_can_suspend(vp)
+void *vp UNUSED;
+{
+    return FALSE;
+}
+
+struct chain_procs replay_procs = {
+    "+replay", 0, /* wincap */
+    0,            /* wincap2 */
+    replay_init_nhwindows,
+    replay_player_selection, replay_askname, replay_nop,
+    replay_exit_nhwindows, replay_suspend_nhwindows, replay_nop,
+    replay_create_nhwindow, replay_clear_nhwindow, replay_display_nhwindow,
+    replay_destroy_nhwindow, replay_curs, replay_putstr, replay_putstr,
+    replay_display_file, replay_start_menu, replay_add_menu, replay_end_menu,
+    replay_select_menu, replay_message_menu, replay_nop,
+    replay_nop, replay_nop,
+#ifdef CLIPPING
+    replay_cliparound,
+#endif
+#ifdef POSITIONBAR
+    replay_update_positionbar,
+#endif
+    replay_print_glyph, replay_raw_print, replay_raw_print,
+    replay_nhgetch, replay_nh_poskey, replay_nop, replay_doprev_message,
+    replay_yn_function, replay_getlin, replay_get_ext_cmd, replay_number_pad,
+    replay_nop,
+#ifdef CHANGE_COLOR
+    replay_change_color,
+#ifdef MAC
+    replay_change_background, replay_set_font_name,
+#endif
+    replay_get_color_string,
+#endif
+
+    replay_nop, replay_nop,
+
+    replay_outrip, replay_preference_update, replay_getmsghistory,
+    replay_putmsghistory,
+    replay_nop, replay_nop, replay_status_enablefield,
+    replay_status_update,
+    replay_can_suspend,
+};
+
+/*wc_record.c*/
@@ -71,7 +71,7 @@ getlin_hook_proc hook;
 #endif
 
     for (;;) {
-        (void) fflush(stdout);
+        xflush();
         Strcat(strcat(strcpy(toplines, query), " "), obufp);
         c = pgetchar();
         if (c == '\033' || c == EOF) {
@@ -64,6 +64,31 @@ char NEARDATA *hilites[CLR_MAX]; /* terminal escapes for the various colors */
 static char *KS = (char *) 0, *KE = (char *) 0; /* keypad sequences */
 static char nullstr[] = "";
 
+/*
+ * Frame buffer.  All terminal output is collected here and handed to
+ * stdio in one piece by xflush(), which the window port calls whenever
+ * it is about to wait for input, pause, or give up the screen.  stdout's
+ * buffer is at least as big as a frame, so that's one write() per frame.
+ *
+ * While output is still in the frame, a cursor motion which is followed
+ * by another one before anything gets drawn is taken back out, and so is
+ * an attribute reset which the next attribute change merely undoes.  The
+ * latter needs to know the terminal's attribute state, which is only
+ * tracked after one of our own resets (frame_sgr_known).
+ */
+STATIC_VAR char tty_frame[TTY_FRAMESZ];
+STATIC_VAR int tty_framelen = 0;
+STATIC_VAR int frame_mv_start = -1, frame_mv_end = -1; /* last cmov() */
+STATIC_VAR int frame_sgr_start = -1, frame_sgr_end = -1; /* last reset */
+STATIC_VAR boolean frame_sgr_known = FALSE;
+STATIC_VAR int frame_color = NO_COLOR, frame_attrs = 0; /* now in effect */
+STATIC_VAR int frame_prevcolor, frame_prevattrs; /* before the last reset */
+STATIC_VAR long frame_count = 0L, frame_bytes = 0L, frame_writes = 0L;
+
+STATIC_DCL void NDECL(frame_write);
+STATIC_DCL void FDECL(frame_sgr_reset, (const char *));
+STATIC_DCL void FDECL(frame_sgr_set, (const char *, int, int));
+
 #if defined(ASCIIGRAPH) && !defined(NO_TERMS)
 extern boolean HE_resets_AS;
 #endif
@@ -321,6 +346,7 @@ int *wid, *hgt;
 #else
     init_hilite();
 #endif
+    reset_glyphmap(); /* mapglyph() caches has_color() */
 #endif
     *wid = CO;
     *hgt = LI;
@@ -408,6 +434,7 @@ tty_decgraphics_termcap_fixup()
         xputs("\033)0");
 #ifdef PC9800
     init_hilite();
+    reset_glyphmap();
 #endif
 
 #if defined(ASCIIGRAPH) && !defined(NO_TERMS)
@@ -472,6 +499,8 @@ tty_ascgraphics_hilite_fixup()
 void
 tty_start_screen()
 {
+    frame_sgr_known = FALSE;
+    tty_shadow_reset(FALSE); /* TI may or may not restore the screen */
     xputs(TI);
     xputs(VS);
 #ifdef PC9800
@@ -503,6 +532,9 @@ tty_end_screen()
     clear_screen();
     xputs(VE);
     xputs(TE);
+    xflush();
+    frame_sgr_known = FALSE;
+    tty_shadow_reset(FALSE);
 }
 
 /* Cursor movements */
@@ -569,11 +601,52 @@ void
 cmov(x, y)
 register int x, y;
 {
+    /* an absolute motion supersedes one that nothing was drawn after */
+    if (frame_mv_end >= 0 && frame_mv_end == tty_framelen)
+        tty_framelen = frame_mv_start;
+    frame_mv_start = tty_framelen;
     xputs(tgoto(nh_CM, x, y));
+    frame_mv_end = tty_framelen;
     ttyDisplay->cury = y;
     ttyDisplay->curx = x;
 }
 
+/* hand the frame's contents over to stdio */
+STATIC_OVL void
+frame_write()
+{
+    if (tty_framelen > 0) {
+        (void) fwrite((genericptr_t) tty_frame, 1, (size_t) tty_framelen,
+                      stdout);
+        frame_bytes += (long) tty_framelen;
+        tty_framelen = 0;
+    }
+    frame_mv_start = frame_mv_end = -1;
+    frame_sgr_start = frame_sgr_end = -1;
+}
+
+/* end of frame: send everything drawn since the last one */
+void
+xflush()
+{
+    if (tty_framelen > 0) {
+        frame_write();
+        frame_count++;
+        frame_writes++;
+    }
+    (void) fflush(stdout);
+}
+
+/* report output totals: frames sent, bytes and write()s used for them */
+void
+tty_frame_stats(frames, bytes, writes)
+long *frames, *bytes, *writes;
+{
+    *frames = frame_count;
+    *bytes = frame_bytes + (long) tty_framelen;
+    *writes = frame_writes;
+}
+
 /* See note above. xputc() is a special function. */
 void
 xputc(c)
@@ -583,7 +656,13 @@ xputc(c)
     char c;
 #endif
 {
-    (void) putchar(c);
+    if (tty_framelen >= TTY_FRAMESZ) {
+        /* frame overflow; it goes out in pieces */
+        frame_write();
+        (void) fflush(stdout);
+        frame_writes++;
+    }
+    tty_frame[tty_framelen++] = (char) c;
 }
 
 void
@@ -591,7 +670,8 @@ xputs(s)
 const char *s;
 {
 #ifndef TERMLIB
-    (void) fputs(s, stdout);
+    while (*s)
+        xputc(*s++);
 #else
 #if defined(NHSTDC) || defined(ULTRIX_PROTO)
     tputs(s, 1, (int (*) ()) xputc);
@@ -618,6 +698,7 @@ cl_end()
         tty_curs(BASE_WINDOW, (int) ttyDisplay->curx + 1,
                  (int) ttyDisplay->cury);
     }
+    tty_shadow_row((int) ttyDisplay->curx, (int) ttyDisplay->cury, TRUE);
 }
 
 void
@@ -629,6 +710,7 @@ clear_screen()
     if (CL) {
         xputs(CL);
         home();
+        tty_shadow_reset(TRUE);
     }
 }
 
@@ -647,6 +729,7 @@ home()
 void
 standoutbeg()
 {
+    frame_sgr_known = FALSE;
     if (SO)
         xputs(SO);
 }
@@ -654,6 +737,7 @@ standoutbeg()
 void
 standoutend()
 {
+    frame_sgr_known = FALSE;
     if (SE)
         xputs(SE);
 }
@@ -707,8 +791,8 @@ tty_nhbell()
 {
     if (flags.silent)
         return;
-    (void) putchar('\007'); /* curx does not change */
-    (void) fflush(stdout);
+    xputc('\007'); /* curx does not change */
+    xflush();
 }
 
 #ifdef ASCIIGRAPH
@@ -750,7 +834,7 @@ tty_delay_output()
 #endif
 #ifdef TIMED_DELAY
     if (flags.nap) {
-        (void) fflush(stdout);
+        xflush();
         msleep(50); /* sleep for 50 milliseconds */
         return;
     }
@@ -759,7 +843,7 @@ tty_delay_output()
     /* simulate the delay with "cursor here" */
     for (i = 0; i < 3; i++) {
         cmov(ttyDisplay->curx, ttyDisplay->cury);
-        (void) fflush(stdout);
+        xflush();
     }
 #else /* MICRO */
     /* BUG: if the padding character is visible, as it is on the 5620
@@ -786,8 +870,9 @@ tty_delay_output()
             strlen(tgoto(nh_CM, ttyDisplay->curx, ttyDisplay->cury));
         register int i = 500 + tmspc10[ospeed] / 2;
 
+        /* not cmov(), which would take back the repeats */
         while (i > 0) {
-            cmov((int) ttyDisplay->curx, (int) ttyDisplay->cury);
+            xputs(tgoto(nh_CM, ttyDisplay->curx, ttyDisplay->cury));
             i -= cmlen * tmspc10[ospeed];
         }
     }
@@ -812,6 +897,13 @@ cl_eos() /* free after Robert Viduya */
         tty_curs(BASE_WINDOW, (int) ttyDisplay->curx + 1,
                  (int) ttyDisplay->cury);
     }
+    {
+        int y = (int) ttyDisplay->cury;
+
+        tty_shadow_row((int) ttyDisplay->curx, y, TRUE);
+        while (++y < (int) LI)
+            tty_shadow_row(0, y, TRUE);
+    }
 }
 
 #if defined(TEXTCOLOR) && defined(TERMLIB)
@@ -1204,12 +1296,54 @@ int n;
     return nulstr;
 }
 
+/* emit a sequence which turns off all attributes and color */
+STATIC_OVL void
+frame_sgr_reset(seq)
+const char *seq;
+{
+    frame_prevcolor = frame_sgr_known ? frame_color : -1;
+    frame_prevattrs = frame_attrs;
+    frame_sgr_start = tty_framelen;
+    xputs(seq);
+    frame_sgr_end = tty_framelen;
+    frame_color = NO_COLOR, frame_attrs = 0;
+    frame_sgr_known = TRUE;
+}
+
+/* emit a sequence which turns on a color or an attribute (as a bit) */
+STATIC_OVL void
+frame_sgr_set(seq, color, attrbit)
+const char *seq;
+int color, attrbit;
+{
+    if (frame_sgr_known) {
+        int newcolor = (color != NO_COLOR) ? color : frame_color,
+            newattrs = frame_attrs | attrbit;
+
+        /* only single color or single attribute states are compared;
+           some terminals' color sequences reset the other attributes */
+        if (!frame_attrs && !attrbit && newcolor == frame_color)
+            return; /* already in effect */
+        if (tty_framelen == frame_sgr_end && newcolor == frame_prevcolor
+            && newattrs == frame_prevattrs
+            && (newcolor == NO_COLOR || !newattrs)) {
+            /* this just undoes the reset; take both back out */
+            tty_framelen = frame_sgr_start;
+            frame_sgr_start = frame_sgr_end = -1;
+            frame_color = newcolor, frame_attrs = newattrs;
+            return;
+        }
+        frame_color = newcolor, frame_attrs = newattrs;
+    }
+    xputs(seq);
+}
+
 void
 term_start_attr(attr)
 int attr;
 {
     if (attr) {
-        xputs(s_atr2str(attr));
+        frame_sgr_set(s_atr2str(attr), NO_COLOR, 1 << attr);
     }
 }
 
@@ -1218,19 +1352,31 @@ term_end_attr(attr)
 int attr;
 {
     if (attr) {
-        xputs(e_atr2str(attr));
+        const char *seq = e_atr2str(attr);
+
+        if (!*seq) {
+            frame_sgr_known = FALSE; /* can't be turned off */
+        } else if (attr == ATR_ULINE && seq == nh_UE) {
+            /* ends underlining only */
+            frame_attrs &= ~(1 << attr);
+            xputs(seq);
+        } else {
+            frame_sgr_reset(seq);
+        }
     }
 }
 
 void
 term_start_raw_bold()
 {
+    frame_sgr_known = FALSE;
     xputs(nh_HI);
 }
 
 void
 term_end_raw_bold()
 {
+    frame_sgr_known = FALSE;
     xputs(nh_HE);
 }
 
@@ -1239,14 +1385,14 @@ term_end_raw_bold()
 void
 term_end_color()
 {
-    xputs(nh_HE);
+    frame_sgr_reset(nh_HE);
 }
 
 void
 term_start_color(color)
 int color;
 {
-    xputs(hilites[color]);
+    frame_sgr_set(hilites[color], color, 0);
 }
 
 /* not to be confused with has_colors() in unixtty.c */
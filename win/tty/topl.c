@@ -14,6 +14,9 @@
 #define C(c) (0x1f & (c))
 #endif
 
+STATIC_DCL int NDECL(prevmsg_count);
+STATIC_DCL const char *FDECL(prevmsg_text, (int));
+STATIC_DCL void FDECL(prevmsg_list, (int));
 STATIC_DCL void FDECL(redotoplin, (const char *));
 STATIC_DCL void FDECL(topl_putsym, (CHAR_P));
 STATIC_DCL void NDECL(remember_topl);
@@ -21,62 +24,76 @@ STATIC_DCL void FDECL(removetopl, (int));
 STATIC_DCL void FDECL(msghistory_snapshot, (BOOLEAN_P));
 STATIC_DCL void FDECL(free_msghistory_snapshot, (BOOLEAN_P));
 
+/* how many older messages ^P can show; at most the msghistory option */
+STATIC_OVL int
+prevmsg_count()
+{
+    int ct = msghist_count(MSGH_PREV);
+
+    return min(ct, wins[WIN_MESSAGE]->rows);
+}
+
+/* the n'th message before toplines[] (1 for the most recent one) */
+STATIC_OVL const char *
+prevmsg_text(n)
+int n;
+{
+    const char *msg = msghist_get(MSGH_PREV, n - 1);
+
+    return msg ? msg : "";
+}
+
+/* put the whole message history in a menu window, oldest first */
+STATIC_OVL void
+prevmsg_list(nhist)
+int nhist;
+{
+    winid prevmsg_win;
+    int i;
+
+    prevmsg_win = create_nhwindow(NHW_MENU);
+    putstr(prevmsg_win, 0, "Message History");
+    putstr(prevmsg_win, 0, "");
+    for (i = nhist; i > 0; i--)
+        putstr(prevmsg_win, 0, prevmsg_text(i));
+    putstr(prevmsg_win, 0, toplines);
+    display_nhwindow(prevmsg_win, TRUE);
+    destroy_nhwindow(prevmsg_win);
+}
+
+/*
+ * cw->maxcol tracks how far back repeated ^P has gone: 0 for the
+ * current message in toplines[], n for the n'th one before that.
+ */
 int
 tty_doprev_message()
 {
     register struct WinDesc *cw = wins[WIN_MESSAGE];
 
     winid prevmsg_win;
-    int i;
+    int i, nhist = prevmsg_count();
+
     if ((iflags.prevmsg_window != 's')
         && !ttyDisplay->inread) {           /* not single */
         if (iflags.prevmsg_window == 'f') { /* full */
-            prevmsg_win = create_nhwindow(NHW_MENU);
-            putstr(prevmsg_win, 0, "Message History");
-            putstr(prevmsg_win, 0, "");
-            cw->maxcol = cw->maxrow;
-            i = cw->maxcol;
-            do {
-                if (cw->data[i] && strcmp(cw->data[i], ""))
-                    putstr(prevmsg_win, 0, cw->data[i]);
-                i = (i + 1) % cw->rows;
-            } while (i != cw->maxcol);
-            putstr(prevmsg_win, 0, toplines);
-            display_nhwindow(prevmsg_win, TRUE);
-            destroy_nhwindow(prevmsg_win);
+            cw->maxcol = 0;
+            prevmsg_list(nhist);
         } else if (iflags.prevmsg_window == 'c') { /* combination */
             do {
                 morc = 0;
-                if (cw->maxcol == cw->maxrow) {
+                if (cw->maxcol == 0) {
                     ttyDisplay->dismiss_more = C('p'); /* ^P ok at --More-- */
                     redotoplin(toplines);
-                    cw->maxcol--;
-                    if (cw->maxcol < 0)
-                        cw->maxcol = cw->rows - 1;
-                    if (!cw->data[cw->maxcol])
-                        cw->maxcol = cw->maxrow;
-                } else if (cw->maxcol == (cw->maxrow - 1)) {
+                    if (++cw->maxcol > nhist)
+                        cw->maxcol = 0;
+                } else if (cw->maxcol == 1) {
                     ttyDisplay->dismiss_more = C('p'); /* ^P ok at --More-- */
-                    redotoplin(cw->data[cw->maxcol]);
-                    cw->maxcol--;
-                    if (cw->maxcol < 0)
-                        cw->maxcol = cw->rows - 1;
-                    if (!cw->data[cw->maxcol])
-                        cw->maxcol = cw->maxrow;
+                    redotoplin(prevmsg_text(1));
+                    if (++cw->maxcol > nhist)
+                        cw->maxcol = 0;
                 } else {
-                    prevmsg_win = create_nhwindow(NHW_MENU);
-                    putstr(prevmsg_win, 0, "Message History");
-                    putstr(prevmsg_win, 0, "");
-                    cw->maxcol = cw->maxrow;
-                    i = cw->maxcol;
-                    do {
-                        if (cw->data[i] && strcmp(cw->data[i], ""))
-                            putstr(prevmsg_win, 0, cw->data[i]);
-                        i = (i + 1) % cw->rows;
-                    } while (i != cw->maxcol);
-                    putstr(prevmsg_win, 0, toplines);
-                    display_nhwindow(prevmsg_win, TRUE);
-                    destroy_nhwindow(prevmsg_win);
+                    cw->maxcol = 0;
+                    prevmsg_list(nhist);
                 }
 
             } while (morc == C('p'));
@@ -87,36 +104,24 @@ tty_doprev_message()
             putstr(prevmsg_win, 0, "Message History");
             putstr(prevmsg_win, 0, "");
             putstr(prevmsg_win, 0, toplines);
-            cw->maxcol = cw->maxrow - 1;
-            if (cw->maxcol < 0)
-                cw->maxcol = cw->rows - 1;
-            do {
-                putstr(prevmsg_win, 0, cw->data[cw->maxcol]);
-                cw->maxcol--;
-                if (cw->maxcol < 0)
-                    cw->maxcol = cw->rows - 1;
-                if (!cw->data[cw->maxcol])
-                    cw->maxcol = cw->maxrow;
-            } while (cw->maxcol != cw->maxrow);
+            for (i = 1; i <= nhist; i++)
+                putstr(prevmsg_win, 0, prevmsg_text(i));
 
             display_nhwindow(prevmsg_win, TRUE);
             destroy_nhwindow(prevmsg_win);
-            cw->maxcol = cw->maxrow;
+            cw->maxcol = 0;
             ttyDisplay->dismiss_more = 0;
         }
     } else if (iflags.prevmsg_window == 's') { /* single */
         ttyDisplay->dismiss_more = C('p'); /* <ctrl/P> allowed at --More-- */
         do {
             morc = 0;
-            if (cw->maxcol == cw->maxrow)
+            if (cw->maxcol == 0)
                 redotoplin(toplines);
-            else if (cw->data[cw->maxcol])
-                redotoplin(cw->data[cw->maxcol]);
-            cw->maxcol--;
-            if (cw->maxcol < 0)
-                cw->maxcol = cw->rows - 1;
-            if (!cw->data[cw->maxcol])
-                cw->maxcol = cw->maxrow;
+            else if (cw->maxcol <= nhist)
+                redotoplin(prevmsg_text(cw->maxcol));
+            if (++cw->maxcol > nhist)
+                cw->maxcol = 0;
         } while (morc == C('p'));
         ttyDisplay->dismiss_more = 0;
     }
@@ -144,26 +149,18 @@ const char *str;
         more();
 }
 
+/* move toplines[] into the core's message history */
 STATIC_OVL void
 remember_topl()
 {
     register struct WinDesc *cw = wins[WIN_MESSAGE];
-    int idx = cw->maxrow;
-    unsigned len = strlen(toplines) + 1;
 
     if ((cw->flags & WIN_LOCKHISTORY) || !*toplines)
         return;
 
-    if (len > (unsigned) cw->datlen[idx]) {
-        if (cw->data[idx])
-            free(cw->data[idx]);
-        len += (8 - (len & 7)); /* pad up to next multiple of 8 */
-        cw->data[idx] = (char *) alloc(len);
-        cw->datlen[idx] = (short) len;
-    }
-    Strcpy(cw->data[idx], toplines);
+    msghist_add(toplines, MSGH_PREV);
     *toplines = '\0';
-    cw->maxcol = cw->maxrow = (idx + 1) % cw->rows;
+    cw->maxcol = 0;
 }
 
 void
@@ -294,14 +291,18 @@ char c;
         ttyDisplay->cury++;
         cw->cury = ttyDisplay->cury;
 #ifdef WIN32CON
-        (void) putchar(c);
+        xputc(c);
 #endif
         break;
     default:
         if (ttyDisplay->curx == CO - 1)
             topl_putsym('\n'); /* 1 <= curx < CO; avoid CO */
+        /* a long message may have wrapped onto the map */
+        if (ttyDisplay->cury > 0)
+            tty_shadow_row((int) ttyDisplay->curx, (int) ttyDisplay->cury,
+                           FALSE);
 #ifdef WIN32CON
-        (void) putchar(c);
+        xputc(c);
 #endif
         ttyDisplay->curx++;
     }
@@ -309,7 +310,7 @@ char c;
     if (cw->curx == 0)
         cl_end();
 #ifndef WIN32CON
-    (void) putchar(c);
+    xputc(c);
 #endif
 }
 
@@ -520,13 +521,12 @@ char def;
 static char **snapshot_mesgs = 0;
 
 /* collect currently available message history data into a sequential array;
-   optionally, purge that data from the active circular buffer set as we go */
+   optionally, purge the core's history once it has been copied */
 STATIC_OVL void
 msghistory_snapshot(purge)
 boolean purge; /* clear message history buffer as we copy it */
 {
-    char *mesg;
-    int i, inidx, outidx;
+    int i, nhist;
     struct WinDesc *cw;
 
     /* paranoia (too early or too late panic save attempt?) */
@@ -537,49 +537,34 @@ boolean purge; /* clear message history buffer as we copy it */
     /* flush toplines[], moving most recent message to history */
     remember_topl();
 
-    /* for a passive snapshot, we just copy pointers, so can't allow further
-       history updating to take place because that could clobber them */
+    /* the copies below are what gets handed out; don't let anything
+       be added to history until they've been released */
     if (!purge)
         cw->flags |= WIN_LOCKHISTORY;
 
-    snapshot_mesgs = (char **) alloc((cw->rows + 1) * sizeof(char *));
-    outidx = 0;
-    inidx = cw->maxrow;
-    for (i = 0; i < cw->rows; ++i) {
-        snapshot_mesgs[i] = (char *) 0;
-        mesg = cw->data[inidx];
-        if (mesg && *mesg) {
-            snapshot_mesgs[outidx++] = mesg;
-            if (purge) {
-                /* we're taking this pointer away; subsequest history
-                   updates will eventually allocate a new one to replace it */
-                cw->data[inidx] = (char *) 0;
-                cw->datlen[inidx] = 0;
-            }
-        }
-        inidx = (inidx + 1) % cw->rows;
-    }
-    snapshot_mesgs[cw->rows] = (char *) 0; /* sentinel */
+    nhist = prevmsg_count();
+    snapshot_mesgs = (char **) alloc((nhist + 1) * sizeof(char *));
+    for (i = 0; i < nhist; ++i)
+        snapshot_mesgs[i] = dupstr(prevmsg_text(nhist - i));
+    snapshot_mesgs[nhist] = (char *) 0; /* sentinel */
 
     /* for a destructive snapshot, history is now completely empty */
-    if (purge)
-        cw->maxcol = cw->maxrow = 0;
+    if (purge) {
+        msghist_clear();
+        cw->maxcol = 0;
+    }
 }
 
 /* release memory allocated to message history snapshot */
 STATIC_OVL void
 free_msghistory_snapshot(purged)
-boolean purged; /* True: took history's pointers, False: just cloned them */
+boolean purged; /* True: history was cleared, False: history was locked */
 {
     if (snapshot_mesgs) {
-        /* snapshot pointers are no longer in use */
-        if (purged) {
-            int i;
-
-            for (i = 0; snapshot_mesgs[i]; ++i)
-                free((genericptr_t) snapshot_mesgs[i]);
-        }
+        int i;
 
+        for (i = 0; snapshot_mesgs[i]; ++i)
+            free((genericptr_t) snapshot_mesgs[i]);
         free((genericptr_t) snapshot_mesgs), snapshot_mesgs = (char **) 0;
 
         /* history can resume being updated at will now... */
@@ -646,9 +631,6 @@ boolean restoring_msghist;
 {
     static boolean initd = FALSE;
     int idx;
-#ifdef DUMPLOG
-    extern unsigned saved_pline_index; /* pline.c */
-#endif
 
     if (restoring_msghist && !initd) {
         /* we're restoring history from the previous session, but new
@@ -658,10 +640,6 @@ boolean restoring_msghist;
            restored ones are being put into place */
         msghistory_snapshot(TRUE);
         initd = TRUE;
-#ifdef DUMPLOG
-        /* this suffices; there's no need to scrub saved_pline[] pointers */
-        saved_pline_index = 0;
-#endif
     }
 
     if (msg) {
@@ -46,6 +46,7 @@ extern short glyph2tile[];
 #endif
 
 extern char mapped_menu_cmds[]; /* from options.c */
+extern char erase_char, kill_char; /* from appropriate tty.c file */
 
 /* this is only needed until tty_status_* routines are written */
 extern NEARDATA winid WIN_STATUS;
@@ -66,9 +67,9 @@ struct window_procs tty_procs = {
      | WC2_SELECTSAVED
 #endif
 #if defined(STATUS_HILITES)
-     | WC2_HILITE_STATUS | WC2_HITPOINTBAR
+     | WC2_HILITE_STATUS | WC2_HITPOINTBAR | WC2_FLUSH_STATUS
 #endif
-     | WC2_DARKGRAY),
+     | WC2_DARKGRAY | WC2_MENU_ITEMS),
     tty_init_nhwindows, tty_player_selection, tty_askname, tty_get_nh_event,
     tty_exit_nhwindows, tty_suspend_nhwindows, tty_resume_nhwindows,
     tty_create_nhwindow, tty_clear_nhwindow, tty_display_nhwindow,
@@ -119,7 +120,8 @@ struct DisplayDesc *ttyDisplay; /* the tty display descriptor */
 extern void FDECL(cmov, (int, int));   /* from termcap.c */
 extern void FDECL(nocmov, (int, int)); /* from termcap.c */
 #if defined(UNIX) || defined(VMS)
-static char obuf[BUFSIZ]; /* BUFSIZ is defined in stdio.h */
+/* big enough for a whole frame (see termcap.c) */
+static char obuf[TTY_FRAMESZ];
 #endif
 
 static char winpanicstr[] = "Bad window id %d";
@@ -145,6 +147,59 @@ boolean GFlag = FALSE;
 boolean HE_resets_AS; /* see termcap.c */
 #endif
 
+#ifndef NO_TERMS
+/*
+ * Shadow of the map area of the screen, by screen position relative to
+ * the map window, so that displaying a glyph that is already showing
+ * sends nothing.  Anything else drawn across map rows (menus, long
+ * messages, raw output) makes the cells it may have touched unknown,
+ * and those are drawn unconditionally until the map repaints them.
+ *
+ * Clearing the map window doesn't erase the map rows of the terminal;
+ * their cells are marked pending instead.  When the map is next
+ * displayed, shadow_sync() blanks whichever pending cells weren't
+ * redrawn in the meantime, so a full redraw (^R, changing levels) only
+ * sends the cells that actually differ.
+ */
+struct shadow_cell {
+    int ch;           /* -1 if unknown */
+    int color;
+    int glyph;        /* for vt_tiledata; NO_GLYPH if blank or unknown */
+    boolean inverse;
+    boolean pending;  /* cleared since last drawn */
+};
+static struct shadow_cell map_shadow[ROWNO][COLNO];
+static boolean shadow_pending = FALSE, shadow_syncing = FALSE;
+
+#define shadow_blank(sc) ((sc)->ch == ' ' && !(sc)->inverse)
+#define shadow_set(sc, c, clr, g, inv) \
+    ((sc)->ch = (c), (sc)->color = (clr), (sc)->glyph = (g), \
+     (sc)->inverse = (inv), (sc)->pending = FALSE)
+#endif /* !NO_TERMS */
+
+/*
+ * Incremental menu search.  The first MENU_SEARCH in a menu indexes
+ * the text of its selectable lines by trigram.  After that each
+ * keystroke only checks the lines which share the query's rarest
+ * trigram, or, while the query is being extended, the lines which
+ * matched it so far.
+ */
+#define MSEARCH_HASH 4096 /* trigram buckets; a power of 2 */
+#define MSEARCH_TRIGRAM(s) \
+    ((((unsigned) (uchar) lowc((s)[0]) * 31U                        \
+       + (unsigned) (uchar) lowc((s)[1])) * 31U                     \
+      + (unsigned) (uchar) lowc((s)[2])) & (MSEARCH_HASH - 1))
+
+struct menu_search {
+    tty_menu_item **items; /* selectable lines, in menu order */
+    short *page, *line;    /* where each of them is shown */
+    int nitems;
+    int *start, *post;     /* lines with trigram bucket b are
+                              post[start[b]] to post[start[b + 1] - 1] */
+    int *cand, ncand;      /* lines matching query */
+    char query[BUFSZ];
+};
+
 #if defined(MICRO) || defined(WIN32CON)
 static const char to_continue[] = "to continue";
 #define getret() getreturn(to_continue)
@@ -153,6 +208,18 @@ STATIC_DCL void NDECL(getret);
 #endif
 STATIC_DCL void FDECL(erase_menu_or_text,
                       (winid, struct WinDesc *, BOOLEAN_P));
+STATIC_DCL void FDECL(fetch_menu_str, (winid, tty_menu_item *));
+STATIC_DCL void FDECL(msearch_init, (winid, struct WinDesc *,
+                                     struct menu_search *));
+STATIC_DCL void FDECL(msearch_free, (struct menu_search *));
+STATIC_DCL void FDECL(msearch_update, (struct menu_search *, BOOLEAN_P));
+STATIC_DCL int FDECL(msearch_page, (struct menu_search *, int));
+STATIC_DCL void FDECL(menu_footer, (winid, struct WinDesc *, int,
+                                    struct menu_search *));
+#ifndef NO_TERMS
+STATIC_DCL int NDECL(shadow_endrow);
+STATIC_DCL void NDECL(shadow_sync);
+#endif
 STATIC_DCL void FDECL(free_window_info, (struct WinDesc *, BOOLEAN_P));
 STATIC_DCL void FDECL(dmore, (struct WinDesc *, const char *));
 STATIC_DCL void FDECL(set_item_state, (winid, int, tty_menu_item *));
@@ -206,6 +273,8 @@ void
 print_vt_code(i, c, d)
 int i, c, d;
 {
+    char buf[40];
+
     if (iflags.vt_tiledata) {
         if (c >= 0) {
             if (i == AVTC_SELECT_WINDOW) {
@@ -214,12 +283,13 @@ int i, c, d;
                 vt_tile_current_window = c;
             }
             if (d >= 0)
-                printf("\033[1;%d;%d;%d%c", i, c, d, TILE_ANSI_COMMAND);
+                Sprintf(buf, "\033[1;%d;%d;%d%c", i, c, d, TILE_ANSI_COMMAND);
             else
-                printf("\033[1;%d;%d%c", i, c, TILE_ANSI_COMMAND);
+                Sprintf(buf, "\033[1;%d;%d%c", i, c, TILE_ANSI_COMMAND);
         } else {
-            printf("\033[1;%d%c", i, TILE_ANSI_COMMAND);
+            Sprintf(buf, "\033[1;%d%c", i, TILE_ANSI_COMMAND);
         }
+        xputs(buf);
     }
 }
 #else
@@ -307,6 +377,9 @@ int sig_unused UNUSED;
 #endif
                 i = ttyDisplay->toplin;
                 ttyDisplay->toplin = 0;
+#ifndef NO_TERMS
+                tty_shadow_reset(FALSE);
+#endif
                 docrt();
                 bot();
                 ttyDisplay->toplin = i;
@@ -320,7 +393,7 @@ int sig_unused UNUSED;
                             addtopl("Press Return to continue: ");
                             break;
                         }
-                (void) fflush(stdout);
+                xflush();
                 if (i < 2)
                     flush_screen(1);
             }
@@ -346,7 +419,7 @@ char **argv UNUSED;
  *    due to ordering of graphics settings
  */
 #if defined(UNIX) || defined(VMS)
-    setbuf(stdout, obuf);
+    (void) setvbuf(stdout, obuf, _IOFBF, sizeof obuf);
 #endif
     gettty();
 
@@ -1199,15 +1272,15 @@ tty_askname()
 #if defined(MICRO) || defined(WIN32CON)
 #if defined(WIN32CON) || defined(MSDOS)
                     backsp(); /* \b is visible on NT */
-                    (void) putchar(' ');
+                    xputc(' ');
                     backsp();
 #else
                     msmsg("\b \b");
 #endif
 #else
-                    (void) putchar('\b');
-                    (void) putchar(' ');
-                    (void) putchar('\b');
+                    xputc('\b');
+                    xputc(' ');
+                    xputc('\b');
 #endif
                 }
                 continue;
@@ -1225,12 +1298,12 @@ tty_askname()
 #if defined(MICRO)
 #if defined(MSDOS)
                 if (iflags.grmode) {
-                    (void) putchar(c);
+                    xputc(c);
                 } else
 #endif
                     msmsg("%c", c);
 #else
-                (void) putchar(c);
+                xputc(c);
 #endif
                 plname[ct++] = c;
 #ifdef WIN32CON
@@ -1277,7 +1350,7 @@ const char *str;
 {
     settty(str); /* calls end_screen, perhaps raw_print */
     if (!str)
-        tty_raw_print(""); /* calls fflush(stdout) */
+        tty_raw_print(""); /* calls xflush() */
 }
 
 void
@@ -1365,8 +1438,9 @@ int type;
             iflags.msg_history = 20;
         else if (iflags.msg_history > 60)
             iflags.msg_history = 60;
-        newwin->maxrow = newwin->rows = iflags.msg_history;
-        newwin->maxcol = newwin->cols = 0;
+        newwin->rows = iflags.msg_history;
+        /* no data[]; message history is kept by the core (pline.c) */
+        newwin->maxrow = newwin->maxcol = newwin->cols = 0;
         break;
     case NHW_STATUS:
         /* status window, 2 lines long, full width, bottom of screen */
@@ -1539,7 +1613,27 @@ winid window;
     case NHW_MAP:
         /* cheap -- clear the whole thing and tell nethack to redraw botl */
         context.botlx = 1;
+#ifndef NO_TERMS
+        /* ...except that the map rows are left for shadow_sync() to clear,
+           as far as the redraw doesn't cover them */
+        {
+            int x, y, endrow = shadow_endrow();
+
+            home();
+            cl_end();
+            for (y = 0; y < endrow - (int) cw->offy; y++)
+                for (x = 0; x < COLNO; x++)
+                    map_shadow[y][x].pending = TRUE;
+            shadow_pending = TRUE;
+            if (endrow < (int) LI) {
+                tty_curs(BASE_WINDOW, 1, endrow);
+                cl_eos();
+            }
+        }
+        break;
+#else
         /*FALLTHRU*/
+#endif
     case NHW_BASE:
         clear_screen();
         break;
@@ -1622,7 +1716,7 @@ tty_menu_item *item;
 
     tty_curs(window, 4, lineno);
     term_start_attr(item->attr);
-    (void) putchar(ch);
+    xputc(ch);
     ttyDisplay->curx++;
     term_end_attr(item->attr);
 }
@@ -1736,6 +1830,192 @@ int color, attr;
 #endif
 }
 
+/* index the selectable lines of a menu for MENU_SEARCH */
+STATIC_OVL void
+msearch_init(window, cw, ms)
+winid window;
+struct WinDesc *cw;
+struct menu_search *ms;
+{
+    tty_menu_item *curr;
+    int b, i, n, pg, ln, *last;
+    const char *p;
+
+    for (n = 0, curr = cw->mlist; curr; curr = curr->next)
+        if (curr->identifier.a_void)
+            n++;
+    ms->nitems = n;
+    ms->items = (tty_menu_item **) alloc((n + 1) * sizeof *ms->items);
+    ms->page = (short *) alloc((n + 1) * sizeof *ms->page);
+    ms->line = (short *) alloc((n + 1) * sizeof *ms->line);
+    ms->cand = (int *) alloc((n + 1) * sizeof *ms->cand);
+    ms->start = (int *) alloc((MSEARCH_HASH + 1) * sizeof *ms->start);
+    last = (int *) alloc(MSEARCH_HASH * sizeof *last);
+    ms->ncand = 0;
+    ms->query[0] = '\0';
+
+    for (i = pg = ln = 0, curr = cw->mlist; curr; curr = curr->next, ln++) {
+        while (pg + 1 < cw->npages && curr == cw->plist[pg + 1])
+            pg++, ln = 0;
+        if (!curr->identifier.a_void)
+            continue;
+        fetch_menu_str(window, curr);
+        ms->items[i] = curr;
+        ms->page[i] = (short) pg;
+        ms->line[i] = (short) ln;
+        i++;
+    }
+
+    /* count each line once per trigram bucket, then fill in the lists */
+    for (b = 0; b < MSEARCH_HASH; b++)
+        ms->start[b] = 0, last[b] = -1;
+    for (i = 0; i < n; i++)
+        for (p = ms->items[i]->str; p[0] && p[1] && p[2]; p++) {
+            b = MSEARCH_TRIGRAM(p);
+            if (last[b] != i)
+                ms->start[b]++, last[b] = i;
+        }
+    for (b = 0, n = 0; b < MSEARCH_HASH; b++) {
+        int cnt = ms->start[b];
+
+        ms->start[b] = n;
+        n += cnt;
+        last[b] = -1;
+    }
+    ms->start[MSEARCH_HASH] = n;
+    ms->post = (int *) alloc((n + 1) * sizeof *ms->post);
+    for (i = 0; i < ms->nitems; i++)
+        for (p = ms->items[i]->str; p[0] && p[1] && p[2]; p++) {
+            b = MSEARCH_TRIGRAM(p);
+            if (last[b] != i) {
+                /* start[b] runs ahead while filling; see below */
+                ms->post[ms->start[b]++] = i;
+                last[b] = i;
+            }
+        }
+    /* each start[b] now holds where bucket b + 1 begins; shift back */
+    for (b = MSEARCH_HASH; b > 0; b--)
+        ms->start[b] = ms->start[b - 1];
+    ms->start[0] = 0;
+    free((genericptr_t) last);
+}
+
+STATIC_OVL void
+msearch_free(ms)
+struct menu_search *ms;
+{
+    if (!ms->items)
+        return;
+    free((genericptr_t) ms->items);
+    free((genericptr_t) ms->page);
+    free((genericptr_t) ms->line);
+    free((genericptr_t) ms->cand);
+    free((genericptr_t) ms->start);
+    free((genericptr_t) ms->post);
+    ms->items = (tty_menu_item **) 0;
+}
+
+/* find the lines matching ms->query; if narrowing, the query has only
+   grown since the last call, so its matches are among the previous ones */
+STATIC_OVL void
+msearch_update(ms, narrowing)
+struct menu_search *ms;
+boolean narrowing;
+{
+    char pattern[BUFSZ + 2];
+    const char *p;
+    int i, k, b, best = -1;
+
+    if (!ms->query[0]) {
+        ms->ncand = 0;
+        return;
+    }
+    if (!narrowing) {
+        /* trigrams spanning a wildcard can't be looked up */
+        for (p = ms->query; p[0] && p[1] && p[2]; p++) {
+            if (index("*?", p[0]) || index("*?", p[1]) || index("*?", p[2]))
+                continue;
+            b = MSEARCH_TRIGRAM(p);
+            if (best < 0 || (ms->start[b + 1] - ms->start[b]
+                             < ms->start[best + 1] - ms->start[best]))
+                best = b;
+        }
+        if (best >= 0) {
+            ms->ncand = ms->start[best + 1] - ms->start[best];
+            for (k = 0; k < ms->ncand; k++)
+                ms->cand[k] = ms->post[ms->start[best] + k];
+        } else {
+            ms->ncand = ms->nitems;
+            for (k = 0; k < ms->ncand; k++)
+                ms->cand[k] = k;
+        }
+    }
+    Sprintf(pattern, "*%s*", ms->query);
+    for (i = k = 0; i < ms->ncand; i++)
+        if (pmatchi(pattern, ms->items[ms->cand[i]]->str))
+            ms->cand[k++] = ms->cand[i];
+    ms->ncand = k;
+}
+
+/* page to show for the current matches: stay on this one if it has any,
+   otherwise the next one which does */
+STATIC_OVL int
+msearch_page(ms, curr_page)
+struct menu_search *ms;
+int curr_page;
+{
+    int i;
+
+    if (!ms->ncand)
+        return curr_page;
+    for (i = 0; i < ms->ncand; i++)
+        if (ms->page[ms->cand[i]] >= curr_page)
+            return ms->page[ms->cand[i]];
+    return ms->page[ms->cand[0]];
+}
+
+/* redraw the bottom line of a menu page, with the search if one is
+   in progress; leaves the cursor at the end */
+STATIC_OVL void
+menu_footer(window, cw, row, ms)
+winid window;
+struct WinDesc *cw;
+int row;
+struct menu_search *ms;
+{
+    char buf[QBUFSZ];
+    const char *q;
+    int room;
+
+    tty_curs(window, 1, row);
+    cl_end();
+    tty_curs(BASE_WINDOW, (int) ttyDisplay->curx + 2, (int) ttyDisplay->cury);
+    if (flags.standout)
+        standoutbeg();
+    xputs(cw->morestr);
+    ttyDisplay->curx += strlen(cw->morestr);
+    if (flags.standout)
+        standoutend();
+    if (!ms)
+        return;
+
+    if (ms->query[0])
+        Sprintf(buf, " Search [%d]: ", ms->ncand);
+    else
+        Strcpy(buf, " Search: ");
+    xputs(buf);
+    ttyDisplay->curx += strlen(buf);
+    /* show the end of a query too long to fit */
+    room = (int) ttyDisplay->cols - (int) ttyDisplay->curx - 1;
+    q = ms->query;
+    if (room > 0 && (int) strlen(q) > room)
+        q = eos((char *) q) - room;
+    for (; *q && room > 0; q++, room--) {
+        xputc(*q);
+        ttyDisplay->curx++;
+    }
+}
+
 STATIC_OVL void
 process_menu_window(window, cw)
 winid window;
@@ -1743,11 +2023,15 @@ struct WinDesc *cw;
 {
     tty_menu_item *page_start, *page_end, *curr;
     long count;
-    int n, attr_n, curr_page, page_lines, resp_len;
-    boolean finished, counting, reset_count;
+    int n, attr_n, curr_page, page_lines, resp_len, search_page;
+    boolean finished, counting, reset_count, searching;
     char *cp, *rp, resp[QBUFSZ], gacc[QBUFSZ], *msave, *morestr, really_morc;
+    struct menu_search msearch;
 #define MENU_EXPLICIT_CHOICE 0x7f /* pseudo menu manipulation char */
 
+    msearch.items = (tty_menu_item **) 0; /* not indexed yet */
+    searching = FALSE;
+    search_page = 0;
     curr_page = page_lines = 0;
     page_start = page_end = 0;
     msave = cw->morestr; /* save the morestr */
@@ -1816,6 +2100,7 @@ struct WinDesc *cw;
                      page_lines++, curr = curr->next) {
                     int attr, color = NO_COLOR;
 
+                    fetch_menu_str(window, curr);
                     if (curr->selector)
                         *rp++ = curr->selector;
 
@@ -1823,7 +2108,7 @@ struct WinDesc *cw;
                     if (cw->offx)
                         cl_end();
 
-                    (void) putchar(' ');
+                    xputc(' ');
                     ++ttyDisplay->curx;
 
                     if (!iflags.use_menu_color
@@ -1865,11 +2150,11 @@ struct WinDesc *cw;
                             && curr->identifier.a_void != 0
                             && curr->selected) {
                             if (curr->count == -1L)
-                                (void) putchar('+'); /* all selected */
+                                xputc('+'); /* all selected */
                             else
-                                (void) putchar('#'); /* count selected */
+                                xputc('#'); /* count selected */
                         } else
-                            (void) putchar(*cp);
+                            xputc(*cp);
                     } /* for *cp */
                     if (n > attr_n && (color != NO_COLOR || attr != ATR_NONE))
                         toggle_menu_attr(FALSE, color, attr);
@@ -1906,15 +2191,77 @@ struct WinDesc *cw;
             else
                 Strcpy(cw->morestr, defmorestr);
 
-            tty_curs(window, 1, page_lines);
-            cl_end();
-            dmore(cw, resp);
-        } else {
+            if (searching) {
+                menu_footer(window, cw, page_lines, &msearch);
+            } else {
+                tty_curs(window, 1, page_lines);
+                cl_end();
+                dmore(cw, resp);
+            }
+        } else if (!searching) {
             /* just put the cursor back... */
             tty_curs(window, (int) strlen(cw->morestr) + 2, page_lines);
             xwaitforspace(resp);
         }
 
+        if (searching) {
+            /* edit the query; the page with the first match is shown */
+            int c = tty_nhgetch(), qlen = (int) strlen(msearch.query),
+                oldpage = curr_page;
+            boolean changed = TRUE, narrowing = FALSE;
+
+            reset_count = FALSE; /* the count waits for Enter */
+            if (c == '\033' || c == EOF) {
+                searching = FALSE;
+                reset_count = TRUE;
+                curr_page = search_page;
+            } else if (c == '\n' || c == '\r') {
+                searching = FALSE;
+                reset_count = TRUE;
+                for (n = 0; n < msearch.ncand; n++) {
+                    int i = msearch.cand[n];
+                    boolean in_view = (page_start
+                                       && msearch.page[i] == curr_page);
+
+                    toggle_menu_curr(window, msearch.items[i],
+                                     (int) msearch.line[i], in_view,
+                                     counting, count);
+                    if (cw->how == PICK_ONE) {
+                        finished = TRUE;
+                        break;
+                    }
+                }
+            } else if (c == erase_char || c == '\b') {
+                if (qlen > 0)
+                    msearch.query[qlen - 1] = '\0';
+                else
+                    changed = FALSE;
+            } else if (c == kill_char || c == '\177') {
+                msearch.query[0] = '\0';
+            } else if (' ' <= (unsigned char) c && c != '\177'
+                       && qlen < BUFSZ - 1) {
+                msearch.query[qlen] = (char) c;
+                msearch.query[qlen + 1] = '\0';
+                narrowing = (qlen > 0);
+            } else {
+                changed = FALSE;
+            }
+            if (!changed) {
+                tty_nhbell();
+            } else if (searching) {
+                msearch_update(&msearch, narrowing);
+                curr_page = msearch_page(&msearch, curr_page);
+            }
+            if (finished)
+                break;
+            if (curr_page != oldpage)
+                page_start = 0; /* only a page change needs a redraw */
+            else
+                menu_footer(window, cw, page_lines,
+                            searching ? &msearch : (struct menu_search *) 0);
+            continue;
+        }
+
         really_morc = morc; /* (only used with MENU_EXPLICIT_CHOICE */
         if ((rp = index(resp, morc)) != 0 && rp < resp + resp_len)
             /* explicit menu selection; don't override it if it also
@@ -2043,34 +2390,15 @@ struct WinDesc *cw;
             if (cw->how == PICK_NONE) {
                 tty_nhbell();
                 break;
-            } else {
-                char searchbuf[BUFSZ + 2], tmpbuf[BUFSZ];
-                boolean on_curr_page = FALSE;
-                int lineno = 0;
-
-                tty_getlin("Search for:", tmpbuf);
-                if (!tmpbuf[0] || tmpbuf[0] == '\033')
-                    break;
-                Sprintf(searchbuf, "*%s*", tmpbuf);
-
-                for (curr = cw->mlist; curr; curr = curr->next) {
-                    if (on_curr_page)
-                        lineno++;
-                    if (curr == page_start)
-                        on_curr_page = TRUE;
-                    else if (curr == page_end)
-                        on_curr_page = FALSE;
-                    if (curr->identifier.a_void
-                        && pmatchi(searchbuf, curr->str)) {
-                        toggle_menu_curr(window, curr, lineno, on_curr_page,
-                                         counting, count);
-                        if (cw->how == PICK_ONE) {
-                            finished = TRUE;
-                            break;
-                        }
-                    }
-                }
             }
+            if (!msearch.items)
+                msearch_init(window, cw, &msearch);
+            searching = TRUE;
+            reset_count = FALSE; /* keep any count for the matches */
+            search_page = curr_page;
+            msearch.query[0] = '\0';
+            msearch.ncand = 0;
+            menu_footer(window, cw, page_lines, &msearch);
             break;
         case MENU_EXPLICIT_CHOICE:
             morc = really_morc;
@@ -2102,6 +2430,7 @@ struct WinDesc *cw;
         }
 
     } /* while */
+    msearch_free(&msearch);
     cw->morestr = msave;
     free((genericptr_t) morestr);
 }
@@ -2140,7 +2469,7 @@ struct WinDesc *cw;
         if (cw->data[i]) {
             attr = cw->data[i][0] - 1;
             if (cw->offx) {
-                (void) putchar(' ');
+                xputc(' ');
                 ++ttyDisplay->curx;
             }
             term_start_attr(attr);
@@ -2152,7 +2481,7 @@ struct WinDesc *cw;
                  *cp && (int) ttyDisplay->curx < (int) ttyDisplay->cols;
                  cp++, ttyDisplay->curx++)
 #endif
-                (void) putchar(*cp);
+                xputc(*cp);
             term_end_attr(attr);
         }
     }
@@ -2187,6 +2516,9 @@ boolean blocking; /* with ttys, all windows are blocking */
         return;
     ttyDisplay->lastwin = window;
     ttyDisplay->rawprint = 0;
+#ifndef NO_TERMS
+    shadow_sync(); /* finish clearing the map before drawing anything */
+#endif
 
     print_vt_code2(AVTC_SELECT_WINDOW, window);
 
@@ -2212,7 +2544,7 @@ boolean blocking; /* with ttys, all windows are blocking */
         }
         /*FALLTHRU*/
     case NHW_BASE:
-        (void) fflush(stdout);
+        xflush();
         break;
     case NHW_TEXT:
         cw->maxcol = ttyDisplay->cols; /* force full-screen mode */
@@ -2327,6 +2659,8 @@ winid window;
         iflags.window_inited = 0;
     if (cw->type == NHW_MAP)
         clear_screen();
+    if (cw->type == NHW_MENU)
+        clear_menu_items(window);
 
     free_window_info(cw, TRUE);
     free((genericptr_t) cw);
@@ -2397,6 +2731,11 @@ register int x, y; /* not xchar: perhaps xchar is unsigned and
         y -= clipy;
     }
 #endif
+#ifndef NO_TERMS
+    /* some other window is about to write over map cells */
+    if (window != WIN_MAP && !shadow_syncing)
+        tty_shadow_row(x, y, FALSE);
+#endif
 
     if (y == cy && x == cx)
         return;
@@ -2419,7 +2758,7 @@ register int x, y; /* not xchar: perhaps xchar is unsigned and
         nocmov(x, y);
 #ifndef NO_TERMS
     } else if ((x <= 3 && cy <= 3) || (!nh_CM && x < cx)) {
-        (void) putchar('\r');
+        xputc('\r');
         ttyDisplay->curx = 0;
         nocmov(x, y);
     } else if (!nh_CM) {
@@ -2452,7 +2791,7 @@ char ch;
     case NHW_MAP:
     case NHW_BASE:
         tty_curs(window, x, y);
-        (void) putchar(ch);
+        xputc(ch);
         ttyDisplay->curx++;
         cw->curx++;
         break;
@@ -2572,7 +2911,7 @@ const char *str;
         tty_curs(window, cw->curx + 1, cw->cury);
         term_start_attr(attr);
         while (*str && (int) ttyDisplay->curx < (int) ttyDisplay->cols - 1) {
-            (void) putchar(*str);
+            xputc(*str);
             str++;
             ttyDisplay->curx++;
         }
@@ -2589,7 +2928,7 @@ const char *str;
                 cw->cury++;
                 tty_curs(window, cw->curx + 1, cw->cury);
             }
-            (void) putchar(*str);
+            xputc(*str);
             str++;
             ttyDisplay->curx++;
         }
@@ -2754,6 +3093,7 @@ tty_start_menu(window)
 winid window;
 {
     tty_clear_nhwindow(window);
+    clear_menu_items(window);
     return;
 }
 
@@ -2810,11 +3150,38 @@ boolean preselected;        /* item is marked as selected */
     item->gselector = gch;
     item->attr = attr;
     item->str = dupstr(newstr ? newstr : "");
+    item->fillidx = -1;
 
     item->next = cw->mlist;
     cw->mlist = item;
 }
 
+/*
+ * Fetch the text of a line supplied through add_menu_items(), which
+ * is left until its page is about to be shown.
+ */
+STATIC_OVL void
+fetch_menu_str(window, item)
+winid window;
+tty_menu_item *item;
+{
+    menu_fill mf;
+    char buf[4 + BUFSZ], text[BUFSZ];
+
+    if (item->str)
+        return;
+    mf.str = text;
+    get_menu_item(window, item->fillidx, &mf);
+    if (item->identifier.a_void)
+        Sprintf(buf, "%c - %s", item->selector ? item->selector : '?', text);
+    else
+        Strcpy(buf, text);
+    /* cut off any lines that are too long, as tty_end_menu() does */
+    if ((int) strlen(buf) + 2 > (int) ttyDisplay->cols)
+        buf[ttyDisplay->cols - 2] = '\0';
+    item->str = dupstr(buf);
+}
+
 /* Invert the given list, can handle NULL as an input. */
 STATIC_OVL tty_menu_item *
 reverse(curr)
@@ -2845,7 +3212,7 @@ const char *prompt; /* prompt to for menu */
     struct WinDesc *cw = 0;
     tty_menu_item *curr;
     short len;
-    int lmax, n;
+    int lmax, n, nfill;
     char menu_ch;
 
     if (window == WIN_ERR || (cw = wins[window]) == (struct WinDesc *) 0
@@ -2866,6 +3233,33 @@ const char *prompt; /* prompt to for menu */
                      MENU_UNSELECTED);
     }
 
+    /* Lines from add_menu_items() go after the rest.  Their text is
+       fetched when their page is shown, unless it all fits on one. */
+    if ((nfill = menu_items_count(window)) > 0) {
+        tty_menu_item **tail;
+        menu_fill mf;
+
+        for (tail = &cw->mlist; *tail; tail = &(*tail)->next)
+            continue;
+        mf.str = (char *) 0;
+        for (n = 0; n < nfill; n++) {
+            get_menu_item(window, n, &mf);
+            curr = (tty_menu_item *) alloc(sizeof(tty_menu_item));
+            curr->identifier = mf.identifier;
+            curr->count = -1L;
+            curr->selected = mf.preselected;
+            curr->selector = mf.accelerator;
+            curr->gselector = mf.groupacc;
+            curr->attr = mf.attr;
+            curr->str = (char *) 0;
+            curr->fillidx = n;
+            curr->next = (tty_menu_item *) 0;
+            *tail = curr;
+            tail = &curr->next;
+        }
+        cw->nitems += nfill;
+    }
+
     /* XXX another magic number? 52 */
     lmax = min(52, (int) ttyDisplay->rows - 1);    /* # lines per page */
     cw->npages = (cw->nitems + (lmax - 1)) / lmax; /* # of pages */
@@ -2888,10 +3282,20 @@ const char *prompt; /* prompt to for menu */
             cw->plist[n / lmax] = curr;
         }
         if (curr->identifier.a_void && !curr->selector) {
-            curr->str[0] = curr->selector = menu_ch;
+            curr->selector = menu_ch;
+            if (curr->str)
+                curr->str[0] = menu_ch;
             if (menu_ch++ == 'z')
                 menu_ch = 'A';
         }
+        if (!curr->str) {
+            if (cw->npages > 1) {
+                /* not fetched yet; assume it's as wide as can be */
+                cw->cols = ttyDisplay->cols;
+                continue;
+            }
+            fetch_menu_str(window, curr);
+        }
 
         /* cut off any lines that are too long */
         len = strlen(curr->str) + 2; /* extra space at beg & end */
@@ -3024,7 +3428,7 @@ tty_update_inventory()
 void
 tty_mark_synch()
 {
-    (void) fflush(stdout);
+    xflush();
 }
 
 void
@@ -3039,7 +3443,7 @@ tty_wait_synch()
         tty_display_nhwindow(WIN_MAP, FALSE);
         if (ttyDisplay->inmore) {
             addtopl("--More--");
-            (void) fflush(stdout);
+            xflush();
         } else if (ttyDisplay->inread > program_state.gameover) {
             /* this can only happen if we were reading and got interrupted */
             ttyDisplay->toplin = 3;
@@ -3047,10 +3451,105 @@ tty_wait_synch()
             (void) tty_doprev_message();
             (void) tty_doprev_message();
             ttyDisplay->intr++;
-            (void) fflush(stdout);
+            xflush();
+        }
+    }
+}
+
+#ifndef NO_TERMS
+/* screen row just past the part of the map window that's visible */
+STATIC_OVL int
+shadow_endrow()
+{
+    struct WinDesc *cw = wins[WIN_MAP];
+    int endrow = (int) cw->offy + ROWNO;
+
+    if (WIN_STATUS != WIN_ERR && wins[WIN_STATUS]
+        && (int) wins[WIN_STATUS]->offy < endrow)
+        endrow = (int) wins[WIN_STATUS]->offy;
+    if (endrow > (int) LI)
+        endrow = (int) LI;
+    return endrow;
+}
+
+/* screen row y, from column x on, now shows blanks or something unknown */
+void
+tty_shadow_row(x, y, blank)
+int x, y;
+boolean blank;
+{
+    struct shadow_cell *sc;
+
+    if (WIN_MAP == WIN_ERR || !wins[WIN_MAP])
+        return;
+    y -= (int) wins[WIN_MAP]->offy;
+    x -= (int) wins[WIN_MAP]->offx;
+    if (y < 0 || y >= ROWNO)
+        return;
+    for (sc = &map_shadow[y][max(x, 0)]; sc < &map_shadow[y][COLNO]; sc++)
+        if (blank)
+            shadow_set(sc, ' ', NO_COLOR, NO_GLYPH, FALSE);
+        else
+            shadow_set(sc, -1, NO_COLOR, NO_GLYPH, FALSE);
+}
+
+/* the whole screen was cleared, or may have been changed behind our back */
+void
+tty_shadow_reset(blank)
+boolean blank;
+{
+    int x, y;
+
+    for (y = 0; y < ROWNO; y++)
+        for (x = 0; x < COLNO; x++)
+            if (blank)
+                shadow_set(&map_shadow[y][x], ' ', NO_COLOR, NO_GLYPH, FALSE);
+            else
+                shadow_set(&map_shadow[y][x], -1, NO_COLOR, NO_GLYPH, FALSE);
+    shadow_pending = FALSE;
+}
+
+/* blank the map cells which were cleared and haven't been redrawn since */
+STATIC_OVL void
+shadow_sync()
+{
+    struct WinDesc *cw = wins[WIN_MAP];
+    struct shadow_cell *sc, *rest;
+    int x, y, cx, cy, endrow;
+
+    if (!shadow_pending)
+        return;
+    shadow_pending = FALSE;
+    shadow_syncing = TRUE;
+    end_glyphout();
+    cx = ttyDisplay->curx, cy = ttyDisplay->cury;
+    endrow = shadow_endrow() - (int) cw->offy;
+    for (y = 0; y < endrow; y++) {
+        for (x = 0; x < COLNO && x + (int) cw->offx < (int) CO; x++) {
+            sc = &map_shadow[y][x];
+            if (!sc->pending)
+                continue;
+            sc->pending = FALSE;
+            if (shadow_blank(sc))
+                continue;
+            tty_curs(BASE_WINDOW, x + (int) cw->offx + 1, y + (int) cw->offy);
+            /* if nothing further along needs keeping, erase the rest */
+            for (rest = sc + 1; rest < &map_shadow[y][COLNO]; rest++)
+                if (!rest->pending && !shadow_blank(rest))
+                    break;
+            if (rest == &map_shadow[y][COLNO]) {
+                cl_end(); /* marks them blank */
+                break;
+            }
+            xputc(' ');
+            ttyDisplay->curx++;
+            shadow_set(sc, ' ', NO_COLOR, NO_GLYPH, FALSE);
         }
     }
+    tty_curs(BASE_WINDOW, cx + 1, cy);
+    shadow_syncing = FALSE;
 }
+#endif /* !NO_TERMS */
 
 void
 docorner(xmin, ymax)
@@ -3131,23 +3630,23 @@ int in_ch;
 #if defined(ASCIIGRAPH) && !defined(NO_TERMS)
     if (SYMHANDLING(H_IBM) || iflags.eight_bit_tty) {
         /* IBM-compatible displays don't need other stuff */
-        (void) putchar(ch);
+        xputc(ch);
     } else if (ch & 0x80) {
         if (!GFlag || HE_resets_AS) {
             graph_on();
             GFlag = TRUE;
         }
-        (void) putchar((ch ^ 0x80)); /* Strip 8th bit */
+        xputc((ch ^ 0x80)); /* Strip 8th bit */
     } else {
         if (GFlag) {
             graph_off();
             GFlag = FALSE;
         }
-        (void) putchar(ch);
+        xputc(ch);
     }
 
 #else
-    (void) putchar(ch);
+    xputc(ch);
 
 #endif /* ASCIIGRAPH && !NO_TERMS */
 
@@ -3215,6 +3714,9 @@ int bkglyph UNUSED;
     boolean reverse_on = FALSE;
     int color;
     unsigned special;
+#ifndef NO_TERMS
+    struct shadow_cell *sc;
+#endif
 
 #ifdef CLIPPING
     if (clipping) {
@@ -3225,6 +3727,39 @@ int bkglyph UNUSED;
     /* map glyph to character and color */
     (void) mapglyph(glyph, &ch, &color, &special, x, y);
 
+    /* decide on inverse now so the shadow check below can compare it */
+    if (((special & MG_PET) && iflags.hilite_pet)
+        || ((special & MG_OBJPILE) && iflags.hilite_pile)
+        || ((special & MG_DETECT) && iflags.use_inverse)
+        || ((special & MG_BW_LAVA) && iflags.use_inverse))
+        reverse_on = TRUE;
+
+#ifndef NO_TERMS
+    {
+        int sx = x - 1, sy = y; /* column 0 is never used */
+
+#ifdef CLIPPING
+        if (clipping) {
+            sx -= clipx;
+            sy -= clipy;
+        }
+#endif
+        sc = (sx >= 0 && sx < COLNO && sy >= 0 && sy < ROWNO)
+                 ? &map_shadow[sy][sx] : (struct shadow_cell *) 0;
+        if (ch == ' ' && !reverse_on)
+            color = NO_COLOR; /* any blank looks like any other */
+        if (sc && sc->ch == ch && sc->color == color
+            && sc->inverse == reverse_on
+#ifdef TTY_TILES_ESCCODES
+            && (!iflags.vt_tiledata || sc->glyph == glyph)
+#endif
+            ) {
+            sc->pending = FALSE;
+            return; /* already showing */
+        }
+    }
+#endif
+
     print_vt_code2(AVTC_SELECT_WINDOW, window);
 
     /* Move the cursor. */
@@ -3234,7 +3769,7 @@ int bkglyph UNUSED;
 
 #ifndef NO_TERMS
     if (ul_hack && ch == '_') { /* non-destructive underscore */
-        (void) putchar((char) ' ');
+        xputc((char) ' ');
         backsp();
     }
 #endif
@@ -3249,14 +3784,9 @@ int bkglyph UNUSED;
     }
 #endif /* TEXTCOLOR */
 
-    /* must be after color check; term_end_color may turn off inverse too */
-    if (((special & MG_PET) && iflags.hilite_pet)
-        || ((special & MG_OBJPILE) && iflags.hilite_pile)
-        || ((special & MG_DETECT) && iflags.use_inverse)
-        || ((special & MG_BW_LAVA) && iflags.use_inverse)) {
+    /* must be after color check; term_end_attr may turn off color too */
+    if (reverse_on)
         term_start_attr(ATR_INVERSE);
-        reverse_on = TRUE;
-    }
 
 #if defined(USE_TILES) && defined(MSDOS)
     if (iflags.grmode && iflags.tile_view)
@@ -3280,6 +3810,11 @@ int bkglyph UNUSED;
 
     wins[window]->curx++; /* one character over */
     ttyDisplay->curx++;   /* the real cursor moved too */
+#ifndef NO_TERMS
+    if (sc)
+        shadow_set(sc, ch, color,
+                   (ch == ' ' && !reverse_on) ? NO_GLYPH : glyph, reverse_on);
+#endif
 }
 
 void
@@ -3289,11 +3824,16 @@ const char *str;
     if (ttyDisplay)
         ttyDisplay->rawprint++;
     print_vt_code2(AVTC_SELECT_WINDOW, NHW_BASE);
+#ifndef NO_TERMS
+    tty_shadow_reset(FALSE);
+#endif
 #if defined(MICRO) || defined(WIN32CON)
     msmsg("%s\n", str);
 #else
-    puts(str);
-    (void) fflush(stdout);
+    while (*str)
+        xputc(*str++);
+    xputc('\n');
+    xflush();
 #endif
 }
 
@@ -3304,18 +3844,22 @@ const char *str;
     if (ttyDisplay)
         ttyDisplay->rawprint++;
     print_vt_code2(AVTC_SELECT_WINDOW, NHW_BASE);
+#ifndef NO_TERMS
+    tty_shadow_reset(FALSE);
+#endif
     term_start_raw_bold();
 #if defined(MICRO) || defined(WIN32CON)
     msmsg("%s", str);
 #else
-    (void) fputs(str, stdout);
+    while (*str)
+        xputc(*str++);
 #endif
     term_end_raw_bold();
 #if defined(MICRO) || defined(WIN32CON)
     msmsg("\n");
 #else
-    puts("");
-    (void) fflush(stdout);
+    xputc('\n');
+    xflush();
 #endif
 }
 
@@ -3334,7 +3878,11 @@ tty_nhgetch()
 #endif
 
     print_vt_code1(AVTC_INLINE_SYNC);
-    (void) fflush(stdout);
+#ifndef NO_TERMS
+    if (ttyDisplay)
+        shadow_sync();
+#endif
+    xflush();
     /* Note: if raw_print() and wait_synch() get called to report terminal
      * initialization problems, then wins[] and ttyDisplay might not be
      * available yet.  Such problems will probably be fatal before we get
@@ -3347,6 +3895,7 @@ tty_nhgetch()
                          : (read(fileno(stdin), (genericptr_t) &nestbuf, 1)
                             == 1) ? (int) nestbuf : EOF;
     --nesting;
+    iflags.typeahead = unix_typeahead();
 #else
     i = tgetch();
 #endif
@@ -3379,7 +3928,7 @@ int *x, *y, *mod;
 {
 #if defined(WIN32CON)
     int i;
-    (void) fflush(stdout);
+    xflush();
     /* Note: if raw_print() and wait_synch() get called to report terminal
      * initialization problems, then wins[] and ttyDisplay might not be
      * available yet.  Such problems will probably be fatal before we get
@@ -3543,20 +4092,16 @@ static int cond_shrinklvl = 0, cond_width_at_shrink = 0;
 static int enclev = 0, enc_shrinklvl = 0;
 /* static int dl_shrinklvl = 0; */
 static boolean truncation_expected = FALSE;
+/* field updates received since the last BL_FLUSH */
+static boolean status_pending = FALSE;
+/* rightmost column drawn on each status line by render_status() */
+static int status_rowend[2] = { 0, 0 };
 
 /* This controls whether to skip fields that aren't
  * flagged as requiring updating during the current
  * render_status().
- *
- * Hopefully that can be confirmed as working correctly
- * for all platforms eventually and the conditional
- * setting below can be removed.
  */
-#if defined(UNIX)
-static int do_field_opt = 0;
-#else
 static int do_field_opt = 1;
-#endif
 #endif  /* STATUS_HILITES */
 
 /*
@@ -3583,6 +4128,8 @@ tty_status_init()
     }
     tty_condition_bits = 0L;
     hpbar_percent = 0, hpbar_color = NO_COLOR;
+    status_pending = FALSE;
+    status_rowend[0] = status_rowend[1] = 0;
 #endif /* STATUS_HILITES */
 
     /* let genl_status_init do most of the initialization */
@@ -3603,8 +4150,11 @@ tty_status_init()
  *         BL_LEVELDESC, BL_EXP, BL_CONDITION
  *      -- fldindex could also be BL_FLUSH (-1), which is not really
  *         a field index, but is a special trigger to tell the
- *         windowport that it should redisplay all its status fields,
- *         even if no changes have been presented to it.
+ *         windowport that the batch of field updates is complete.
+ *         Since tty asks for it with WC2_FLUSH_STATUS, the fields are
+ *         only recorded as they arrive and are all placed and drawn
+ *         here, once.  When context.botlx is set the whole status
+ *         area is redisplayed, even if no changes have been presented.
  *      -- ptr is usually a "char *", unless fldindex is BL_CONDITION.
  *         If fldindex is BL_CONDITION, then ptr is a long value with
  *         any or none of the following bits set (from botl.h):
@@ -3657,17 +4207,23 @@ unsigned long *colormasks;
     char *fval = (char *) 0;
     boolean force_update = FALSE;
 
-    if (fldidx != BL_FLUSH && !status_activefields[fldidx])
+    if (fldidx == BL_FLUSH) {
+        force_update = context.botlx ? TRUE : FALSE;
+        if ((status_pending || force_update)
+            && (make_things_fit(force_update) || truncation_expected))
+            render_status();
+        status_pending = FALSE;
+        return;
+    }
+    if (!status_activefields[fldidx])
         return;
 
 #ifndef TEXTCOLOR
     color = (color & ~0x00FF) | NO_COLOR;
 #endif
 
+    status_pending = TRUE;
     switch (fldidx) {
-    case BL_FLUSH:
-        force_update = TRUE;
-        break;
     case BL_CONDITION:
         tty_status[NOW][fldidx].idx = fldidx;
         tty_condition_bits = *condptr;
@@ -3701,6 +4257,9 @@ unsigned long *colormasks;
     case BL_HP:
         if (iflags.wc2_hitpointbar) {
             /* Special additional processing for hitpointbar */
+            if (percent != hpbar_percent
+                || (color & 0x00FF) != hpbar_color)
+                tty_status[NOW][BL_TITLE].dirty = TRUE; /* bar moved */
             hpbar_percent = percent;
             hpbar_color = (color & 0x00FF);
         }
@@ -3737,8 +4296,6 @@ unsigned long *colormasks;
         }
         break;
     }
-    if (make_things_fit(force_update) || truncation_expected)
-        render_status();
     return;
 }
 
@@ -3747,7 +4304,7 @@ make_things_fit(force_update)
 boolean force_update;
 {
     int trycnt, fitting = 0, condsz = 0, requirement = 0;
-    int rowsz[2], otheroptions = 0;
+    int rowsz[2] = { 0, 0 }, otheroptions = 0;
     boolean check = FALSE;
 
     condsz = condition_size();
@@ -3764,6 +4321,7 @@ boolean force_update;
         if (trycnt < 2) {
             if (cond_shrinklvl < trycnt + 1) {
                 cond_shrinklvl = trycnt + 1;
+                tty_status[NOW][BL_CONDITION].dirty = TRUE;
                 condsz = condition_size();
                 cond_width_at_shrink = cond_disp_width[NOW];
             }
@@ -3811,6 +4369,7 @@ int *topsz, *bottomsz;
         col = 1;
         trackx = 1;
         update_right = FALSE;
+        idx = BL_FLUSH; /* no field seen yet */
         for (i = 0; fieldorder[row][i] != BL_FLUSH; ++i) {
             idx = fieldorder[row][i];
             if (!status_activefields[idx])
@@ -3831,7 +4390,10 @@ int *topsz, *bottomsz;
                  *  - Is the additional processing time for this worth it?
                  */
                 matchprev = FALSE;
-                if (do_field_opt && tty_status[NOW][idx].dirty) {
+                if (!tty_status[NOW][idx].dirty) {
+                    /* nothing new since it was last drawn */
+                    matchprev = TRUE;
+                } else if (do_field_opt) {
                     /* compare values */
                     const char *ob, *nb;     /* old byte, new byte */
 
@@ -3864,10 +4426,12 @@ int *topsz, *bottomsz;
                 tty_status[NOW][idx].redraw = TRUE;
             col += tty_status[NOW][idx].lth;
         }
+        if (idx != BL_FLUSH)
+            col += tty_status[NOW][idx].lth;
         if (row && bottomsz)
-            *bottomsz = col + tty_status[NOW][idx].lth;
+            *bottomsz = col;
         else if (topsz)
-            *topsz = col + tty_status[NOW][idx].lth;
+            *topsz = col;
     }
     return valid;
 }
@@ -3908,7 +4472,7 @@ int x, y;
         for (i = 0; i < lth; ++i) {
             n = i + x;
             if (n < ncols && *text) {
-                (void) putchar(*text);
+                xputc(*text);
                 ttyDisplay->curx++;
                 cw->curx++;
               cw->data[y][n-1] = *text;
@@ -3951,6 +4515,7 @@ int lvl;
         Strcpy(status_vals[BL_CAP], encvals[lvl][enclev]);
     }
     tty_status[NOW][BL_CAP].lth = strlen(status_vals[BL_CAP]);
+    tty_status[NOW][BL_CAP].dirty = TRUE;
 }
 
 STATIC_OVL void
@@ -3966,6 +4531,7 @@ int lvl;
         Strcat(buf, levval);
         Strcpy(status_vals[BL_LEVELDESC], buf);
         tty_status[NOW][BL_LEVELDESC].lth = strlen(status_vals[BL_LEVELDESC]);
+        tty_status[NOW][BL_LEVELDESC].dirty = TRUE;
     }
 }
 
@@ -4101,18 +4667,27 @@ render_status(VOID_ARGS)
     }
 
     for (row = 0; row < 2; ++row) {
+        int rowend = 1;
+
         curs(WIN_STATUS, 1, row);
         for (i = 0; fieldorder[row][i] != BL_FLUSH; ++i) {
             int fldidx = fieldorder[row][i];
 
+            if (status_activefields[fldidx] && tty_status[NOW][fldidx].lth)
+                rowend = tty_status[NOW][fldidx].x
+                         + tty_status[NOW][fldidx].lth;
             if (do_field_opt && !tty_status[NOW][fldidx].redraw)
                 continue;
             /*
              * Ignore zero length fields. check_fields() didn't count
              * them in either.
              */
-            if (!tty_status[NOW][fldidx].lth && fldidx != BL_CONDITION)
+            if (!tty_status[NOW][fldidx].lth && fldidx != BL_CONDITION) {
+                tty_status[NOW][fldidx].dirty  = FALSE;
+                tty_status[NOW][fldidx].redraw = FALSE;
+                tty_status[BEFORE][fldidx] = tty_status[NOW][fldidx];
                 continue;
+            }
 
             if (status_activefields[fldidx]) {
                 int coloridx = tty_status[NOW][fldidx].color;
@@ -4271,9 +4846,17 @@ render_status(VOID_ARGS)
                 tty_status[BEFORE][fldidx] = tty_status[NOW][fldidx];
             }
         }
+        /* unchanged fields weren't redrawn, so a line that got shorter
+           needs its old tail erased explicitly */
+        if (rowend < status_rowend[row] && rowend < cw->cols) {
+            tty_curs(WIN_STATUS, rowend, row);
+            cl_end();
+        }
+        status_rowend[row] = rowend;
     }
     if (cond_disp_width[NOW] < cond_width_at_shrink) {
         cond_shrinklvl = 0;      /* reset */
+        tty_status[NOW][BL_CONDITION].dirty = TRUE;
         cond_width_at_shrink = condition_size();
         shrink_enc(0);
         shrink_dlvl(0);